@@ -9,35 +9,46 @@ namespace
 } // namespace
 
 FCBBitGridLayer::FCBBitGridLayer()
-	: Size{ 0, 0 }
+	: ClearTilesNum{ 0 }
+	, SetTilesNum{ 0 }
+	, Size{ 0, 0 }
 {
 }
 
 FCBBitGridLayer::FCBBitGridLayer(FUintPoint const InSize, bool const bValue)
+	: ClearTilesNum(0)
+	, SetTilesNum(0)
 {
 	SetSize(InSize, bValue);
 }
 
 FCBBitGridLayer::FCBBitGridLayer(FUintPoint const InSize, ENoInit)
+	: ClearTilesNum(0)
+	, SetTilesNum(0)
 {
 	SetSize(InSize);
 }
 
-FBitReference FCBBitGridLayer::operator [](FUintPoint const Coord)
+FConstBitReference const FCBBitGridLayer::operator [](FUintPoint const Coord) const
 {
 	CheckRange(Coord);
 	return GetTileByCellCoord(Coord)[GetCoordInTile(Coord)];
 }
 
-FConstBitReference const FCBBitGridLayer::operator [](FUintPoint const Coord) const
+FCBBitGridLayer::WordType FCBBitGridLayer::GetWord(FUintPoint const Coord) const
 {
 	CheckRange(Coord);
-	return GetTileByCellCoord(Coord)[GetCoordInTile(Coord)];
+	return GetTileByCellCoord(Coord)[Coord.X % FBitGridTile::GetXSize()];
 }
 
 void FCBBitGridLayer::Serialize(FArchive & Archive)
 {
 	Archive << Size << GridLayerData;
+	if (Archive.IsLoading())
+	{
+		ResetTileSummaries(ETileSummary::Mixed);
+		UpdateTileSummaries(FUintRect{ FUintPoint{ 0, 0 }, GetTileNum() });
+	}
 }
 
 bool FCBBitGridLayer::Contains(FUintRect const & Rect, bool const bValue) const
@@ -48,6 +59,14 @@ bool FCBBitGridLayer::Contains(FUintRect const & Rect, bool const bValue) const
 		return false;
 	}
 	CheckRange(Rect);
+	if (IsFilled(!bValue))
+	{
+		return false;
+	}
+	if (IsFilled(bValue))
+	{
+		return true;
+	}
 
 	FUintRect const TilesToCheck{ Rect.Min / FBitGridTile::GetSize(), (Rect.Max - FUintPoint{ 1, 1 }) / FBitGridTile::GetSize() };
 	uint32 const StartWordIndex = Rect.Min.X % FBitGridTile::GetXSize();
@@ -120,18 +139,20 @@ bool FCBBitGridLayer::Contains(FUintRect const & Rect, bool const bValue) const
 				uint32 const InnerXTilesNum = TilesToCheck.Width() - 1;
 				uint32 const FirstColumnTileIndex = GetTileIndex(FUintPoint{ TilesToCheck.Min.X, TilesToCheck.Min.Y + 1 });
 				uint32 const LastColumnTileIndex = GetTileIndex(FUintPoint{ TilesToCheck.Min.X, TilesToCheck.Max.Y });
-				BYTE const Test = bValue ? 0u : ~0u;
 				for (uint32 ColumnTileIndex = FirstColumnTileIndex; ColumnTileIndex < LastColumnTileIndex; ColumnTileIndex += GetXTileNum())
 				{
 					if (GridLayerData[ColumnTileIndex].Contains(bValue, StartWordIndex, FBitGridTile::GetXSize(), FullWordMask))
 					{
 						return true;
 					}
-					void const * const Start = static_cast<void const *>(GridLayerData.GetData() + ColumnTileIndex + 1);
-					void const * const End = static_cast<void const *>(GridLayerData.GetData() + ColumnTileIndex + 1 + InnerXTilesNum);
-					for (BYTE const * Byte = static_cast<BYTE const *>(Start); Byte < End; ++Byte)
+					// Fully covered tiles are decided by their summaries, only mixed tiles are scanned.
+					for (uint32 TileIndex = ColumnTileIndex + 1; TileIndex <= ColumnTileIndex + InnerXTilesNum; ++TileIndex)
 					{
-						if (*Byte != Test)
+						if (TileSummaries[TileIndex] == GetFilledTileSummary(bValue))
+						{
+							return true;
+						}
+						if (TileSummaries[TileIndex] == ETileSummary::Mixed && GridLayerData[TileIndex].Contains(bValue))
 						{
 							return true;
 						}
@@ -153,6 +174,17 @@ bool FCBBitGridLayer::Contains(FUintRect const & Rect, bool const bValue) const
 	}
 }
 
+void FCBBitGridLayer::SetCell(FUintPoint const Coord, bool const bValue)
+{
+	CheckRange(Coord);
+	uint32 const TileIndex = GetTileIndex(Coord / FBitGridTile::GetSize());
+	GridLayerData[TileIndex][GetCoordInTile(Coord)] = bValue;
+	if (TileSummaries[TileIndex] != GetFilledTileSummary(bValue))
+	{
+		UpdateTileSummary(TileIndex);
+	}
+}
+
 void FCBBitGridLayer::SetCells(FUintRect const & Rect, bool const bValue)
 {
 	if (IsEmptyRect(Rect))
@@ -234,6 +266,23 @@ void FCBBitGridLayer::SetCells(FUintRect const & Rect, bool const bValue)
 			}
 		}
 	}
+	UpdateTileSummaries(FUintRect{ TilesToSet.Min, TilesToSet.Max + FUintPoint{ 1, 1 } });
+}
+
+bool FCBBitGridLayer::IsFilled(bool const bValue) const
+{
+	return (bValue ? SetTilesNum : ClearTilesNum) == static_cast<uint32>(GridLayerData.Num());
+}
+
+bool FCBBitGridLayer::IsTileFilled(FUintPoint const Coord, bool const bValue) const
+{
+	CheckRange(Coord);
+	return TileSummaries[GetTileIndex(Coord / FBitGridTile::GetSize())] == GetFilledTileSummary(bValue);
+}
+
+FUintPoint FCBBitGridLayer::GetTileSize()
+{
+	return FBitGridTile::GetSize();
 }
 
 FUintPoint FCBBitGridLayer::GetSize() const
@@ -276,6 +325,7 @@ void FCBBitGridLayer::SetSize(FUintPoint const NewSize, bool const bValue)
 	int32 const NewTilesNum = GetXTileNum() * GetYTileNum();
 	GridLayerData.Empty(NewTilesNum);
 	GridLayerData.Init(FBitGridTile{ bValue }, NewTilesNum);
+	ResetTileSummaries(GetFilledTileSummary(bValue));
 }
 
 void FCBBitGridLayer::SetSize(FUintPoint const NewSize)
@@ -284,6 +334,7 @@ void FCBBitGridLayer::SetSize(FUintPoint const NewSize)
 	int32 const NewTilesNum = GetXTileNum() * GetYTileNum();
 	GridLayerData.Empty(NewTilesNum);
 	GridLayerData.SetNumUninitialized(NewTilesNum);
+	ResetTileSummaries(ETileSummary::Mixed);
 }
 
 FUintPoint FCBBitGridLayer::GetCoordInTile(FUintPoint const Coord) const
@@ -334,6 +385,52 @@ uint32 FCBBitGridLayer::GetYTileNum() const
 	return GetYSize() / FBitGridTile::GetYSize();
 }
 
+FCBBitGridLayer::ETileSummary FCBBitGridLayer::GetFilledTileSummary(bool const bValue)
+{
+	return bValue ? ETileSummary::Set : ETileSummary::Clear;
+}
+
+void FCBBitGridLayer::SetTileSummary(uint32 const TileIndex, ETileSummary const Summary)
+{
+	ETileSummary & TileSummary = TileSummaries[TileIndex];
+	ClearTilesNum -= TileSummary == ETileSummary::Clear ? 1 : 0;
+	SetTilesNum -= TileSummary == ETileSummary::Set ? 1 : 0;
+	TileSummary = Summary;
+	ClearTilesNum += Summary == ETileSummary::Clear ? 1 : 0;
+	SetTilesNum += Summary == ETileSummary::Set ? 1 : 0;
+}
+
+void FCBBitGridLayer::UpdateTileSummary(uint32 const TileIndex)
+{
+	FBitGridTile const & Tile = GridLayerData[TileIndex];
+	if (!Tile.Contains(true))
+	{
+		SetTileSummary(TileIndex, ETileSummary::Clear);
+	}
+	else
+	{
+		SetTileSummary(TileIndex, Tile.Contains(false) ? ETileSummary::Mixed : ETileSummary::Set);
+	}
+}
+
+void FCBBitGridLayer::UpdateTileSummaries(FUintRect const & TileRect)
+{
+	for (uint32 TileY = TileRect.Min.Y; TileY < TileRect.Max.Y; ++TileY)
+	{
+		for (uint32 TileX = TileRect.Min.X; TileX < TileRect.Max.X; ++TileX)
+		{
+			UpdateTileSummary(GetTileIndex(FUintPoint{ TileX, TileY }));
+		}
+	}
+}
+
+void FCBBitGridLayer::ResetTileSummaries(ETileSummary const Summary)
+{
+	TileSummaries.Init(Summary, GridLayerData.Num());
+	ClearTilesNum = Summary == ETileSummary::Clear ? static_cast<uint32>(TileSummaries.Num()) : 0;
+	SetTilesNum = Summary == ETileSummary::Set ? static_cast<uint32>(TileSummaries.Num()) : 0;
+}
+
 FCBBitGridLayer::FBitGridTile::FBitGridTile() = default;
 
 FCBBitGridLayer::FBitGridTile::FBitGridTile(bool const bValue)
@@ -1,15 +1,22 @@
 #include "CBNavGrid.h"
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
 #include "CBGridUtilities.h"
 #include "CBHeightfield.h"
+#include "CBNavGridAbstractGraph.h"
 #include "CBNavGridAStar.h"
 #include "CBNavGridCustomVersion.h"
+#include "CBNavGridErosion.h"
+#include "CBNavGridFlowField.h"
+#include "CBNavGridFloodFill.h"
 #include "CBNavGridGenerator.h"
+#include "CBNavGridIslands.h"
 #include "CBNavGridLayer.h"
 #include "CBNavGridPath.h"
 #include "CBNavGridQueryFilter.h"
 #include "CBNavGridRenderingComponent.h"
-#include "GeomUtils.h"
-#include "GraphAStar.h"
+#include "Logging/StructuredLog.h"
+#include "Misc/ScopeRWLock.h"
 #include "NavAreas/NavArea_Default.h"
 #include "NavAreas/NavArea_Null.h"
 #include "NavigationSystem.h"
@@ -22,16 +29,6 @@
 
 namespace
 {
-	bool IsValidRect(FIntRect const & Rect)
-	{
-		return Rect.Min.X <= Rect.Max.X && Rect.Min.Y <= Rect.Max.Y;
-	}
-
-	void InvalidateRect(FIntRect & Rect)
-	{
-		Rect.Max = Rect.Min - FIntPoint{ 1, 0 };
-	}
-
 	FBox GetBoundingBox(FIntRect const & BoundingGridRect, FVector::FReal const CellSize, FVector::FReal const MinZ, FVector::FReal const MaxZ)
 	{
 		FVector const Min{ BoundingGridRect.Min.X * CellSize, BoundingGridRect.Min.Y * CellSize, MinZ };
@@ -41,17 +38,49 @@ namespace
 
 	bool HaveCommonBorder(FIntRect const & Rect1, FIntRect const & Rect2)
 	{
-		return Rect1.Min.X == Rect2.Min.X || Rect1.Min.Y == Rect1.Min.Y
-			|| Rect1.Max.X == Rect1.Max.X || Rect1.Max.Y == Rect1.Max.Y;
+		return Rect1.Min.X == Rect2.Min.X || Rect1.Min.Y == Rect2.Min.Y
+			|| Rect1.Max.X == Rect2.Max.X || Rect1.Max.Y == Rect2.Max.Y;
 	}
 
-	bool IntersectSegmentPoly2D(FVector2d const & Start2d, FVector2d const & End2d, TConstArrayView<FVector> ConvexPolygon)
+	/** Returns false if convex polygon doesn't overlap [MinX, MaxX], otherwise outputs Y range of its part within [MinX, MaxX]. */
+	bool GetPolygonYRange(TConstArrayView<FVector> const ConvexPolygon, FVector::FReal const MinX, FVector::FReal const MaxX, FVector::FReal & OutMinY, FVector::FReal & OutMaxY)
 	{
-		FVector::FReal TMin, TMax;
-		int32 SegMin, SegMax;
-		FVector Start{ Start2d, 0. };
-		FVector End{ End2d, 0. };
-		return UE::AI::IntersectSegmentPoly2D(Start, End, ConvexPolygon, TMin, TMax, SegMin, SegMax);
+		OutMinY = TNumericLimits<FVector::FReal>::Max();
+		OutMaxY = TNumericLimits<FVector::FReal>::Lowest();
+		for (int32 VertexIndex = 0; VertexIndex < ConvexPolygon.Num(); ++VertexIndex)
+		{
+			FVector const & EdgeStart = ConvexPolygon[VertexIndex];
+			FVector const & EdgeEnd = ConvexPolygon[(VertexIndex + 1) % ConvexPolygon.Num()];
+			FVector::FReal const DeltaX = EdgeEnd.X - EdgeStart.X;
+			FVector::FReal MinT = 0.;
+			FVector::FReal MaxT = 1.;
+			if (DeltaX == 0.)
+			{
+				if (EdgeStart.X < MinX || EdgeStart.X > MaxX)
+				{
+					continue;
+				}
+			}
+			else
+			{
+				FVector::FReal T1 = (MinX - EdgeStart.X) / DeltaX;
+				FVector::FReal T2 = (MaxX - EdgeStart.X) / DeltaX;
+				if (T1 > T2)
+				{
+					Swap(T1, T2);
+				}
+				MinT = FMath::Max(MinT, T1);
+				MaxT = FMath::Min(MaxT, T2);
+				if (MinT > MaxT)
+				{
+					continue;
+				}
+			}
+			FVector::FReal const DeltaY = EdgeEnd.Y - EdgeStart.Y;
+			OutMinY = FMath::Min3(OutMinY, EdgeStart.Y + DeltaY * MinT, EdgeStart.Y + DeltaY * MaxT);
+			OutMaxY = FMath::Max3(OutMaxY, EdgeStart.Y + DeltaY * MinT, EdgeStart.Y + DeltaY * MaxT);
+		}
+		return OutMinY <= OutMaxY;
 	}
 
 	void GetEdgeCoords2D(FIntPoint const CellCoord, ECBGridDirection const GridDirection, float const CellSize, FVector2d & OutEdgeStart, FVector2d & OutEdgeEnd)
@@ -61,9 +90,301 @@ namespace
 		OutEdgeStart = FVector2d{ EdgeStartCoord.X * CellSize, EdgeStartCoord.Y * CellSize };
 		OutEdgeEnd = FVector2d{ EdgeEndCoord.X * CellSize, EdgeEndCoord.Y * CellSize };
 	}
+
+	/** Node ref layout: cell index in tile in bits 0-27, tile index in bits 28-47, tile generation in bits 48-63. */
+	constexpr uint32 NodeRefCellIndexBitsNum = 28;
+	constexpr uint32 NodeRefTileIndexBitsNum = 20;
+	constexpr uint32 NodeRefTileIndexShift = NodeRefCellIndexBitsNum;
+	constexpr uint32 NodeRefGenerationShift = NodeRefCellIndexBitsNum + NodeRefTileIndexBitsNum;
+	constexpr uint64 NodeRefCellIndexMask = (uint64{ 1 } << NodeRefCellIndexBitsNum) - 1;
+	constexpr uint64 NodeRefTileIndexMask = (uint64{ 1 } << NodeRefTileIndexBitsNum) - 1;
+
+	/** Part of cell size portals are shrunk by from both ends, keeps pulled string corners away from walls. */
+	constexpr FVector::FReal PortalMarginScale = 0.25;
+
+	FVector::FReal GetTriangleArea2(FVector2d const & A, FVector2d const & B, FVector2d const & C)
+	{
+		FVector2d const AB = B - A;
+		FVector2d const AC = C - A;
+		return AC.X * AB.Y - AB.X * AC.Y;
+	}
+
+	/**
+	 * Funnel string pulling over corridor of grid path cells, portals are shared edges of consecutive cells. Every
+	 * portal is visited amortized constant number of times, so cost is linear in path length. Appends corners
+	 * between Start and End to OutCorners.
+	 */
+	void PullString(FVector2d const & Start, FVector2d const & End, TConstArrayView<FIntPoint> const GridPath, float const CellSize, TArray<FVector2d> & OutCorners)
+	{
+		struct FPortal
+		{
+			FVector2d Left;
+			FVector2d Right;
+		};
+
+		TArray<FPortal> Portals;
+		Portals.Reserve(GridPath.Num() + 1);
+		Portals.Add(FPortal{ Start, Start });
+		FVector::FReal const HalfPortalWidth = CellSize * (0.5 - PortalMarginScale);
+		for (int32 GridCoordIndex = 1; GridCoordIndex < GridPath.Num(); ++GridCoordIndex)
+		{
+			FIntPoint const Direction = GridPath[GridCoordIndex] - GridPath[GridCoordIndex - 1];
+			check(Direction.SizeSquared() == 1);
+			FVector2d const PortalCenter = (CBGridUtilities::GetGridCellCenter(GridPath[GridCoordIndex - 1], CellSize) + CBGridUtilities::GetGridCellCenter(GridPath[GridCoordIndex], CellSize)) * 0.5;
+			FVector2d const PortalHalfExtent = FVector2d{ static_cast<FVector::FReal>(-Direction.Y), static_cast<FVector::FReal>(Direction.X) } * HalfPortalWidth;
+			Portals.Add(FPortal{ PortalCenter + PortalHalfExtent, PortalCenter - PortalHalfExtent });
+		}
+		Portals.Add(FPortal{ End, End });
+
+		FVector2d Apex = Start;
+		FVector2d Left = Start;
+		FVector2d Right = Start;
+		int32 LeftIndex = 0;
+		int32 RightIndex = 0;
+		for (int32 PortalIndex = 1; PortalIndex < Portals.Num(); ++PortalIndex)
+		{
+			FPortal const & Portal = Portals[PortalIndex];
+
+			if (GetTriangleArea2(Apex, Right, Portal.Right) <= 0.)
+			{
+				if (Apex.Equals(Right) || GetTriangleArea2(Apex, Left, Portal.Right) > 0.)
+				{
+					Right = Portal.Right;
+					RightIndex = PortalIndex;
+				}
+				else
+				{
+					// Right side crossed left one, left point becomes new corner.
+					OutCorners.Add(Left);
+					Apex = Left;
+					Right = Left;
+					RightIndex = LeftIndex;
+					PortalIndex = LeftIndex;
+					continue;
+				}
+			}
+
+			if (GetTriangleArea2(Apex, Left, Portal.Left) >= 0.)
+			{
+				if (Apex.Equals(Left) || GetTriangleArea2(Apex, Right, Portal.Left) < 0.)
+				{
+					Left = Portal.Left;
+					LeftIndex = PortalIndex;
+				}
+				else
+				{
+					// Left side crossed right one, right point becomes new corner.
+					OutCorners.Add(Right);
+					Apex = Right;
+					Left = Right;
+					LeftIndex = RightIndex;
+					PortalIndex = RightIndex;
+					continue;
+				}
+			}
+		}
+	}
+
+	FCBNavGridQueryFilter const * GetNavGridQueryFilter(FNavigationQueryFilter const & QueryFilter)
+	{
+		// TODO: Should be dynamic_cast, but by default unreal projects compiled without rtti, so dynamic_cast won't work. Needs some workaround.
+		return static_cast<FCBNavGridQueryFilter const *>(QueryFilter.GetImplementation());
+	}
+
+	uint32 GetFilterBlockingPlanesMask(FNavigationQueryFilter const & QueryFilter)
+	{
+		FCBNavGridQueryFilter const * const NavGridQueryFilter = GetNavGridQueryFilter(QueryFilter);
+		return NavGridQueryFilter ? NavGridQueryFilter->GetBlockingPlanesMask() : 0;
+	}
+
+	float GetFilterAgentRadius(FNavigationQueryFilter const & QueryFilter)
+	{
+		FCBNavGridQueryFilter const * const NavGridQueryFilter = GetNavGridQueryFilter(QueryFilter);
+		return NavGridQueryFilter ? NavGridQueryFilter->GetAgentRadius() : 0.f;
+	}
+
+	FCBNavGridAStarFilter MakeAStarFilter(FNavigationQueryFilter const & QueryFilter, FVector::FReal const CostLimit, bool const bWantsPartialSolution, bool const bUseAnyAngleSearch = false)
+	{
+		FCBNavGridQueryFilter const * const NavGridQueryFilter = GetNavGridQueryFilter(QueryFilter);
+		FVector2d const AxiswiseHeuristicScale = NavGridQueryFilter ? static_cast<FVector2d>(NavGridQueryFilter->GetAxiswiseHeuristicScale()) : FVector2d{ 1., 1. };
+		bool const bUseFixedPointCosts = NavGridQueryFilter && NavGridQueryFilter->UsesFixedPointCosts();
+		bool const bUseJumpPointSearch = NavGridQueryFilter && NavGridQueryFilter->UsesJumpPointSearch();
+		if (NavGridQueryFilter && NavGridQueryFilter->HasAreaCosts())
+		{
+			// Area costs are applied only by adjacent cells expansion, heuristic is scaled down by the cheapest area to stay admissible.
+			// Area and entering costs may exceed range of fixed point traversal costs, so floating point costs are used.
+			FVector::FReal const HeuristicScale = QueryFilter.GetHeuristicScale() * NavGridQueryFilter->GetMinAreaCost();
+			return FCBNavGridAStarFilter{ HeuristicScale, AxiswiseHeuristicScale, CostLimit, QueryFilter.GetMaxSearchNodes(), bWantsPartialSolution, false, false, false, NavGridQueryFilter->GetBlockingPlanesMask(), NavGridQueryFilter->GetAreaCosts(), NavGridQueryFilter->GetAreaEnteringCosts(), NavGridQueryFilter->GetAgentRadius() };
+		}
+		return FCBNavGridAStarFilter{ QueryFilter.GetHeuristicScale(), AxiswiseHeuristicScale, CostLimit, QueryFilter.GetMaxSearchNodes(), bWantsPartialSolution, bUseFixedPointCosts, bUseJumpPointSearch, bUseAnyAngleSearch, GetFilterBlockingPlanesMask(QueryFilter), {}, {}, GetFilterAgentRadius(QueryFilter) };
+	}
+
+	bool HasFilterAreaCosts(FNavigationQueryFilter const & QueryFilter)
+	{
+		FCBNavGridQueryFilter const * const NavGridQueryFilter = GetNavGridQueryFilter(QueryFilter);
+		return NavGridQueryFilter && NavGridQueryFilter->HasAreaCosts();
+	}
+
+	ENavigationQueryResult::Type ToNavigationQueryResult(ECBNavGridAStarResult const AStarResult, FIntPoint const StartGridCoord, TArray<FIntPoint> & OutPath)
+	{
+		if (AStarResult == ECBNavGridAStarResult::SearchFail)
+		{
+			return ENavigationQueryResult::Error;
+		}
+		if (AStarResult == ECBNavGridAStarResult::SearchSuccess && OutPath.IsEmpty())
+		{
+			OutPath.Add(StartGridCoord);
+		}
+		if (OutPath.IsEmpty())
+		{
+			return ENavigationQueryResult::Fail;
+		}
+		return ENavigationQueryResult::Success;
+	}
+
+	/** Batch work items are processed in chunks of this size, batches not larger than one chunk are processed serially. */
+	constexpr int32 BatchChunkSize = 64;
+
+	/** Least recently used flow fields are dropped when cache grows over this size. */
+	constexpr int32 MaxCachedFlowFieldsNum = 16;
+
+	/**
+	 * Sorts work items by tile containing their location, so items of one chunk touch the same few tiles, and processes
+	 * chunks in parallel under the read scope of the batch. ProcessWork is called with index of work item and must only
+	 * read nav grid.
+	 */
+	template <typename TGetLocation, typename TProcessWork>
+	void ProcessBatchByTiles(ACBNavGrid const & NavGrid, int32 const WorkNum, TGetLocation && GetLocation, TProcessWork && ProcessWork)
+	{
+		FCBNavGridReadScope const ReadScope{ NavGrid };
+		if (WorkNum <= BatchChunkSize)
+		{
+			for (int32 WorkIndex = 0; WorkIndex < WorkNum; ++WorkIndex)
+			{
+				ProcessWork(WorkIndex);
+			}
+			return;
+		}
+
+		struct FWorkKey
+		{
+			FIntPoint TileCoord;
+			int32 WorkIndex;
+		};
+
+		TArray<FWorkKey> WorkKeys;
+		WorkKeys.Reserve(WorkNum);
+		for (int32 WorkIndex = 0; WorkIndex < WorkNum; ++WorkIndex)
+		{
+			FIntPoint const GridCoord = CBGridUtilities::GetGridCellCoord(static_cast<FVector2d>(GetLocation(WorkIndex)), NavGrid.GetGridCellSize());
+			WorkKeys.Add(FWorkKey{ NavGrid.GetTileCoord(GridCoord), WorkIndex });
+		}
+		WorkKeys.Sort([](FWorkKey const & A, FWorkKey const & B)
+			{
+				return A.TileCoord.X != B.TileCoord.X ? A.TileCoord.X < B.TileCoord.X : A.TileCoord.Y < B.TileCoord.Y;
+			});
+
+		ParallelFor(FMath::DivideAndRoundUp(WorkNum, BatchChunkSize), [&NavGrid, &ReadScope, &WorkKeys, &ProcessWork](int32 const ChunkIndex)
+			{
+				FCBNavGridReadScope const ChunkReadScope{ NavGrid, ReadScope };
+				int32 const ChunkEnd = FMath::Min((ChunkIndex + 1) * BatchChunkSize, WorkKeys.Num());
+				for (int32 KeyIndex = ChunkIndex * BatchChunkSize; KeyIndex < ChunkEnd; ++KeyIndex)
+				{
+					ProcessWork(WorkKeys[KeyIndex].WorkIndex);
+				}
+			});
+	}
+
+	/** Collects layers of tiles other than the tile of TileCoord closer than Band cells to GridRect, FindLayer maps tile coord to layer. */
+	template <typename TFindLayer>
+	void FindNeighbourLayers(FIntPoint const TileCoord, FIntRect const & GridRect, int32 const Band, FIntPoint const TileSize, TFindLayer && FindLayer, TArray<FCBNavGridLayer const *, TInlineAllocator<8>> & OutNeighbourLayers)
+	{
+		FIntRect const AffectingGridRect{ GridRect.Min - FIntPoint{ Band, Band }, GridRect.Max + FIntPoint{ Band, Band } };
+		FIntRect const AffectingTileRect = CBGridUtilities::GetTileRect(AffectingGridRect, TileSize);
+		for (int32 TileX = AffectingTileRect.Min.X; TileX < AffectingTileRect.Max.X; ++TileX)
+		{
+			for (int32 TileY = AffectingTileRect.Min.Y; TileY < AffectingTileRect.Max.Y; ++TileY)
+			{
+				FIntPoint const NeighbourTileCoord{ TileX, TileY };
+				FCBNavGridLayer const * const NeighbourLayer = NeighbourTileCoord != TileCoord ? FindLayer(NeighbourTileCoord) : nullptr;
+				if (NeighbourLayer)
+				{
+					OutNeighbourLayers.Add(NeighbourLayer);
+				}
+			}
+		}
+	}
+
+	/** Erodes free cells of rect covering all footprint placements with Erode and outputs erosion of candidate positions. */
+	template <typename TErode>
+	void FindValidFootprintPositions(ACBNavGrid const & NavGrid, FIntRect const & CandidateRect, FIntPoint const FootprintSize, TErode && Erode, TBitArray<> & OutValidPositions)
+	{
+		OutValidPositions.Reset();
+		if (CandidateRect.Width() <= 0 || CandidateRect.Height() <= 0 || FootprintSize.X <= 0 || FootprintSize.Y <= 0)
+		{
+			return;
+		}
+
+		FCBNavGridReadScope const ReadScope{ NavGrid };
+		FCBNavGridErosion Erosion{ FIntRect{ CandidateRect.Min, CandidateRect.Max + FootprintSize - FIntPoint{ 1, 1 } } };
+		Erosion.AddFreeCells(NavGrid);
+		Erode(Erosion);
+		OutValidPositions.Init(false, CandidateRect.Area());
+		int32 PositionIndex = 0;
+		for (int32 X = CandidateRect.Min.X; X < CandidateRect.Max.X; ++X)
+		{
+			for (int32 Y = CandidateRect.Min.Y; Y < CandidateRect.Max.Y; ++Y)
+			{
+				OutValidPositions[PositionIndex++] = Erosion.IsCellFree(FIntPoint{ X, Y });
+			}
+		}
+	}
+
+	/** Tiles locks held by read scopes of this thread, nested scopes don't lock them again. */
+	thread_local TArray<FRWLock const *, TInlineAllocator<2>> HeldTilesLocks;
 } // namespace
 
 
+FCBNavGridReadScope::FCBNavGridReadScope(ACBNavGrid const & NavGrid)
+{
+	if (IsInGameThread())
+	{
+		return;
+	}
+	TilesLock = &NavGrid.TilesLock;
+	if (!HeldTilesLocks.Contains(TilesLock))
+	{
+		TilesLock->ReadLock();
+		HeldTilesLocks.Add(TilesLock);
+		bIsRegistered = true;
+		bIsLocked = true;
+	}
+}
+
+FCBNavGridReadScope::FCBNavGridReadScope(ACBNavGrid const & NavGrid, FCBNavGridReadScope const & ParentScope)
+	: TilesLock(ParentScope.TilesLock)
+{
+	// Parent scope of game thread holds no lock, but tiles aren't changed while game thread waits for this task.
+	check(!TilesLock || TilesLock == &NavGrid.TilesLock);
+	if (TilesLock && !HeldTilesLocks.Contains(TilesLock))
+	{
+		HeldTilesLocks.Add(TilesLock);
+		bIsRegistered = true;
+	}
+}
+
+FCBNavGridReadScope::~FCBNavGridReadScope()
+{
+	if (bIsRegistered)
+	{
+		HeldTilesLocks.RemoveSingleSwap(TilesLock);
+	}
+	if (bIsLocked)
+	{
+		TilesLock->ReadUnlock();
+	}
+}
+
 FCBNavGridDebugSettings::FCBNavGridDebugSettings()
 	: DrawDistance(15000.f)
 	, DrawOffset(30.f)
@@ -80,16 +401,23 @@ ACBNavGrid::ACBNavGrid()
 	, MaxNavigableCellHeightsDifference(50.f)
 	, MinZ(-1e9f)
 	, MaxZ(1e9f)
+	, bBuildOccupiedCellsSums(false)
+	, MaxClearance(0)
 	, DefaultMaxSearchNodes(2048)
 	, DefaultHeuristicScale(1.00001f)
 	, DefaultAxiswiseHeuristicScale(1.f, 1.00001f)
+	, bDefaultUseFixedPointCosts(false)
+	, bDefaultUseJumpPointSearch(false)
 {
+	AbstractGraph = MakeUnique<FCBNavGridAbstractGraph>(*this);
+	Islands = MakeUnique<FCBNavGridIslands>(*this);
+
 	if (!HasAnyFlags(RF_ClassDefaultObject))
 	{
 		FindPathImplementation = FindPath;
-		FindHierarchicalPathImplementation = FindPath;
+		FindHierarchicalPathImplementation = FindHierarchicalPath;
 		TestPathImplementation = TestPath;
-		TestHierarchicalPathImplementation = TestPath;
+		TestHierarchicalPathImplementation = TestHierarchicalPath;
 		RaycastImplementationWithAdditionalResults = Raycast;
 
 		SupportedAreas.Add(FSupportedAreaData{ UNavArea_Default::StaticClass(), 0 });
@@ -103,6 +431,8 @@ void ACBNavGrid::PostInitProperties()
 {
 	Super::PostInitProperties();
 
+	MaxClearance = FMath::Min<uint8>(MaxClearance, FCBNavGridLayer::NoFitClearance - 1);
+
 	if (!HasAnyFlags(RF_ClassDefaultObject | RF_NeedLoad))
 	{
 		RecreateDefaultFilter();
@@ -113,6 +443,8 @@ void ACBNavGrid::PostLoad()
 {
 	Super::PostLoad();
 
+	MaxClearance = FMath::Min<uint8>(MaxClearance, FCBNavGridLayer::NoFitClearance - 1);
+
 	RecreateDefaultFilter();
 }
 
@@ -124,7 +456,64 @@ void ACBNavGrid::Serialize(FArchive & Archive)
 
 	if (!Archive.IsTransacting())
 	{
-		Archive << Tiles;
+		// Tiles are serialized as map to keep archive format independent of tile table layout.
+		if (!Archive.IsLoading())
+		{
+			TMap<FIntPoint, FTileData> SerializedTiles;
+			SerializedTiles.Reserve(Tiles.Num());
+			for (FTileData const & TileData : Tiles)
+			{
+				SerializedTiles.Add(TileData.Coord, TileData);
+			}
+			Archive << SerializedTiles;
+		}
+		else
+		{
+			// Loaded layers are set up before they are published, so queries never see them half set up.
+			TMap<FIntPoint, FLoadedTileData> LoadedTiles;
+			Archive << LoadedTiles;
+			for (TPair<FIntPoint, FLoadedTileData> & LoadedTile : LoadedTiles)
+			{
+				if (FCBNavGridLayer * const NavGridLayer = LoadedTile.Value.NavigationData.Get())
+				{
+					NavGridLayer->SetBlockingPlanesNum(GetBlockingPlanesNum());
+					if (bBuildOccupiedCellsSums)
+					{
+						NavGridLayer->UpdateOccupiedCellsSums();
+					}
+				}
+			}
+			if (MaxClearance > 0)
+			{
+				for (TPair<FIntPoint, FLoadedTileData> & LoadedTile : LoadedTiles)
+				{
+					if (FCBNavGridLayer * const NavGridLayer = LoadedTile.Value.NavigationData.Get())
+					{
+						TArray<FCBNavGridLayer const *, TInlineAllocator<8>> NeighbourLayers;
+						FindNeighbourLayers(LoadedTile.Key, NavGridLayer->GetGridRect(), MaxClearance, TileSize, [&LoadedTiles](FIntPoint const NeighbourTileCoord) -> FCBNavGridLayer const *
+							{
+								FLoadedTileData const * const NeighbourTile = LoadedTiles.Find(NeighbourTileCoord);
+								return NeighbourTile ? NeighbourTile->NavigationData.Get() : nullptr;
+							}, NeighbourLayers);
+						NavGridLayer->UpdateClearances(NavGridLayer->GetGridRect(), NeighbourLayers, MaxClearance);
+					}
+				}
+			}
+
+			EmptyTiles();
+			{
+				FRWScopeLock const TilesScopeLock{ TilesLock, SLT_Write };
+				for (TPair<FIntPoint, FLoadedTileData> & LoadedTile : LoadedTiles)
+				{
+					FTileData & TileData = FindOrAddTileData(LoadedTile.Key);
+					TileData.NavigationData = MoveTemp(LoadedTile.Value.NavigationData);
+					TileData.Heightfield = MoveTemp(LoadedTile.Value.Heightfield);
+				}
+				BoundingGridRect = CalculateBoundingGridRect();
+			}
+			AbstractGraph->Rebuild();
+			Islands->Rebuild();
+		}
 	}
 }
 
@@ -137,8 +526,9 @@ void ACBNavGrid::CleanUp()
 		NavDataGenerator->CancelBuild();
 		NavDataGenerator.Reset();
 	}
-	Tiles.Empty();
-	BoundingGridRect = FIntRect{};
+	EmptyTiles();
+	AbstractGraph->Reset();
+	Islands->Reset();
 }
 
 bool ACBNavGrid::NeedsRebuild() const
@@ -169,41 +559,52 @@ void ACBNavGrid::ConditionalConstructGenerator()
 
 void ACBNavGrid::RebuildAll()
 {
-	Tiles.Empty();
-	BoundingGridRect = FIntRect{};
+	EmptyTiles();
+	AbstractGraph->Reset();
+	Islands->Reset();
 
 	Super::RebuildAll();
 }
 
 void ACBNavGrid::BatchRaycast(TArray<FNavigationRaycastWork> & Workload, FSharedConstNavQueryFilter QueryFilter, UObject const * Querier) const
 {
-	for (FNavigationRaycastWork & Work : Workload)
-	{
-		Work.bDidHit = Raycast(Work.RayStart, Work.RayEnd, Work.HitLocation, Work.bIsRayEndInCorridor);
-	}
+	ProcessBatchByTiles(*this, Workload.Num(),
+		[&Workload](int32 const WorkIndex) { return Workload[WorkIndex].RayStart; },
+		[this, &Workload, BlockingPlanesMask = GetFilterBlockingPlanesMask(GetFilterRef(QueryFilter.Get())), AgentRadius = GetFilterAgentRadius(GetFilterRef(QueryFilter.Get()))](int32 const WorkIndex)
+		{
+			FNavigationRaycastWork & Work = Workload[WorkIndex];
+			Work.bDidHit = Raycast(Work.RayStart, Work.RayEnd, Work.HitLocation, Work.bIsRayEndInCorridor, BlockingPlanesMask, AgentRadius);
+		});
 }
 
 bool ACBNavGrid::FindMoveAlongSurface(FNavLocation const & StartLocation, FVector const & TargetPosition, FNavLocation & OutLocation, FSharedConstNavQueryFilter const Filter, UObject const * const Querier) const
 {
+	FCBNavGridReadScope const ReadScope{ *this };
 	if (!DoesNodeContainLocation(StartLocation.NodeRef, StartLocation.Location))
 	{
 		return false;
 	}
 
+	FNavigationQueryFilter const & FilterRef = GetFilterRef(Filter.Get());
 	bool bDummyIsRayEndInCorridor;
-	Raycast(StartLocation.Location, TargetPosition, OutLocation, bDummyIsRayEndInCorridor);
+	Raycast(StartLocation.Location, TargetPosition, OutLocation, bDummyIsRayEndInCorridor, GetFilterBlockingPlanesMask(FilterRef), GetFilterAgentRadius(FilterRef));
 	return true;
 }
 
 bool ACBNavGrid::FindOverlappingEdges(FNavLocation const & StartLocation, TConstArrayView<FVector> const ConvexPolygon, TArray<FVector> & OutEdges, FSharedConstNavQueryFilter const Filter, UObject const * const Querier) const
 {
+	FCBNavGridReadScope const ReadScope{ *this };
 	if (!StartLocation.HasNodeRef())
 	{
 		return false;
 	}
 
 	FIntPoint const StartGridCoord = GetGridCoord(StartLocation.NodeRef);
-	FCBNavGridLayer const * Tile = GetTileNavigationData(GetTileCoord(StartGridCoord)).Get();
+	if (StartGridCoord == INVALID_GRIDCOORD)
+	{
+		return false;
+	}
+	FCBNavGridLayer const * Tile = FindTileNavigationData(GetTileCoord(StartGridCoord));
 	if (!Tile || Tile->IsCellOccupied(StartGridCoord))
 	{
 		return false;
@@ -216,6 +617,7 @@ bool ACBNavGrid::FindOverlappingEdges(FNavLocation const & StartLocation, TConst
 
 bool ACBNavGrid::GetPathSegmentBoundaryEdges(FNavigationPath const & Path, FNavPathPoint const & StartPoint, FNavPathPoint const & EndPoint, TConstArrayView<FVector> const SearchArea, TArray<FVector> & OutEdges, float const MaxAreaEnterCost, FSharedConstNavQueryFilter const Filter, UObject const * const Querier) const
 {
+	FCBNavGridReadScope const ReadScope{ *this };
 	FCBNavGridPath const * const NavGridPath = Path.CastPath<FCBNavGridPath const>();
 	if (!StartPoint.HasNodeRef() || !EndPoint.HasNodeRef() || !NavGridPath)
 	{
@@ -243,7 +645,12 @@ bool ACBNavGrid::GetPathSegmentBoundaryEdges(FNavigationPath const & Path, FNavP
 	for (int32 PointIndex = StartPointIndex; PointIndex < PathPoints.Num(); ++PointIndex)
 	{
 		FNavPathPoint const & PathPoint = PathPoints[PointIndex];
-		PathSegmentGridCells.Add(GetGridCoord(PathPoint.NodeRef));
+		FIntPoint const GridCoord = GetGridCoord(PathPoint.NodeRef);
+		if (GridCoord == INVALID_GRIDCOORD)
+		{
+			return false;
+		}
+		PathSegmentGridCells.Add(GridCoord);
 		if (PathPoint.NodeRef == EndPoint.NodeRef)
 		{
 			break;
@@ -257,54 +664,29 @@ bool ACBNavGrid::GetPathSegmentBoundaryEdges(FNavigationPath const & Path, FNavP
 
 FNavLocation ACBNavGrid::GetRandomPoint(FSharedConstNavQueryFilter Filter, UObject const * Querier) const
 {
+	FCBNavGridReadScope const ReadScope{ *this };
 	FNavLocation NavLocation;
-	if (Tiles.IsEmpty())
-	{
-		return NavLocation;
-	}
-
-	// Chooses random tile assuming they have almost equal navigable area.
 	FCBNavGridLayer const * RandomTile = nullptr;
+	int32 RandomTileFreeCellIndex = 0;
 	{
-		int32 TileIndex = FMath::RandHelper(Tiles.Num());
-		for (TPair<FIntPoint, FTileData> const & TileEntry : Tiles)
-		{
-			if (TileIndex == 0)
-			{
-				RandomTile = TileEntry.Value.NavigationData.Get();
-				break;
-			}
-			--TileIndex;
-		}
-	}
-	check(RandomTile);
-
-	FIntPoint RandomCellCoord{};
-	{
-		int32 NavigableCellsNum = 0;
-		FIntRect const & TileGridRect = RandomTile->GetGridRect();
-		for (int32 X = TileGridRect.Min.X; X < TileGridRect.Max.X; ++X)
+		UE::TScopeLock RandomPointIndexScopeLock(RandomPointIndexLock);
+		if (!bIsRandomPointIndexValid)
 		{
-			for (int32 Y = TileGridRect.Min.Y; Y < TileGridRect.Max.Y; ++Y)
-			{
-				FIntPoint const CellCoord{ X, Y };
-				if (RandomTile->IsCellOccupied(CellCoord))
-				{
-					continue;
-				}
-				++NavigableCellsNum;
-				if (FMath::RandHelper(NavigableCellsNum) == 0)
-				{
-					RandomCellCoord = CellCoord;
-				}
-			}
+			UpdateRandomPointIndex();
 		}
-
-		if (NavigableCellsNum == 0)
+		if (RandomPointTiles.IsEmpty())
 		{
 			return NavLocation;
 		}
+
+		// Tile is chosen proportionally to its free cells number, so every free cell is equally likely.
+		int64 const RandomFreeCellIndex = FMath::RandRange(int64{ 0 }, RandomPointTilesPrefixSums.Last() - 1);
+		int32 const RandomTileIndex = Algo::UpperBound(RandomPointTilesPrefixSums, RandomFreeCellIndex);
+		int64 const FirstFreeCellIndex = RandomTileIndex == 0 ? 0 : RandomPointTilesPrefixSums[RandomTileIndex - 1];
+		RandomTile = RandomPointTiles[RandomTileIndex];
+		RandomTileFreeCellIndex = static_cast<int32>(RandomFreeCellIndex - FirstFreeCellIndex);
 	}
+	FIntPoint const RandomCellCoord = RandomTile->GetFreeCell(RandomTileFreeCellIndex);
 
 	NavLocation.Location.X = (RandomCellCoord.X + FMath::FRand()) * GridCellSize;
 	NavLocation.Location.Y = (RandomCellCoord.Y + FMath::FRand()) * GridCellSize;
@@ -316,6 +698,10 @@ FNavLocation ACBNavGrid::GetRandomPoint(FSharedConstNavQueryFilter Filter, UObje
 
 bool ACBNavGrid::GetRandomReachablePointInRadius(FVector const & Origin, float const Radius, FNavLocation & OutResult, FSharedConstNavQueryFilter Filter, UObject const * Querier) const
 {
+	FCBNavGridReadScope const ReadScope{ *this };
+	FNavigationQueryFilter const & FilterRef = GetFilterRef(Filter.Get());
+	uint32 const BlockingPlanesMask = GetFilterBlockingPlanesMask(FilterRef);
+	float const AgentRadius = GetFilterAgentRadius(FilterRef);
 	FIntPoint RandomCellCoord{};
 	{
 		FVector ProjectedOrigin;
@@ -324,64 +710,41 @@ bool ACBNavGrid::GetRandomReachablePointInRadius(FVector const & Origin, float c
 		{
 			FVector Extent = GetDefaultQueryExtent();
 			Extent.Z = TNumericLimits<FVector::FReal>::Max();
-			if (!ProjectPoint(Origin, Extent, &ProjectedOrigin, &OriginGridCoord))
+			if (!ProjectPoint(Origin, Extent, &ProjectedOrigin, &OriginGridCoord, BlockingPlanesMask, AgentRadius))
 			{
 				return false;
 			}
 		}
 
-		TSet<FIntPoint> VisitedSet;
-		TArray<FIntPoint> OpenList;
-		{
-			int32 const ToReserveNum = FMath::Square(FMath::CeilToInt(2.f * Radius / GridCellSize));
-			OpenList.Reserve(ToReserveNum);
-			VisitedSet.Reserve(ToReserveNum);
-		}
-		OpenList.Add(OriginGridCoord);
-		VisitedSet.Add(OriginGridCoord);
-		RandomCellCoord = OriginGridCoord;
-
-		float const SqRadius = FMath::Square(Radius);
-		FCBNavGridLayer const * Tile = GetTileNavigationData(GetTileCoord(OriginGridCoord)).Get();
-		check(Tile);
-
-		while (!OpenList.IsEmpty())
+		// Cells with centers out of radius are impassable, so every reached cell is equally likely to be chosen.
+		FVector2d const Center{ ProjectedOrigin };
+		FIntRect const GridRect = CBGridUtilities::GetGridRectFromBoundingBox2d(FBox2d{ Center - FVector2d{ Radius }, Center + FVector2d{ Radius } }, GridCellSize);
+		FCBNavGridFloodFill FloodFill{ GridRect };
+		FloodFill.AddFreeCells(*this, BlockingPlanesMask, GetRequiredClearance(AgentRadius));
+		for (int32 X = GridRect.Min.X; X < GridRect.Max.X; ++X)
 		{
-			FIntPoint const CellCoord = OpenList.Pop(EAllowShrinking::No);
-			for (ECBGridDirection const GridDirection : TEnumRange<ECBGridDirection>())
+			double const DeltaX = (X + 0.5) * GridCellSize - Center.X;
+			double const SqHalfChord = FMath::Square(static_cast<double>(Radius)) - FMath::Square(DeltaX);
+			if (SqHalfChord < 0.)
 			{
-				FIntPoint const AdjacentCellCoord = CBGridUtilities::GetAdjacentCoordChecked(CellCoord, GridDirection);
-				FVector2d const AdjacentCellCenter = CBGridUtilities::GetGridCellCenter(AdjacentCellCoord, GridCellSize);
-				float const AdjacentCellCenterToOriginSqDist = FVector2d::DistSquared(AdjacentCellCenter, static_cast<FVector2d>(ProjectedOrigin));
-				if (SqRadius < AdjacentCellCenterToOriginSqDist || VisitedSet.Contains(AdjacentCellCoord))
-				{
-					continue;
-				}
-				if (!Tile->IsInGrid(AdjacentCellCoord))
-				{
-					FCBNavGridLayer const * NewTile = GetTileNavigationData(GetTileCoord(AdjacentCellCoord)).Get();
-					if (!NewTile)
-					{
-						continue;
-					}
-					Tile = NewTile;
-				}
-				if (!Tile->IsCellOccupied(AdjacentCellCoord))
-				{
-					OpenList.Push(AdjacentCellCoord);
-					VisitedSet.Add(AdjacentCellCoord);
-					if (FMath::RandHelper(VisitedSet.Num()) == 0)
-					{
-						RandomCellCoord = AdjacentCellCoord;
-					}
-				}
+				FloodFill.ClipColumn(X, 0, -1);
+				continue;
 			}
+			double const HalfChord = FMath::Sqrt(SqHalfChord);
+			int32 const MinY = FMath::CeilToInt32((Center.Y - HalfChord) / GridCellSize - 0.5);
+			int32 const MaxY = FMath::FloorToInt32((Center.Y + HalfChord) / GridCellSize - 0.5);
+			FloodFill.ClipColumn(X, MinY, MaxY);
 		}
+		FloodFill.AddSeed(OriginGridCoord);
+		FloodFill.Fill();
+
+		int32 const ReachedCellsNum = FloodFill.GetReachedCellsNum();
+		RandomCellCoord = ReachedCellsNum > 0 ? FloodFill.GetReachedCell(FMath::RandHelper(ReachedCellsNum)) : OriginGridCoord;
 	}
 
 	OutResult.Location.X = (RandomCellCoord.X + FMath::FRand()) * GridCellSize;
 	OutResult.Location.Y = (RandomCellCoord.Y + FMath::FRand()) * GridCellSize;
-	OutResult.Location.Z = GetTileNavigationData(GetTileCoord(RandomCellCoord))->GetCellHeight(RandomCellCoord);
+	OutResult.Location.Z = FindTileNavigationData(GetTileCoord(RandomCellCoord))->GetCellHeight(RandomCellCoord);
 	OutResult.NodeRef = GetNodeRef(RandomCellCoord);
 
 	return true;
@@ -389,6 +752,7 @@ bool ACBNavGrid::GetRandomReachablePointInRadius(FVector const & Origin, float c
 
 bool ACBNavGrid::GetRandomPointInNavigableRadius(FVector const & Origin, float const Radius, FNavLocation & OutResult, FSharedConstNavQueryFilter Filter, UObject const * Querier) const
 {
+	FCBNavGridReadScope const ReadScope{ *this };
 	{
 		FVector2d const RandomOffset = FMath::RandPointInCircle(Radius);
 		FVector const RandomPointInRadius{ Origin.X + RandomOffset.X, Origin.Y + RandomOffset.Y, 0. };
@@ -416,8 +780,8 @@ bool ACBNavGrid::GetRandomPointInNavigableRadius(FVector const & Origin, float c
 		{
 			for (int32 TileY = TileRect.Min.Y; TileY < TileRect.Max.Y; ++TileY)
 			{
-				FCBNavGridLayer const * NavGridLayer = GetTileNavigationData(FIntPoint{ TileX, TileY }).Get();
-				if (!NavGridLayer)
+				FCBNavGridLayer const * NavGridLayer = FindTileNavigationData(FIntPoint{ TileX, TileY });
+				if (!NavGridLayer || NavGridLayer->AreAllCellsOccupied())
 				{
 					continue;
 				}
@@ -455,7 +819,7 @@ bool ACBNavGrid::GetRandomPointInNavigableRadius(FVector const & Origin, float c
 
 	OutResult.Location.X = (RandomCellCoord.X + FMath::FRand()) * GridCellSize;
 	OutResult.Location.Y = (RandomCellCoord.Y + FMath::FRand()) * GridCellSize;
-	OutResult.Location.Z = GetTileNavigationData(GetTileCoord(RandomCellCoord))->GetCellHeight(RandomCellCoord);
+	OutResult.Location.Z = FindTileNavigationData(GetTileCoord(RandomCellCoord))->GetCellHeight(RandomCellCoord);
 	OutResult.NodeRef = GetNodeRef(RandomCellCoord);
 
 	return true;
@@ -463,8 +827,10 @@ bool ACBNavGrid::GetRandomPointInNavigableRadius(FVector const & Origin, float c
 
 bool ACBNavGrid::ProjectPoint(FVector const & Point, FNavLocation & OutLocation, FVector const & Extent, FSharedConstNavQueryFilter Filter, UObject const * Querier) const
 {
+	FCBNavGridReadScope const ReadScope{ *this };
 	FIntPoint GridCoord;
-	bool const bResult = ProjectPoint(Point, Extent, &OutLocation.Location, &GridCoord);
+	FNavigationQueryFilter const & FilterRef = GetFilterRef(Filter.Get());
+	bool const bResult = ProjectPoint(Point, Extent, &OutLocation.Location, &GridCoord, GetFilterBlockingPlanesMask(FilterRef), GetFilterAgentRadius(FilterRef));
 	if (bResult)
 	{
 		OutLocation.NodeRef = GetNodeRef(GridCoord);
@@ -474,39 +840,42 @@ bool ACBNavGrid::ProjectPoint(FVector const & Point, FNavLocation & OutLocation,
 
 bool ACBNavGrid::IsNodeRefValid(NavNodeRef const NodeRef) const
 {
-	if (NodeRef == INVALID_NAVNODEREF)
-	{
-		return false;
-	}
+	FCBNavGridReadScope const ReadScope{ *this };
 	FIntPoint const GridCoord = GetGridCoord(NodeRef);
-	FCBNavGridLayer const * NavGridLayer = GetTileNavigationData(GetTileCoord(GridCoord)).Get();
-	if (NavGridLayer && !NavGridLayer->IsCellOccupied(GridCoord))
+	if (GridCoord == INVALID_GRIDCOORD)
 	{
-		return true;
+		return false;
 	}
-	return false;
+	FCBNavGridLayer const * NavGridLayer = FindTileNavigationData(GetTileCoord(GridCoord));
+	return NavGridLayer && !NavGridLayer->IsCellOccupied(GridCoord);
 }
 
 void ACBNavGrid::BatchProjectPoints(TArray<FNavigationProjectionWork> & Workload, FVector const & Extent, FSharedConstNavQueryFilter Filter, UObject const * Querier) const
 {
-	for (FNavigationProjectionWork & Work : Workload)
-	{
-		if (Work.bIsValid)
+	ProcessBatchByTiles(*this, Workload.Num(),
+		[&Workload](int32 const WorkIndex) { return Workload[WorkIndex].Point; },
+		[this, &Workload, &Extent, &Filter, Querier](int32 const WorkIndex)
 		{
-			Work.bResult = ProjectPoint(Work.Point, Work.OutLocation, Extent, Filter, Querier);
-		}
-	}
+			FNavigationProjectionWork & Work = Workload[WorkIndex];
+			if (Work.bIsValid)
+			{
+				Work.bResult = ProjectPoint(Work.Point, Work.OutLocation, Extent, Filter, Querier);
+			}
+		});
 }
 
 void ACBNavGrid::BatchProjectPoints(TArray<FNavigationProjectionWork> & Workload, FSharedConstNavQueryFilter Filter, UObject const * Querier) const
 {
-	for (FNavigationProjectionWork & Work : Workload)
-	{
-		if (Work.bIsValid)
+	ProcessBatchByTiles(*this, Workload.Num(),
+		[&Workload](int32 const WorkIndex) { return Workload[WorkIndex].Point; },
+		[this, &Workload, &Filter, Querier](int32 const WorkIndex)
 		{
-			Work.bResult = ProjectPoint(Work.Point, Work.OutLocation, Work.ProjectionLimit.GetExtent(), Filter, Querier);
-		}
-	}
+			FNavigationProjectionWork & Work = Workload[WorkIndex];
+			if (Work.bIsValid)
+			{
+				Work.bResult = ProjectPoint(Work.Point, Work.OutLocation, Work.ProjectionLimit.GetExtent(), Filter, Querier);
+			}
+		});
 }
 
 ENavigationQueryResult::Type ACBNavGrid::CalcPathCost(FVector const & PathStart, FVector const & PathEnd, FVector::FReal & OutPathCost, FSharedConstNavQueryFilter const QueryFilter, UObject const * const Querier) const
@@ -525,7 +894,7 @@ ENavigationQueryResult::Type ACBNavGrid::CalcPathLengthAndCost(FVector const & P
 {
 	FCBNavGridPath Path;
 	FPathFindingQuery Query(Querier, *this, PathStart, PathEnd, QueryFilter);
-	ENavigationQueryResult::Type Result = FindPath(Path, Query);
+	ENavigationQueryResult::Type Result = FindPath(Path, Query, false);
 
 	if (Result == ENavigationQueryResult::Success || (Result == ENavigationQueryResult::Fail && Path.IsPartial()))
 	{
@@ -538,12 +907,13 @@ ENavigationQueryResult::Type ACBNavGrid::CalcPathLengthAndCost(FVector const & P
 
 bool ACBNavGrid::DoesNodeContainLocation(NavNodeRef const NodeRef, FVector const & WorldSpaceLocation) const
 {
-	if (NodeRef == INVALID_NAVNODEREF)
+	FCBNavGridReadScope const ReadScope{ *this };
+	FIntPoint const GridCoord = GetGridCoord(NodeRef);
+	if (GridCoord == INVALID_GRIDCOORD)
 	{
 		return false;
 	}
-	FIntPoint const GridCoord = GetGridCoord(NodeRef);
-	FCBNavGridLayer const * NavGridLayer = GetTileNavigationData(GetTileCoord(GridCoord)).Get();
+	FCBNavGridLayer const * NavGridLayer = FindTileNavigationData(GetTileCoord(GridCoord));
 	if (!NavGridLayer || NavGridLayer->IsCellOccupied(GridCoord))
 	{
 		return false;
@@ -561,16 +931,12 @@ UPrimitiveComponent * ACBNavGrid::ConstructRenderingComponent()
 
 FBox ACBNavGrid::GetBounds() const
 {
-	if (!IsValidRect(BoundingGridRect))
-	{
-		BoundingGridRect = CalculateBoundingGridRect();
-	}
-	return GetBoundingBox(BoundingGridRect, GridCellSize, MinZ, MaxZ);
+	return GetBoundingBox(GetBoundingGridRect(), GridCellSize, MinZ, MaxZ);
 }
 
 int32 ACBNavGrid::GetMaxSupportedAreas() const
 {
-	return 2;
+	return FCBNavGridQueryFilter::AreasNum;
 }
 
 #if WITH_EDITOR
@@ -586,6 +952,11 @@ void ACBNavGrid::PostEditChangeChainProperty(FPropertyChangedChainEvent & Proper
 
 void ACBNavGrid::PostEditChangeProperty(FPropertyChangedEvent & PropertyChangedEvent)
 {
+	if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(ACBNavGrid, BlockingPlaneNames))
+	{
+		// Existing tiles are stamped by plane index until they are regenerated, so their planes must match names.
+		UpdateTilesBlockingPlanesNum();
+	}
 	HandleChangePropertyFromCategory(FObjectEditorUtils::GetCategoryFName(PropertyChangedEvent.Property));
 
 	Super::PostEditChangeProperty(PropertyChangedEvent);
@@ -600,14 +971,18 @@ void ACBNavGrid::RecreateDefaultFilter()
 	FCBNavGridQueryFilter * const UENavGridFilter = static_cast<FCBNavGridQueryFilter *>(DefaultQueryFilter->GetImplementation());
 	UENavGridFilter->SetHeuristicScale(DefaultHeuristicScale);
 	UENavGridFilter->SetAxiswiseHeuristicScale(DefaultAxiswiseHeuristicScale);
+	UENavGridFilter->SetUseFixedPointCosts(bDefaultUseFixedPointCosts);
+	UENavGridFilter->SetUseJumpPointSearch(bDefaultUseJumpPointSearch);
 }
 
-bool ACBNavGrid::Raycast2d(FVector2d const & RayStart, FVector2d const & RayEnd, FVector2d * const OutHitLocation, FIntPoint * const OutHitGridCoord) const
+bool ACBNavGrid::Raycast2d(FVector2d const & RayStart, FVector2d const & RayEnd, FVector2d * const OutHitLocation, FIntPoint * const OutHitGridCoord, uint32 const BlockingPlanesMask, float const AgentRadius) const
 {
+	FCBNavGridReadScope const ReadScope{ *this };
+	uint8 const MinClearance = GetRequiredClearance(AgentRadius);
 	FIntPoint const StartGridCoord = CBGridUtilities::GetGridCellCoord(RayStart, GridCellSize);
 	FIntPoint const StartTileCoord = GetTileCoord(StartGridCoord);
-	FCBNavGridLayer const * const StartTile = GetTileNavigationData(StartTileCoord).Get();
-	if (!StartTile || StartTile->IsCellOccupied(StartGridCoord))
+	FCBNavGridLayer const * const StartTile = FindTileNavigationData(StartTileCoord);
+	if (!StartTile || StartTile->IsCellOccupied(StartGridCoord, BlockingPlanesMask, MinClearance))
 	{
 		if (OutHitLocation)
 		{
@@ -650,44 +1025,80 @@ bool ACBNavGrid::Raycast2d(FVector2d const & RayStart, FVector2d const & RayEnd,
 		SideDistance.Y = ((StartGridCoord.Y + 1) * GridCellSize - RayStart.Y) * DeltaDistanceScale.Y;
 	}
 
+	auto ReportHit = [&RayStart, &Direction, OutHitLocation, OutHitGridCoord](FVector::FReal const HitDistance, FIntPoint const PreviousGridCoord)
+		{
+			if (OutHitLocation)
+			{
+				OutHitLocation->X = RayStart.X + Direction.X * HitDistance;
+				OutHitLocation->Y = RayStart.Y + Direction.Y * HitDistance;
+			}
+			if (OutHitGridCoord)
+			{
+				*OutHitGridCoord = PreviousGridCoord;
+			}
+			return true;
+		};
+
+	// Cells crossed by the ray are visited as runs along Y, one run per column. Every run is tested against occupancy
+	// words of the column, so near Y axis rays test whole words at once, while other rays test single cells through
+	// cached tile.
 	FIntPoint GridCoord = StartGridCoord;
 	FIntPoint TileCoord = StartTileCoord;
 	FCBNavGridLayer const * Tile = StartTile;
 	check(Tile);
 
-	while (GridCoord != EndGridCoord)
+	for (;;)
 	{
-		int32 const CoordToUpdateIndex = SideDistance.X < SideDistance.Y ? 0 : 1;
-		FIntPoint const PreviousGridCoord = GridCoord;
-		GridCoord[CoordToUpdateIndex] += Step[CoordToUpdateIndex];
-		bool bDidHit = false;
-
-		if (Tile->IsInGrid(GridCoord))
-		{
-			bDidHit = Tile->IsCellOccupied(GridCoord);
-		}
-		else
+		// Ray crosses Y borders of the column while they are not farther than its next X border.
+		int32 RunEndY = EndGridCoord.Y;
+		if (GridCoord.X != EndGridCoord.X)
 		{
-			TileCoord[CoordToUpdateIndex] += Step[CoordToUpdateIndex];
-			Tile = GetTileNavigationData(TileCoord).Get();
-			bDidHit = !Tile || Tile->IsCellOccupied(GridCoord);
+			FVector::FReal const RemainingYStepsNum = static_cast<FVector::FReal>(FMath::Abs(EndGridCoord.Y - GridCoord.Y));
+			FVector::FReal const YStepsNum = SideDistance.Y <= SideDistance.X ? FMath::Min(FMath::FloorToDouble((SideDistance.X - SideDistance.Y) / DeltaDistance.Y) + 1., RemainingYStepsNum) : 0.;
+			RunEndY = GridCoord.Y + Step.Y * static_cast<int32>(YStepsNum);
 		}
 
-		if (bDidHit)
+		for (int32 RunY = GridCoord.Y + Step.Y; GridCoord.Y != RunEndY; RunY = GridCoord.Y + Step.Y)
 		{
-			if (OutHitLocation)
+			if (!Tile->IsInGrid(FIntPoint{ GridCoord.X, RunY }))
 			{
-				OutHitLocation->X = RayStart.X + Direction.X * SideDistance[CoordToUpdateIndex];
-				OutHitLocation->Y = RayStart.Y + Direction.Y * SideDistance[CoordToUpdateIndex];
-			}
-			if (OutHitGridCoord)
+				TileCoord.Y += Step.Y;
+				Tile = FindTileNavigationData(TileCoord);
+				if (!Tile)
+				{
+					return ReportHit(SideDistance.Y, GridCoord);
+				}
+			}
+
+			FIntRect const TileGridRect = Tile->GetGridRect();
+			int32 const SegmentEndY = Step.Y > 0 ? FMath::Min(RunEndY, TileGridRect.Max.Y - 1) : FMath::Max(RunEndY, TileGridRect.Min.Y);
+			int32 HitY;
+			if (Tile->FindOccupiedCellInColumn(GridCoord.X, RunY, SegmentEndY, HitY, BlockingPlanesMask, MinClearance))
 			{
-				*OutHitGridCoord = PreviousGridCoord;
+				SideDistance.Y += FMath::Abs(HitY - RunY) * DeltaDistance.Y;
+				return ReportHit(SideDistance.Y, FIntPoint{ GridCoord.X, HitY - Step.Y });
 			}
-			return true;
+			SideDistance.Y += (FMath::Abs(SegmentEndY - RunY) + 1) * DeltaDistance.Y;
+			GridCoord.Y = SegmentEndY;
 		}
 
-		SideDistance[CoordToUpdateIndex] += DeltaDistance[CoordToUpdateIndex];
+		if (GridCoord.X == EndGridCoord.X)
+		{
+			break;
+		}
+
+		FIntPoint const PreviousGridCoord = GridCoord;
+		GridCoord.X += Step.X;
+		if (!Tile->IsInGrid(GridCoord))
+		{
+			TileCoord.X += Step.X;
+			Tile = FindTileNavigationData(TileCoord);
+		}
+		if (!Tile || Tile->IsCellOccupied(GridCoord, BlockingPlanesMask, MinClearance))
+		{
+			return ReportHit(SideDistance.X, PreviousGridCoord);
+		}
+		SideDistance.X += DeltaDistance.X;
 	}
 
 	if (OutHitLocation)
@@ -701,12 +1112,13 @@ bool ACBNavGrid::Raycast2d(FVector2d const & RayStart, FVector2d const & RayEnd,
 	return false;
 }
 
-bool ACBNavGrid::Raycast(FVector const & RayStart, FVector const & RayEnd, FNavLocation & OutHitLocation, bool & bOutIsRayEndInCorridor) const
+bool ACBNavGrid::Raycast(FVector const & RayStart, FVector const & RayEnd, FNavLocation & OutHitLocation, bool & bOutIsRayEndInCorridor, uint32 const BlockingPlanesMask, float const AgentRadius) const
 {
+	FCBNavGridReadScope const ReadScope{ *this };
 	FVector const Extent = GetDefaultQueryExtent();
 	
 	FVector StartLocation;
-	if (!ProjectPoint(RayStart, Extent, &StartLocation))
+	if (!ProjectPoint(RayStart, Extent, &StartLocation, nullptr, BlockingPlanesMask, AgentRadius))
 	{
 		OutHitLocation.Location = RayStart;
 		OutHitLocation.NodeRef = INVALID_NAVNODEREF;
@@ -714,7 +1126,7 @@ bool ACBNavGrid::Raycast(FVector const & RayStart, FVector const & RayEnd, FNavL
 	}
 	
 	FVector EndLocation;
-	if (!ProjectPoint(RayEnd, Extent, &EndLocation))
+	if (!ProjectPoint(RayEnd, Extent, &EndLocation, nullptr, BlockingPlanesMask, AgentRadius))
 	{
 		bOutIsRayEndInCorridor = false;
 		EndLocation = RayEnd;
@@ -726,61 +1138,98 @@ bool ACBNavGrid::Raycast(FVector const & RayStart, FVector const & RayEnd, FNavL
 
 	FVector2d HitLocation2d;
 	FIntPoint HitGridCoord;
-	bool const bDidHit = Raycast2d(static_cast<FVector2d>(StartLocation), static_cast<FVector2d>(EndLocation), &HitLocation2d, &HitGridCoord);
+	bool const bDidHit = Raycast2d(static_cast<FVector2d>(StartLocation), static_cast<FVector2d>(EndLocation), &HitLocation2d, &HitGridCoord, BlockingPlanesMask, AgentRadius);
 	OutHitLocation.Location.X = HitLocation2d.X;
 	OutHitLocation.Location.Y = HitLocation2d.Y;
-	FCBNavGridLayer const * const HitTile = GetTileNavigationData(GetTileCoord(HitGridCoord)).Get();
+	FCBNavGridLayer const * const HitTile = FindTileNavigationData(GetTileCoord(HitGridCoord));
 	check(HitTile);
 	OutHitLocation.Location.Z = HitTile->GetCellHeight(HitGridCoord);
 	OutHitLocation.NodeRef = GetNodeRef(HitGridCoord);
 	return bDidHit;
 }
 
-bool ACBNavGrid::ProjectPoint(FVector const & Point, FVector const & Extent, FVector * const OutLocation, FIntPoint * const OutGridCoord) const
+bool ACBNavGrid::ProjectPoint(FVector const & Point, FVector const & Extent, FVector * const OutLocation, FIntPoint * const OutGridCoord, uint32 const BlockingPlanesMask, float const AgentRadius) const
 {
+	FCBNavGridReadScope const ReadScope{ *this };
+	uint8 const MinClearance = GetRequiredClearance(AgentRadius);
 	FBox const QueryBoundingBox{ Point - Extent, Point + Extent };
 	FIntRect const QueryGridRect = CBGridUtilities::GetGridRectFromBoundingBox(QueryBoundingBox, GridCellSize);
-	FIntRect const QueryTileRect = CBGridUtilities::GetTileRect(QueryGridRect, TileSize);
+	if (QueryGridRect.IsEmpty())
+	{
+		return false;
+	}
+
 	FVector ClosestLocation;
 	FIntPoint ClosestLocationGridCoord{};
 	double SqDistToClosestLocation = TNumericLimits<double>::Max();
-	for (int32 TileX = QueryTileRect.Min.X; TileX < QueryTileRect.Max.X; ++TileX)
-	{
-		for (int32 TileY = QueryTileRect.Min.Y; TileY < QueryTileRect.Max.Y; ++TileY)
+	auto VisitFreeCell = [&](FCBNavGridLayer const & NavGridLayer, FIntPoint const CellCoord)
 		{
-			FCBNavGridLayer const * NavGridLayer = GetTileNavigationData(FIntPoint{ TileX, TileY }).Get();
-			if (!NavGridLayer)
+			FVector2d const CellCornerCoord{ CellCoord.X * GridCellSize, CellCoord.Y * GridCellSize };
+			FVector const CellPointClosestToPoint{
+				FMath::Clamp(Point.X, CellCornerCoord.X, CellCornerCoord.X + GridCellSize),
+				FMath::Clamp(Point.Y, CellCornerCoord.Y, CellCornerCoord.Y + GridCellSize),
+				NavGridLayer.GetCellHeight(CellCoord)
+			};
+			double const SqDistToCell = FVector::DistSquared(Point, CellPointClosestToPoint);
+			if (SqDistToCell < SqDistToClosestLocation)
 			{
-				continue;
+				SqDistToClosestLocation = SqDistToCell;
+				ClosestLocation = CellPointClosestToPoint;
+				ClosestLocationGridCoord = CellCoord;
 			}
-			FIntRect const ClippedGridRect = NavGridLayer->ClipWithGridRect(QueryGridRect);
-			for (int32 X = ClippedGridRect.Min.X; X < ClippedGridRect.Max.X; ++X)
+		};
+	auto VisitColumn = [&](int32 const X, int32 const MinY, int32 const MaxY)
+		{
+			if (X < QueryGridRect.Min.X || X >= QueryGridRect.Max.X)
+			{
+				return;
+			}
+			int32 const ClippedMaxY = FMath::Min(MaxY, QueryGridRect.Max.Y - 1);
+			for (int32 Y = FMath::Max(MinY, QueryGridRect.Min.Y); Y <= ClippedMaxY;)
 			{
-				for (int32 Y = ClippedGridRect.Min.Y; Y < ClippedGridRect.Max.Y; ++Y)
+				FIntPoint const TileCoord = GetTileCoord(FIntPoint{ X, Y });
+				int32 const SegmentMaxY = FMath::Min(ClippedMaxY, (TileCoord.Y + 1) * TileSize.Y - 1);
+				if (FCBNavGridLayer const * const NavGridLayer = FindTileNavigationData(TileCoord))
 				{
-					FIntPoint const CellCoord{ X, Y };
-					if (NavGridLayer->IsCellOccupied(CellCoord))
-					{
-						continue;
-					}
-
-					FVector2d const CellCornerCoord{ CellCoord.X * GridCellSize, CellCoord.Y * GridCellSize };
-					FVector const CellPointClosestToPoint{
-						FMath::Clamp(Point.X, CellCornerCoord.X, CellCornerCoord.X + GridCellSize),
-						FMath::Clamp(Point.Y, CellCornerCoord.Y, CellCornerCoord.Y + GridCellSize),
-						NavGridLayer->GetCellHeight(CellCoord)
-					};
-					double const SqDistToCell = FVector::DistSquared(Point, CellPointClosestToPoint);
-					if (SqDistToCell < SqDistToClosestLocation)
-					{
-						SqDistToClosestLocation = SqDistToCell;
-						ClosestLocation = CellPointClosestToPoint;
-						ClosestLocationGridCoord = CellCoord;
-					}
+					NavGridLayer->ForEachFreeCellInColumn(X, Y, SegmentMaxY, [&VisitFreeCell, NavGridLayer, X](int32 const FreeY)
+						{
+							VisitFreeCell(*NavGridLayer, FIntPoint{ X, FreeY });
+						}, BlockingPlanesMask, MinClearance);
 				}
+				Y = SegmentMaxY + 1;
 			}
+		};
+
+	// Cells are visited in square rings around the cell containing the point. Cells of ring R are at least R - 1 cells
+	// away from the point horizontally, so search stops at the first ring which can't contain closer cell.
+	FIntPoint const CenterGridCoord = CBGridUtilities::GetGridCellCoord(static_cast<FVector2d>(Point), GridCellSize);
+	int32 const MaxRing = FMath::Max(
+		FMath::Max(CenterGridCoord.X - QueryGridRect.Min.X, QueryGridRect.Max.X - 1 - CenterGridCoord.X),
+		FMath::Max(CenterGridCoord.Y - QueryGridRect.Min.Y, QueryGridRect.Max.Y - 1 - CenterGridCoord.Y));
+	for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+	{
+		double const RingDist = FMath::Max(Ring - 1, 0) * static_cast<double>(GridCellSize);
+		if (RingDist * RingDist >= SqDistToClosestLocation)
+		{
+			break;
+		}
+
+		int32 const MinY = CenterGridCoord.Y - Ring;
+		int32 const MaxY = CenterGridCoord.Y + Ring;
+		VisitColumn(CenterGridCoord.X - Ring, MinY, MaxY);
+		if (Ring == 0)
+		{
+			continue;
+		}
+		VisitColumn(CenterGridCoord.X + Ring, MinY, MaxY);
+		int32 const MaxX = FMath::Min(CenterGridCoord.X + Ring - 1, QueryGridRect.Max.X - 1);
+		for (int32 X = FMath::Max(CenterGridCoord.X - Ring + 1, QueryGridRect.Min.X); X <= MaxX; ++X)
+		{
+			VisitColumn(X, MinY, MinY);
+			VisitColumn(X, MaxY, MaxY);
 		}
 	}
+
 	if (SqDistToClosestLocation < TNumericLimits<double>::Max() && QueryBoundingBox.IsInsideOrOn(ClosestLocation))
 	{
 		if (OutLocation)
@@ -798,28 +1247,81 @@ bool ACBNavGrid::ProjectPoint(FVector const & Point, FVector const & Extent, FVe
 
 ENavigationQueryResult::Type ACBNavGrid::FindPath(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord, FCBNavGridAStarFilter const & Filter, TArray<FIntPoint> & OutPath) const
 {
-	FGraphAStar<FCBNavGridToGraphAdapter, FGraphAStarDefaultPolicy, FCBNavGridAStarNode> AStar{ FCBNavGridToGraphAdapter{ *this } };
-	EGraphAStarResult const AStarResult = AStar.FindPath(StartGridCoord, EndGridCoord, Filter, OutPath);
-	if (AStarResult == EGraphAStarResult::SearchFail)
+	FCBNavGridReadScope const ReadScope{ *this };
+	if (!Filter.WantsPartialSolution() && AreInDifferentIslands(StartGridCoord, EndGridCoord))
 	{
-		return ENavigationQueryResult::Error;
+		return ENavigationQueryResult::Fail;
 	}
-	if (AStarResult == EGraphAStarResult::SearchSuccess && OutPath.IsEmpty())
+
+	FCBNavGridAStar AStar{ *this };
+	ECBNavGridAStarResult const AStarResult = AStar.FindPath(StartGridCoord, EndGridCoord, Filter, OutPath);
+	return ToNavigationQueryResult(AStarResult, StartGridCoord, OutPath);
+}
+
+ENavigationQueryResult::Type ACBNavGrid::FindPathToNearest(FIntPoint const StartGridCoord, TConstArrayView<FIntPoint> const EndGridCoords, FCBNavGridAStarFilter const & Filter, TArray<FIntPoint> & OutPath, int32 & OutEndIndex) const
+{
+	FCBNavGridReadScope const ReadScope{ *this };
+	OutEndIndex = INDEX_NONE;
+
+	// End cells in other islands can't be reached, so they are dropped before search.
+	TArray<FIntPoint> ReachableEndGridCoords;
+	TArray<int32> ReachableEndIndices;
+	for (int32 EndIndex = 0; EndIndex < EndGridCoords.Num(); ++EndIndex)
 	{
-		OutPath.Add(StartGridCoord);
+		if (Filter.WantsPartialSolution() || !AreInDifferentIslands(StartGridCoord, EndGridCoords[EndIndex]))
+		{
+			ReachableEndGridCoords.Add(EndGridCoords[EndIndex]);
+			ReachableEndIndices.Add(EndIndex);
+		}
 	}
-	if (OutPath.IsEmpty())
+	if (ReachableEndGridCoords.IsEmpty())
 	{
 		return ENavigationQueryResult::Fail;
 	}
-	return ENavigationQueryResult::Success;
+
+	FCBNavGridAStar AStar{ *this };
+	int32 ReachableEndIndex;
+	ECBNavGridAStarResult const AStarResult = AStar.FindPathToNearest(StartGridCoord, ReachableEndGridCoords, Filter, OutPath, ReachableEndIndex);
+	if (ReachableEndIndex != INDEX_NONE)
+	{
+		OutEndIndex = ReachableEndIndices[ReachableEndIndex];
+	}
+	return ToNavigationQueryResult(AStarResult, StartGridCoord, OutPath);
+}
+
+ENavigationQueryResult::Type ACBNavGrid::FindHierarchicalPath(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord, FCBNavGridAStarFilter const & Filter, TArray<FIntPoint> & OutPath) const
+{
+	FCBNavGridReadScope const ReadScope{ *this };
+	if (GetTileCoord(StartGridCoord) == GetTileCoord(EndGridCoord) || Filter.GetBlockingPlanesMask() != 0 || Filter.HasAreaCosts() || Filter.GetAgentRadius() > 0.f)
+	{
+		return FindPath(StartGridCoord, EndGridCoord, Filter, OutPath);
+	}
+	if (AreInDifferentIslands(StartGridCoord, EndGridCoord))
+	{
+		return Filter.WantsPartialSolution() ? FindPath(StartGridCoord, EndGridCoord, Filter, OutPath) : ENavigationQueryResult::Fail;
+	}
+
+	ECBNavGridAStarResult const AStarResult = AbstractGraph->FindPath(StartGridCoord, EndGridCoord, Filter, OutPath);
+	// Abstract graph knows nothing about cells closest to unreachable goal, partial path is left to grid search.
+	if (AStarResult == ECBNavGridAStarResult::GoalUnreachable && Filter.WantsPartialSolution())
+	{
+		return FindPath(StartGridCoord, EndGridCoord, Filter, OutPath);
+	}
+	return ToNavigationQueryResult(AStarResult, StartGridCoord, OutPath);
+}
+
+FIntRect ACBNavGrid::GetBoundingGridRect() const
+{
+	FCBNavGridReadScope const ReadScope{ *this };
+	return BoundingGridRect;
 }
 
 bool ACBNavGrid::GetHeight(FVector2d const & Location, float & OutHeight) const
 {
+	FCBNavGridReadScope const ReadScope{ *this };
 	FIntPoint const GridCoord = CBGridUtilities::GetGridCellCoord(Location, GridCellSize);
 	FIntPoint const TileCoord = CBGridUtilities::GetTileCoord(GridCoord, TileSize);
-	if (FCBNavGridLayer const * const NavGridLayer = GetTileNavigationData(TileCoord).Get())
+	if (FCBNavGridLayer const * const NavGridLayer = FindTileNavigationData(TileCoord))
 	{
 		float const Height = NavGridLayer->GetCellHeight(GridCoord);
 		if (!FMath::IsNaN(Height))
@@ -839,13 +1341,15 @@ FIntPoint ACBNavGrid::GetTileCoord(FIntPoint const GridCoord) const
 
 TSharedPtr<FCBNavGridLayer const> ACBNavGrid::GetTileNavigationData(FIntPoint const TileCoord) const
 {
-	FTileData const * const TileData = Tiles.Find(TileCoord);
+	FCBNavGridReadScope const ReadScope{ *this };
+	FTileData const * const TileData = FindTileData(TileCoord);
 	return TileData ? TileData->NavigationData : nullptr;
 }
 
 TSharedPtr<FCBHeightfield const> ACBNavGrid::GetTileHeightfield(FIntPoint const TileCoord) const
 {
-	FTileData const * const TileData = Tiles.Find(TileCoord);
+	FCBNavGridReadScope const ReadScope{ *this };
+	FTileData const * const TileData = FindTileData(TileCoord);
 	return TileData ? TileData->Heightfield : nullptr;
 }
 
@@ -857,58 +1361,584 @@ void ACBNavGrid::OnTileGenerationCompleted(FIntPoint const TileCoord, TUniquePtr
 	}
 
 	InvalidateAffectedPaths(TileCoord);
+	InvalidateAffectedFlowFields(TileCoord);
 
 	if (!GeneratedNavGridLayer.IsValid())
 	{
-		FTileData TileData;
-		if (Tiles.RemoveAndCopyValue(TileCoord, TileData) && IsValidRect(BoundingGridRect))
 		{
-			check(TileData.NavigationData);
-			FIntRect const & TileBoundingRect = TileData.NavigationData->GetGridRect();
-			// If removed tile bounding rect touches grid bounds, grid bounding rect cache should be recalculated.
-			if (HaveCommonBorder(BoundingGridRect, TileBoundingRect))
+			FRWScopeLock const TilesScopeLock{ TilesLock, SLT_Write };
+			FTileData TileData;
+			if (RemoveTileData(TileCoord, TileData))
 			{
-				InvalidateRect(BoundingGridRect);
+				check(TileData.NavigationData);
+				FIntRect const & TileBoundingRect = TileData.NavigationData->GetGridRect();
+				// If removed tile bounding rect touches grid bounds, grid bounding rect should be recalculated.
+				if (HaveCommonBorder(BoundingGridRect, TileBoundingRect))
+				{
+					BoundingGridRect = CalculateBoundingGridRect();
+				}
 			}
 		}
+		if (MaxClearance > 0)
+		{
+			UpdateClearancesAround(TileCoord);
+		}
+		AbstractGraph->OnTileChanged(TileCoord);
+		Islands->OnTileChanged(TileCoord);
+		TileChangedDelegate.Broadcast(TileCoord);
 		return;
 	}
 
-	if (IsValidRect(BoundingGridRect))
+	// Generated layer isn't shared with anything yet, so it is set up before it is published.
+	FCBNavGridLayer & NavGridLayer = const_cast<FCBNavGridLayer &>(*GeneratedNavGridLayer);
+	FCBNavGridLayer const * const PreviousNavGridLayer = FindTileNavigationData(TileCoord);
+	if (PreviousNavGridLayer && PreviousNavGridLayer->HasOverlayCells())
+	{
+		// Occupied cells sums ignore overlay, so only free cell counts are recalculated.
+		NavGridLayer.CopyOverlay(*PreviousNavGridLayer);
+		NavGridLayer.UpdateFreeCellCounts();
+		if (MaxClearance > 0)
+		{
+			// Generator doesn't see overlay, so clearances of the whole tile are rebuilt with it.
+			TArray<FCBNavGridLayer const *, TInlineAllocator<8>> NeighbourLayers;
+			FindNeighbourLayers(TileCoord, NavGridLayer.GetGridRect(), MaxClearance, TileSize, [this](FIntPoint const NeighbourTileCoord)
+				{
+					return FindTileNavigationData(NeighbourTileCoord);
+				}, NeighbourLayers);
+			NavGridLayer.UpdateClearances(NavGridLayer.GetGridRect(), NeighbourLayers, MaxClearance);
+		}
+	}
+	NavGridLayer.SetBlockingPlanesNum(GetBlockingPlanesNum());
+
 	{
+		FRWScopeLock const TilesScopeLock{ TilesLock, SLT_Write };
 		if (Tiles.IsEmpty())
 		{
-			BoundingGridRect = GeneratedNavGridLayer->GetGridRect();
+			BoundingGridRect = NavGridLayer.GetGridRect();
 		}
 		else
 		{
-			BoundingGridRect.Union(GeneratedNavGridLayer->GetGridRect());
+			BoundingGridRect.Union(NavGridLayer.GetGridRect());
+		}
+
+		FTileData & TileData = FindOrAddTileData(TileCoord);
+		TileData.NavigationData = MakeShareable(const_cast<FCBNavGridLayer *>(GeneratedNavGridLayer.Release()));
+		if (GeneratedHeightfield.IsValid())
+		{
+			TileData.Heightfield = MakeShareable(GeneratedHeightfield.Release());
 		}
 	}
 
-	FTileData & TileData = Tiles.FindOrAdd(TileCoord);
-	TileData.NavigationData = MakeShareable(GeneratedNavGridLayer.Release());
+	if (MaxClearance > 0)
+	{
+		UpdateClearancesAround(TileCoord);
+	}
 
-	if (GeneratedHeightfield.IsValid())
+	AbstractGraph->OnTileChanged(TileCoord);
+	Islands->OnTileChanged(TileCoord);
+	TileChangedDelegate.Broadcast(TileCoord);
+	RequestDrawingUpdate();
+}
+
+void ACBNavGrid::UpdateIslands()
+{
+	Islands->Rebuild();
+}
+
+bool ACBNavGrid::AreInDifferentIslands(FIntPoint const GridCoord1, FIntPoint const GridCoord2) const
+{
+	return Islands->AreInDifferentIslands(GridCoord1, GridCoord2);
+}
+
+int64 ACBNavGrid::CountOccupiedCells(FIntRect const & GridRect) const
+{
+	FCBNavGridReadScope const ReadScope{ *this };
+	if (GridRect.Width() <= 0 || GridRect.Height() <= 0)
+	{
+		return 0;
+	}
+
+	int64 OccupiedCellsNum = 0;
+	FIntRect const TileRect = CBGridUtilities::GetTileRect(GridRect, TileSize);
+	for (int32 TileX = TileRect.Min.X; TileX < TileRect.Max.X; ++TileX)
+	{
+		for (int32 TileY = TileRect.Min.Y; TileY < TileRect.Max.Y; ++TileY)
+		{
+			FIntPoint const TileCoord{ TileX, TileY };
+			FIntRect TileGridRect{ TileCoord * TileSize, (TileCoord + FIntPoint{ 1, 1 }) * TileSize };
+			TileGridRect.Clip(GridRect);
+			FCBNavGridLayer const * const Tile = FindTileNavigationData(TileCoord);
+			OccupiedCellsNum += Tile ? Tile->CountOccupiedCells(TileGridRect) : TileGridRect.Area();
+		}
+	}
+	return OccupiedCellsNum;
+}
+
+void ACBNavGrid::FindValidFootprintPositions(FIntRect const & CandidateRect, FIntPoint const FootprintSize, TBitArray<> & OutValidPositions) const
+{
+	::FindValidFootprintPositions(*this, CandidateRect, FootprintSize, [FootprintSize](FCBNavGridErosion & Erosion)
+		{
+			Erosion.ErodeByRect(FootprintSize);
+		}, OutValidPositions);
+}
+
+void ACBNavGrid::FindValidFootprintPositions(FIntRect const & CandidateRect, FIntPoint const FootprintSize, TBitArray<> const & FootprintMask, TBitArray<> & OutValidPositions) const
+{
+	if (FootprintMask.Num() != FootprintSize.X * FootprintSize.Y)
 	{
-		TileData.Heightfield = MakeShareable(GeneratedHeightfield.Release());
+		OutValidPositions.Reset();
+		return;
 	}
+	::FindValidFootprintPositions(*this, CandidateRect, FootprintSize, [FootprintSize, &FootprintMask](FCBNavGridErosion & Erosion)
+		{
+			Erosion.ErodeByMask(FootprintSize, FootprintMask);
+		}, OutValidPositions);
+}
 
+template <typename TStamp>
+void ACBNavGrid::StampOverlay(FIntRect const & GridRect, int32 const PlaneIndex, TStamp && Stamp)
+{
+	if (GridRect.Width() <= 0 || GridRect.Height() <= 0 || (PlaneIndex != INDEX_NONE && (PlaneIndex < 0 || PlaneIndex >= GetBlockingPlanesNum())))
+	{
+		return;
+	}
+
+	TArray<FIntPoint, TInlineAllocator<4>> StampedTileCoords;
+	FIntRect const TileRect = CBGridUtilities::GetTileRect(GridRect, TileSize);
+	for (int32 TileX = TileRect.Min.X; TileX < TileRect.Max.X; ++TileX)
+	{
+		for (int32 TileY = TileRect.Min.Y; TileY < TileRect.Max.Y; ++TileY)
+		{
+			FIntPoint const TileCoord{ TileX, TileY };
+			FTileData * const TileData = FindTileData(TileCoord);
+			if (!TileData || PlaneIndex >= TileData->NavigationData->GetBlockingPlanesNum())
+			{
+				continue;
+			}
+
+			FRWScopeLock const TilesScopeLock{ TilesLock, SLT_Write };
+			Stamp(*TileData->NavigationData);
+			if (PlaneIndex == INDEX_NONE)
+			{
+				// Occupied cells sums cover generated occupancy only, so only counts of stamped words are updated.
+				TileData->NavigationData->UpdateFreeCellCounts(GridRect);
+				InvalidateRandomPointIndex();
+			}
+			StampedTileCoords.Add(TileCoord);
+		}
+	}
+	if (StampedTileCoords.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<FIntPoint, TInlineAllocator<9>> AffectedTileCoords{ StampedTileCoords };
+	if (PlaneIndex == INDEX_NONE && MaxClearance > 0)
+	{
+		// Stamped cells change clearances of cells up to MaxClearance away, which may be in neighbour tiles.
+		FIntRect const ClearanceGridRect{ GridRect.Min - FIntPoint{ MaxClearance, MaxClearance }, GridRect.Max + FIntPoint{ MaxClearance, MaxClearance } };
+		FIntRect const ClearanceTileRect = CBGridUtilities::GetTileRect(ClearanceGridRect, TileSize);
+		for (int32 TileX = ClearanceTileRect.Min.X; TileX < ClearanceTileRect.Max.X; ++TileX)
+		{
+			for (int32 TileY = ClearanceTileRect.Min.Y; TileY < ClearanceTileRect.Max.Y; ++TileY)
+			{
+				FIntPoint const TileCoord{ TileX, TileY };
+				if (FindTileData(TileCoord))
+				{
+					UpdateTileClearances(TileCoord, { ClearanceGridRect });
+					AffectedTileCoords.AddUnique(TileCoord);
+				}
+			}
+		}
+	}
+
+	for (FIntPoint const TileCoord : AffectedTileCoords)
+	{
+		InvalidateAffectedPaths(TileCoord);
+	}
+	// Blocking planes are seen only by filtered queries, other tile data ignores them.
+	if (PlaneIndex == INDEX_NONE)
+	{
+		for (FIntPoint const TileCoord : StampedTileCoords)
+		{
+			InvalidateAffectedFlowFields(TileCoord);
+			AbstractGraph->OnTileCellsChanged(TileCoord, GridRect);
+			TileChangedDelegate.Broadcast(TileCoord);
+		}
+	}
 	RequestDrawingUpdate();
 }
 
+void ACBNavGrid::UpdateTilesBlockingPlanesNum()
+{
+	int32 const BlockingPlanesNum = GetBlockingPlanesNum();
+	TArray<FIntPoint> ChangedTileCoords;
+	{
+		FRWScopeLock const TilesScopeLock{ TilesLock, SLT_Write };
+		for (FTileData & TileData : Tiles)
+		{
+			if (TileData.NavigationData->GetBlockingPlanesNum() != BlockingPlanesNum)
+			{
+				TileData.NavigationData->SetBlockingPlanesNum(BlockingPlanesNum);
+				ChangedTileCoords.Add(TileData.Coord);
+			}
+		}
+	}
+	for (FIntPoint const TileCoord : ChangedTileCoords)
+	{
+		InvalidateAffectedPaths(TileCoord);
+	}
+}
+
+void ACBNavGrid::UpdateTileClearances(FIntPoint const TileCoord, TConstArrayView<FIntRect> const GridRects)
+{
+	FTileData * const TileData = FindTileData(TileCoord);
+	if (!TileData || GridRects.IsEmpty())
+	{
+		return;
+	}
+
+	FIntRect BoundingGridRect = GridRects[0];
+	for (FIntRect const & GridRect : GridRects)
+	{
+		BoundingGridRect.Union(GridRect);
+	}
+	TArray<FCBNavGridLayer const *, TInlineAllocator<8>> NeighbourLayers;
+	FindNeighbourLayers(TileCoord, BoundingGridRect, MaxClearance, TileSize, [this](FIntPoint const NeighbourTileCoord)
+		{
+			return FindTileNavigationData(NeighbourTileCoord);
+		}, NeighbourLayers);
+
+	FRWScopeLock const TilesScopeLock{ TilesLock, SLT_Write };
+	for (FIntRect const & GridRect : GridRects)
+	{
+		TileData->NavigationData->UpdateClearances(GridRect, NeighbourLayers, MaxClearance);
+	}
+}
+
+void ACBNavGrid::UpdateClearancesAround(FIntPoint const TileCoord)
+{
+	FIntRect const TileGridRect{ TileCoord * TileSize, (TileCoord + FIntPoint{ 1, 1 }) * TileSize };
+	int32 const Band = MaxClearance;
+	if (FindTileData(TileCoord))
+	{
+		if (2 * Band >= FMath::Min(TileSize.X, TileSize.Y))
+		{
+			UpdateTileClearances(TileCoord, { TileGridRect });
+		}
+		else
+		{
+			UpdateTileClearances(TileCoord, {
+				FIntRect{ TileGridRect.Min, FIntPoint{ TileGridRect.Min.X + Band, TileGridRect.Max.Y } },
+				FIntRect{ FIntPoint{ TileGridRect.Max.X - Band, TileGridRect.Min.Y }, TileGridRect.Max },
+				FIntRect{ FIntPoint{ TileGridRect.Min.X + Band, TileGridRect.Min.Y }, FIntPoint{ TileGridRect.Max.X - Band, TileGridRect.Min.Y + Band } },
+				FIntRect{ FIntPoint{ TileGridRect.Min.X + Band, TileGridRect.Max.Y - Band }, FIntPoint{ TileGridRect.Max.X - Band, TileGridRect.Max.Y } } });
+		}
+	}
+
+	FIntRect const AffectedGridRect{ TileGridRect.Min - FIntPoint{ Band, Band }, TileGridRect.Max + FIntPoint{ Band, Band } };
+	FIntRect const AffectedTileRect = CBGridUtilities::GetTileRect(AffectedGridRect, TileSize);
+	for (int32 TileX = AffectedTileRect.Min.X; TileX < AffectedTileRect.Max.X; ++TileX)
+	{
+		for (int32 TileY = AffectedTileRect.Min.Y; TileY < AffectedTileRect.Max.Y; ++TileY)
+		{
+			FIntPoint const NeighbourTileCoord{ TileX, TileY };
+			if (NeighbourTileCoord != TileCoord)
+			{
+				UpdateTileClearances(NeighbourTileCoord, { AffectedGridRect });
+			}
+		}
+	}
+}
+
+void ACBNavGrid::SetOverlayCellsState(FIntRect const & GridRect, bool const bIsOccupied, int32 const PlaneIndex)
+{
+	StampOverlay(GridRect, PlaneIndex, [&GridRect, bIsOccupied, PlaneIndex](FCBNavGridLayer & NavGridLayer)
+		{
+			NavGridLayer.SetOverlayCellsState(GridRect, bIsOccupied, PlaneIndex);
+		});
+}
+
+void ACBNavGrid::SetOverlayCellsStateInBox(FBox2d const & Box, bool const bIsOccupied, int32 const PlaneIndex)
+{
+	SetOverlayCellsState(CBGridUtilities::GetGridRectFromBoundingBox2d(Box, GridCellSize), bIsOccupied, PlaneIndex);
+}
+
+void ACBNavGrid::SetOverlayCellsStateInCircle(FVector2d const CircleOrigin, double const Radius, bool const bIsOccupied, int32 const PlaneIndex)
+{
+	FIntRect const GridRect = CBGridUtilities::GetGridRectFromBoundingBox2d(FBox2d{ CircleOrigin - Radius, CircleOrigin + Radius }, GridCellSize);
+	StampOverlay(GridRect, PlaneIndex, [CircleOrigin, Radius, bIsOccupied, PlaneIndex](FCBNavGridLayer & NavGridLayer)
+		{
+			NavGridLayer.SetOverlayCellsStateInCircle(CircleOrigin, Radius, bIsOccupied, PlaneIndex);
+		});
+}
+
+void ACBNavGrid::SetOverlayCellsStateInConvex(TArray<FVector2d> const & CCWConvex, bool const bIsOccupied, int32 const PlaneIndex)
+{
+	if (CCWConvex.Num() < 3)
+	{
+		return;
+	}
+
+	FIntRect const GridRect = CBGridUtilities::GetGridRectFromBoundingBox2d(FBox2d{ CCWConvex }, GridCellSize);
+	StampOverlay(GridRect, PlaneIndex, [&CCWConvex, bIsOccupied, PlaneIndex](FCBNavGridLayer & NavGridLayer)
+		{
+			NavGridLayer.SetOverlayCellsStateInConvex(CCWConvex, bIsOccupied, PlaneIndex);
+		});
+}
+
+int32 ACBNavGrid::FindBlockingPlaneIndex(FName const PlaneName) const
+{
+	int32 const PlaneIndex = BlockingPlaneNames.IndexOfByKey(PlaneName);
+	return PlaneIndex < GetBlockingPlanesNum() ? PlaneIndex : INDEX_NONE;
+}
+
+uint32 ACBNavGrid::GetBlockingPlanesMask(TConstArrayView<FName> const PlaneNames) const
+{
+	uint32 BlockingPlanesMask = 0;
+	for (FName const PlaneName : PlaneNames)
+	{
+		int32 const PlaneIndex = FindBlockingPlaneIndex(PlaneName);
+		if (PlaneIndex != INDEX_NONE)
+		{
+			BlockingPlanesMask |= 1u << PlaneIndex;
+		}
+	}
+	return BlockingPlanesMask;
+}
+
+int32 ACBNavGrid::GetBlockingPlanesNum() const
+{
+	return FMath::Min(BlockingPlaneNames.Num(), FCBNavGridLayer::MaxBlockingPlanesNum);
+}
+
+uint8 ACBNavGrid::GetRequiredClearance(float const AgentRadius) const
+{
+	if (AgentRadius <= 0.f || MaxClearance == 0)
+	{
+		return 0;
+	}
+	// Agent centered in cell fits it if the nearest occupied cell center is at least radius plus half of cell away.
+	int32 const RequiredClearance = FMath::CeilToInt(AgentRadius / GridCellSize + 0.5f);
+	if (RequiredClearance <= 1)
+	{
+		return 0;
+	}
+	if (RequiredClearance > MaxClearance)
+	{
+		if (!bHasWarnedAboutTooBigAgent.exchange(true, std::memory_order_relaxed))
+		{
+			UE_LOGFMT(LogNavigation, Warning, "Agent radius {0} needs clearance of {1} cells, which exceeds max clearance {2} of {3}, agent fits nowhere.", AgentRadius, RequiredClearance, MaxClearance, GetName());
+		}
+		return FCBNavGridLayer::NoFitClearance;
+	}
+	return static_cast<uint8>(RequiredClearance);
+}
+
+TSharedPtr<FCBNavGridFlowField const> ACBNavGrid::FindOrBuildFlowField(FIntPoint const GoalGridCoord, FIntRect const & GridRect) const
+{
+	FCBNavGridReadScope const ReadScope{ *this };
+	FIntRect ClippedGridRect = GetBoundingGridRect();
+	ClippedGridRect.Clip(GridRect);
+	FCBNavGridLayer const * const GoalTile = FindTileNavigationData(GetTileCoord(GoalGridCoord));
+	if (!GoalTile || GoalTile->IsCellOccupied(GoalGridCoord) || !ClippedGridRect.Contains(GoalGridCoord))
+	{
+		return nullptr;
+	}
+
+	// Moves cached field to the most recently used end, expects the lock to be held.
+	auto FindCachedFlowField = [this, GoalGridCoord, &ClippedGridRect]() -> TSharedPtr<FCBNavGridFlowField const>
+		{
+			int32 const FlowFieldIndex = FlowFields.IndexOfByPredicate([GoalGridCoord, &ClippedGridRect](TSharedPtr<FCBNavGridFlowField const> const & FlowField)
+				{
+					return FlowField->GetGoalGridCoord() == GoalGridCoord && FlowField->GetGridRect() == ClippedGridRect;
+				});
+			if (FlowFieldIndex == INDEX_NONE)
+			{
+				return nullptr;
+			}
+			TSharedPtr<FCBNavGridFlowField const> FlowField = FlowFields[FlowFieldIndex];
+			FlowFields.RemoveAt(FlowFieldIndex, EAllowShrinking::No);
+			FlowFields.Add(FlowField);
+			return FlowField;
+		};
+
+	uint32 BuildFlowFieldsGeneration;
+	{
+		UE::TScopeLock FlowFieldsScopeLock(FlowFieldsLock);
+		if (TSharedPtr<FCBNavGridFlowField const> FlowField = FindCachedFlowField())
+		{
+			return FlowField;
+		}
+		BuildFlowFieldsGeneration = FlowFieldsGeneration;
+	}
+
+	// Field is built out of the lock, so builds of different goals don't wait for each other.
+	TSharedPtr<FCBNavGridFlowField const> FlowField = MakeShared<FCBNavGridFlowField>(*this, GoalGridCoord, ClippedGridRect);
+
+	UE::TScopeLock FlowFieldsScopeLock(FlowFieldsLock);
+	if (TSharedPtr<FCBNavGridFlowField const> CachedFlowField = FindCachedFlowField())
+	{
+		// The same field was built concurrently.
+		return CachedFlowField;
+	}
+	// Field built while any tile changed may be stale, so it is returned, but not cached.
+	if (BuildFlowFieldsGeneration == FlowFieldsGeneration)
+	{
+		if (FlowFields.Num() >= MaxCachedFlowFieldsNum)
+		{
+			FlowFields.RemoveAt(0, EAllowShrinking::No);
+		}
+		FlowFields.Add(FlowField);
+	}
+	return FlowField;
+}
+
+bool ACBNavGrid::FindNearestFootprintPosition(FIntPoint const OriginGridCoord, FIntPoint const FootprintSize, float const MaxHeightDifference, FIntPoint & OutPosition) const
+{
+	FCBNavGridReadScope const ReadScope{ *this };
+	if (FootprintSize.X <= 0 || FootprintSize.Y <= 0 || Tiles.IsEmpty())
+	{
+		return false;
+	}
+
+	auto IsFootprintHeightCompatible = [this, FootprintSize, MaxHeightDifference](FIntPoint const Position)
+		{
+			float MinHeight = TNumericLimits<float>::Max();
+			float MaxHeight = TNumericLimits<float>::Lowest();
+			for (int32 X = Position.X; X < Position.X + FootprintSize.X; ++X)
+			{
+				for (int32 Y = Position.Y; Y < Position.Y + FootprintSize.Y; ++Y)
+				{
+					FIntPoint const CellCoord{ X, Y };
+					float const Height = FindTileNavigationData(GetTileCoord(CellCoord))->GetCellHeight(CellCoord);
+					MinHeight = FMath::Min(MinHeight, Height);
+					MaxHeight = FMath::Max(MaxHeight, Height);
+					if (MaxHeight - MinHeight > MaxHeightDifference)
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		};
+
+	bool const bCheckHeights = MaxHeightDifference >= 0.f;
+	int64 BestDistSquared = TNumericLimits<int64>::Max();
+	TArray<TPair<int64, FIntPoint>> Candidates;
+	auto SearchTile = [&](FIntPoint const TileCoord)
+		{
+			FCBNavGridLayer const * const Tile = FindTileNavigationData(TileCoord);
+			if (!Tile || Tile->GetFreeCellsNum() == 0)
+			{
+				return;
+			}
+
+			// Footprints with min corner in the tile may stick out of it, so erosion covers them entirely.
+			FIntRect const TileGridRect{ TileCoord * TileSize, (TileCoord + FIntPoint{ 1, 1 }) * TileSize };
+			FCBNavGridErosion Erosion{ FIntRect{ TileGridRect.Min, TileGridRect.Max + FootprintSize - FIntPoint{ 1, 1 } } };
+			Erosion.AddFreeCells(*this);
+			Erosion.ErodeByRect(FootprintSize);
+			Candidates.Reset();
+			for (int32 X = TileGridRect.Min.X; X < TileGridRect.Max.X; ++X)
+			{
+				for (int32 Y = TileGridRect.Min.Y; Y < TileGridRect.Max.Y; ++Y)
+				{
+					FIntPoint const Position{ X, Y };
+					if (!Erosion.IsCellFree(Position))
+					{
+						continue;
+					}
+					int64 const DistSquared = FMath::Square(static_cast<int64>(X - OriginGridCoord.X)) + FMath::Square(static_cast<int64>(Y - OriginGridCoord.Y));
+					if (DistSquared >= BestDistSquared)
+					{
+						continue;
+					}
+					if (bCheckHeights)
+					{
+						Candidates.Emplace(DistSquared, Position);
+					}
+					else
+					{
+						BestDistSquared = DistSquared;
+						OutPosition = Position;
+					}
+				}
+			}
+
+			// Heights are checked in order of distance, so the first compatible candidate is the closest one.
+			Candidates.Sort([](TPair<int64, FIntPoint> const & A, TPair<int64, FIntPoint> const & B)
+				{
+					return A.Key < B.Key;
+				});
+			for (TPair<int64, FIntPoint> const & Candidate : Candidates)
+			{
+				if (IsFootprintHeightCompatible(Candidate.Value))
+				{
+					BestDistSquared = Candidate.Key;
+					OutPosition = Candidate.Value;
+					break;
+				}
+			}
+		};
+
+	// Positions in tiles of ring R are at least (R - 1) * TileSize + 1 cells away from origin along one of axes, so
+	// search stops at the first ring which can't contain closer position.
+	FIntPoint const OriginTileCoord = GetTileCoord(OriginGridCoord);
+	FIntRect const TileRect = CBGridUtilities::GetTileRect(GetBoundingGridRect(), TileSize);
+	int32 const MaxRing = FMath::Max(
+		FMath::Max(OriginTileCoord.X - TileRect.Min.X, TileRect.Max.X - 1 - OriginTileCoord.X),
+		FMath::Max(OriginTileCoord.Y - TileRect.Min.Y, TileRect.Max.Y - 1 - OriginTileCoord.Y));
+	int32 const MinTileSize = FMath::Min(TileSize.X, TileSize.Y);
+	for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+	{
+		if (Ring > 0 && FMath::Square(static_cast<int64>(Ring - 1) * MinTileSize + 1) >= BestDistSquared)
+		{
+			break;
+		}
+
+		for (int32 TileX = OriginTileCoord.X - Ring; TileX <= OriginTileCoord.X + Ring; ++TileX)
+		{
+			bool const bIsRingSide = TileX == OriginTileCoord.X - Ring || TileX == OriginTileCoord.X + Ring;
+			int32 const TileYStep = bIsRingSide ? 1 : FMath::Max(2 * Ring, 1);
+			for (int32 TileY = OriginTileCoord.Y - Ring; TileY <= OriginTileCoord.Y + Ring; TileY += TileYStep)
+			{
+				SearchTile(FIntPoint{ TileX, TileY });
+			}
+		}
+	}
+	return BestDistSquared < TNumericLimits<int64>::Max();
+}
+
 FIntPoint ACBNavGrid::GetGridCoord(NavNodeRef const NodeRef) const
 {
-	int32 const X = static_cast<int64>(NodeRef >> 32) + INT32_MIN;
-	int32 const Y = static_cast<int64>(NodeRef & 0xffffffff) + INT32_MIN;
-	return FIntPoint{ X, Y };
+	FCBNavGridReadScope const ReadScope{ *this };
+	FTileData const * TileData;
+	uint32 CellIndex;
+	if (!DecodeNodeRef(NodeRef, TileData, CellIndex))
+	{
+		return INVALID_GRIDCOORD;
+	}
+	FIntPoint const TileOrigin{ TileData->Coord.X * TileSize.X, TileData->Coord.Y * TileSize.Y };
+	return TileOrigin + FIntPoint{ static_cast<int32>(CellIndex / TileSize.Y), static_cast<int32>(CellIndex % TileSize.Y) };
 }
 
 NavNodeRef ACBNavGrid::GetNodeRef(FIntPoint const GridCoord) const
 {
-	uint64 const XPart = static_cast<int64>(GridCoord.X) - INT32_MIN;
-	uint64 const YPart = static_cast<int64>(GridCoord.Y) - INT32_MIN;
-	return (XPart << 32) | YPart;
+	FCBNavGridReadScope const ReadScope{ *this };
+	FIntPoint const TileCoord = GetTileCoord(GridCoord);
+	int32 const TileIndex = FindTileIndex(TileCoord);
+	if (TileIndex == INDEX_NONE)
+	{
+		return INVALID_NAVNODEREF;
+	}
+	check(static_cast<uint64>(TileIndex) <= NodeRefTileIndexMask);
+	check(static_cast<uint64>(TileSize.X) * TileSize.Y <= NodeRefCellIndexMask + 1);
+
+	FIntPoint const CellCoordInTile = GridCoord - FIntPoint{ TileCoord.X * TileSize.X, TileCoord.Y * TileSize.Y };
+	uint64 const CellIndex = static_cast<uint64>(CellCoordInTile.X) * TileSize.Y + CellCoordInTile.Y;
+	uint64 const Generation = TileGenerations[TileIndex];
+	return CellIndex | (static_cast<uint64>(TileIndex) << NodeRefTileIndexShift) | (Generation << NodeRefGenerationShift);
 }
 
 FIntPoint const ACBNavGrid::INVALID_GRIDCOORD{ INT32_MIN, INT32_MIN };
@@ -917,6 +1947,16 @@ FIntPoint const ACBNavGrid::INVALID_GRIDCOORD{ INT32_MIN, INT32_MIN };
 // FPathFindingQueryData and another ANavigationData. What query data should the function use?
 // For now made to be similar to RecastNavMesh, so can have similar bugs.
 FPathFindingResult ACBNavGrid::FindPath(FNavAgentProperties const & AgentProperties, FPathFindingQuery const & Query)
+{
+	return FindPathForQuery(Query, false);
+}
+
+FPathFindingResult ACBNavGrid::FindHierarchicalPath(FNavAgentProperties const & AgentProperties, FPathFindingQuery const & Query)
+{
+	return FindPathForQuery(Query, true);
+}
+
+FPathFindingResult ACBNavGrid::FindPathForQuery(FPathFindingQuery const & Query, bool const bHierarchical)
 {
 	FPathFindingResult Result(ENavigationQueryResult::Error);
 
@@ -948,11 +1988,21 @@ FPathFindingResult ACBNavGrid::FindPath(FNavAgentProperties const & AgentPropert
 		}
 	}
 
-	Result.Result = UENavGrid->FindPath(*NavGridPath, Query);
+	Result.Result = UENavGrid->FindPath(*NavGridPath, Query, bHierarchical);
 	return Result;
 }
 
 bool ACBNavGrid::TestPath(FNavAgentProperties const & AgentProperties, FPathFindingQuery const & Query, int32 * const OutNumVisitedNodes)
+{
+	return TestPathForQuery(Query, OutNumVisitedNodes, false);
+}
+
+bool ACBNavGrid::TestHierarchicalPath(FNavAgentProperties const & AgentProperties, FPathFindingQuery const & Query, int32 * const OutNumVisitedNodes)
+{
+	return TestPathForQuery(Query, OutNumVisitedNodes, true);
+}
+
+bool ACBNavGrid::TestPathForQuery(FPathFindingQuery const & Query, int32 * const OutNumVisitedNodes, bool const bHierarchical)
 {
 	ACBNavGrid const * UENavGrid;
 	{
@@ -965,7 +2015,7 @@ bool ACBNavGrid::TestPath(FNavAgentProperties const & AgentProperties, FPathFind
 		UENavGrid = static_cast<ACBNavGrid const *>(Self);
 	}
 
-	return UENavGrid->TestPath(Query, OutNumVisitedNodes);
+	return UENavGrid->TestPath(Query, OutNumVisitedNodes, bHierarchical);
 }
 
 bool ACBNavGrid::Raycast(ANavigationData const * Self, FVector const & RayStart, FVector const & RayEnd, FVector & OutHitLocation, FNavigationRaycastAdditionalResults * OutAdditionalResults, FSharedConstNavQueryFilter QueryFilter, UObject const * Querier)
@@ -974,7 +2024,8 @@ bool ACBNavGrid::Raycast(ANavigationData const * Self, FVector const & RayStart,
 	ACBNavGrid const * UENavGrid = static_cast<ACBNavGrid const *>(Self);
 	FNavLocation HitLocation;
 	bool bIsRayEndInCorridor;
-	bool const bDidHit = UENavGrid->Raycast(RayStart, RayEnd, HitLocation, bIsRayEndInCorridor);
+	FNavigationQueryFilter const & FilterRef = UENavGrid->GetFilterRef(QueryFilter.Get());
+	bool const bDidHit = UENavGrid->Raycast(RayStart, RayEnd, HitLocation, bIsRayEndInCorridor, GetFilterBlockingPlanesMask(FilterRef), GetFilterAgentRadius(FilterRef));
 	OutHitLocation = HitLocation.Location;
 	if (OutAdditionalResults)
 	{
@@ -983,8 +2034,9 @@ bool ACBNavGrid::Raycast(ANavigationData const * Self, FVector const & RayStart,
 	return bDidHit;
 }
 
-ENavigationQueryResult::Type ACBNavGrid::FindPath(FCBNavGridPath & OutPath, FPathFindingQuery const & Query) const
+ENavigationQueryResult::Type ACBNavGrid::FindPath(FCBNavGridPath & OutPath, FPathFindingQuery const & Query, bool const bHierarchical) const
 {
+	FCBNavGridReadScope const ReadScope{ *this };
 	check(!OutPath.IsReady());
 	ENavigationQueryResult::Type Result;
 	FNavigationQueryFilter const & QueryFilter = GetFilterRef(Query.QueryFilter.Get());
@@ -999,12 +2051,15 @@ ENavigationQueryResult::Type ACBNavGrid::FindPath(FCBNavGridPath & OutPath, FPat
 	{
 		FIntPoint const StartGridCoord = CBGridUtilities::GetGridCellCoord(static_cast<FVector2d>(Query.StartLocation), GridCellSize);
 		FIntPoint const EndGridCoord = CBGridUtilities::GetGridCellCoord(static_cast<FVector2d>(AdjustedEndLocation), GridCellSize);
-		// TODO: Should be dynamic_cast, but by default unreal projects compiles without rtti, so dynamic_cast won't work. Needs some workaround.
-		FCBNavGridQueryFilter const * const NavGridQueryFilter = static_cast<FCBNavGridQueryFilter const *>(QueryFilter.GetImplementation());
-		FVector2d const AxiswiseHeuristicScale = NavGridQueryFilter ? static_cast<FVector2d>(NavGridQueryFilter->GetAxiswiseHeuristicScale()) : FVector2d{ 1., 1. };
-		FCBNavGridAStarFilter const AStarFilter{ QueryFilter.GetHeuristicScale(), AxiswiseHeuristicScale, Query.CostLimit, QueryFilter.GetMaxSearchNodes(), !!Query.bAllowPartialPaths };
+		if (OutPath.WantsAnyAngle() && HasFilterAreaCosts(QueryFilter))
+		{
+			// Any-angle search ignores area costs, such path is found over adjacent cells and postprocessed like one.
+			OutPath.SetWantsAnyAngle(false);
+		}
+		FCBNavGridAStarFilter const AStarFilter = MakeAStarFilter(QueryFilter, Query.CostLimit, !!Query.bAllowPartialPaths, OutPath.WantsAnyAngle());
 		TArray<FIntPoint> GridPath;
-		Result = FindPath(StartGridCoord, EndGridCoord, AStarFilter, GridPath);
+		// Abstract graph refines path to adjacent cells, so any-angle queries go straight to grid search.
+		Result = bHierarchical && !OutPath.WantsAnyAngle() ? FindHierarchicalPath(StartGridCoord, EndGridCoord, AStarFilter, GridPath) : FindPath(StartGridCoord, EndGridCoord, AStarFilter, GridPath);
 
 		if (Result == ENavigationQueryResult::Error)
 		{
@@ -1025,27 +2080,39 @@ void ACBNavGrid::PostprocessPath(FVector const & StartLocation, FIntPoint const
 	FIntRect & GridBoundingBox = OutPath.GetGridBoundingBox();
 	GridBoundingBox = FIntRect{ StartGridCoord, StartGridCoord };
 
-	if (OutPath.WantsStringPulling())
+	if (OutPath.WantsAnyAngle() && !GridPath.IsEmpty())
 	{
-		FVector2d PrevPointLocation2d{ StartLocation };
-		for (int32 GridCoordIndex = 1; GridCoordIndex < GridPath.Num(); ++GridCoordIndex)
+		// Consecutive cells of any-angle path see each other, so cells between start and end are corners already.
+		bool const bIsPartial = GridPath.Last() != EndGridCoord;
+		int32 const CornersEndIndex = bIsPartial ? GridPath.Num() : GridPath.Num() - 1;
+		for (int32 GridCoordIndex = 1; GridCoordIndex < CornersEndIndex; ++GridCoordIndex)
 		{
-			FVector2d const PointLocation2d = CBGridUtilities::GetGridCellCenter(GridPath[GridCoordIndex], GridCellSize);
-			if (Raycast2d(PrevPointLocation2d, PointLocation2d))
-			{
-				FIntPoint const PrevGridCoord = GridPath[GridCoordIndex - 1];
-				PrevPointLocation2d = CBGridUtilities::GetGridCellCenter(PrevGridCoord, GridCellSize);
-				FVector::FReal const PrevCellHeight = GetTileNavigationData(GetTileCoord(PrevGridCoord))->GetCellHeight(PrevGridCoord);
-				PathPoints.Add(FNavPathPoint{ FVector{ PrevPointLocation2d, PrevCellHeight }, GetNodeRef(PrevGridCoord) });
-				GridBoundingBox.Include(PrevGridCoord);
-			}
+			FIntPoint const CornerGridCoord = GridPath[GridCoordIndex];
+			FVector2d const CornerCellCenter = CBGridUtilities::GetGridCellCenter(CornerGridCoord, GridCellSize);
+			FVector::FReal const CornerHeight = FindTileNavigationData(GetTileCoord(CornerGridCoord))->GetCellHeight(CornerGridCoord);
+			PathPoints.Add(FNavPathPoint{ FVector{ CornerCellCenter, CornerHeight }, GetNodeRef(CornerGridCoord) });
+			GridBoundingBox.Include(CornerGridCoord);
+		}
+	}
+	else if (OutPath.WantsStringPulling() && !GridPath.IsEmpty())
+	{
+		// Partial path is pulled to the center of its last cell, which is then kept as path point.
+		bool const bIsPartial = GridPath.Last() != EndGridCoord;
+		FVector2d const StringEnd = bIsPartial ? CBGridUtilities::GetGridCellCenter(GridPath.Last(), GridCellSize) : static_cast<FVector2d>(EndLocation);
+		TArray<FVector2d> Corners;
+		PullString(static_cast<FVector2d>(StartLocation), StringEnd, GridPath, GridCellSize, Corners);
+		if (bIsPartial)
+		{
+			Corners.Add(StringEnd);
 		}
 
-		if (Raycast2d(PrevPointLocation2d, static_cast<FVector2d>(EndLocation)))
+		for (FVector2d const & Corner : Corners)
 		{
-			FVector2d const EndCellCenter2d = CBGridUtilities::GetGridCellCenter(EndGridCoord, GridCellSize);
-			FVector::FReal const EndCellHeight = GetTileNavigationData(GetTileCoord(EndGridCoord))->GetCellHeight(EndGridCoord);
-			PathPoints.Add(FNavPathPoint{ FVector{ EndCellCenter2d, EndCellHeight }, GetNodeRef(EndGridCoord) });
+			// Corners lie on portals inside the corridor, so the cell containing corner is one of path cells.
+			FIntPoint const CornerGridCoord = CBGridUtilities::GetGridCellCoord(Corner, GridCellSize);
+			FVector::FReal const CornerHeight = FindTileNavigationData(GetTileCoord(CornerGridCoord))->GetCellHeight(CornerGridCoord);
+			PathPoints.Add(FNavPathPoint{ FVector{ Corner, CornerHeight }, GetNodeRef(CornerGridCoord) });
+			GridBoundingBox.Include(CornerGridCoord);
 		}
 	}
 	else
@@ -1058,7 +2125,7 @@ void ACBNavGrid::PostprocessPath(FVector const & StartLocation, FIntPoint const
 			{
 				PrevGridCoord = GridPath[GridCoordIndex - 1];
 				FVector2d const PrevCellCenter = CBGridUtilities::GetGridCellCenter(PrevGridCoord, GridCellSize);
-				FVector::FReal const PrevCellHeight = GetTileNavigationData(GetTileCoord(PrevGridCoord))->GetCellHeight(PrevGridCoord);
+				FVector::FReal const PrevCellHeight = FindTileNavigationData(GetTileCoord(PrevGridCoord))->GetCellHeight(PrevGridCoord);
 				PathPoints.Add(FNavPathPoint{ FVector{ PrevCellCenter, PrevCellHeight }, GetNodeRef(PrevGridCoord) });
 				GridBoundingBox.Include(PrevGridCoord);
 			}
@@ -1070,8 +2137,9 @@ void ACBNavGrid::PostprocessPath(FVector const & StartLocation, FIntPoint const
 	GridBoundingBox.Max += FIntPoint{ 1, 1 };
 }
 
-bool ACBNavGrid::TestPath(FPathFindingQuery const & Query, int32 * const OutNumVisitedNodes) const
+bool ACBNavGrid::TestPath(FPathFindingQuery const & Query, int32 * const OutNumVisitedNodes, bool const bHierarchical) const
 {
+	FCBNavGridReadScope const ReadScope{ *this };
 	FNavigationQueryFilter const & QueryFilter = GetFilterRef(Query.QueryFilter.Get());
 	FVector const AdjustedEndLocation = QueryFilter.GetAdjustedEndLocation(Query.EndLocation);
 
@@ -1088,78 +2156,98 @@ bool ACBNavGrid::TestPath(FPathFindingQuery const & Query, int32 * const OutNumV
 		return true;
 	}
 
-	// TODO: Should be dynamic_cast, but by default unreal projects compiled without rtti, so dynamic_cast won't work. Needs some workaround.
-	FCBNavGridQueryFilter const * const NavGridQueryFilter = static_cast<FCBNavGridQueryFilter const *>(QueryFilter.GetImplementation());
-	FVector2d const AxiswiseHeuristicScale = NavGridQueryFilter ? static_cast<FVector2d>(NavGridQueryFilter->GetAxiswiseHeuristicScale()) : FVector2d{ 1., 1. };
-	FCBNavGridAStarFilter const AStarFilter{ QueryFilter.GetHeuristicScale(), AxiswiseHeuristicScale, Query.CostLimit, QueryFilter.GetMaxSearchNodes() };
+	if (AreInDifferentIslands(StartGridCoord, EndGridCoord))
+	{
+		if (OutNumVisitedNodes)
+		{
+			*OutNumVisitedNodes = 0;
+		}
+
+		return false;
+	}
+
+	FCBNavGridAStarFilter const AStarFilter = MakeAStarFilter(QueryFilter, Query.CostLimit, false);
+	if (bHierarchical && AStarFilter.GetBlockingPlanesMask() == 0 && !AStarFilter.HasAreaCosts() && AStarFilter.GetAgentRadius() <= 0.f && GetTileCoord(StartGridCoord) != GetTileCoord(EndGridCoord))
+	{
+		return AbstractGraph->TestPath(StartGridCoord, EndGridCoord, AStarFilter, OutNumVisitedNodes) == ECBNavGridAStarResult::SearchSuccess;
+	}
+
 	TArray<FIntPoint> GridPath;
-	FGraphAStar<FCBNavGridToGraphAdapter, FGraphAStarDefaultPolicy, FCBNavGridAStarNode> AStar{ FCBNavGridToGraphAdapter{ *this } };
-	EGraphAStarResult const AStarResult = AStar.FindPath(StartGridCoord, EndGridCoord, AStarFilter, GridPath);
+	FCBNavGridAStar AStar{ *this };
+	ECBNavGridAStarResult const AStarResult = AStar.FindPath(StartGridCoord, EndGridCoord, AStarFilter, GridPath);
 
 	if (OutNumVisitedNodes)
 	{
-		*OutNumVisitedNodes = AStar.NodePool.Num();
+		*OutNumVisitedNodes = AStar.GetVisitedNodesNum();
 	}
 
-	return AStarResult == EGraphAStarResult::SearchSuccess;
+	return AStarResult == ECBNavGridAStarResult::SearchSuccess;
 }
 
 void ACBNavGrid::FindOverlappingEdgesUnsafe(TConstArrayView<FIntPoint> const StartGridCoords, TConstArrayView<FVector> const ConvexPolygon, TArray<FVector> & OutEdges) const
 {
-	TArray<FIntPoint> OpenList;
-	TSet<FIntPoint> VisitedSet;
-	OpenList.Append(StartGridCoords);
-	VisitedSet.Append(StartGridCoords);
+	check(!StartGridCoords.IsEmpty());
+	FCBNavGridLayer const * Tile = FindTileNavigationData(GetTileCoord(StartGridCoords.Last()));
+	check(Tile && !Tile->IsCellOccupied(StartGridCoords.Last()));
 
-	FCBNavGridLayer const * Tile = GetTileNavigationData(GetTileCoord(OpenList.Last())).Get();
-	check(Tile && !Tile->IsCellOccupied(OpenList.Last()));
+	// Fill crosses only cell edges intersecting the polygon. Such edges of every column form continuous ranges, as
+	// polygon is convex, and lie within polygon bounds extended by one cell.
+	FBox2d PolygonBoundingBox{ ForceInit };
+	for (FVector const & Vertex : ConvexPolygon)
+	{
+		PolygonBoundingBox += FVector2d{ Vertex };
+	}
+	FIntRect GridRect = CBGridUtilities::GetGridRectFromBoundingBox2d(PolygonBoundingBox, GridCellSize);
+	GridRect.InflateRect(1);
 
-	auto AddOutEdge = [this, &Tile, &OutEdges](FIntPoint const CellCoord, FVector2d const & EdgeStart2d, FVector2d const & EdgeEnd2d)
+	FCBNavGridFloodFill FloodFill{ GridRect };
+	FloodFill.AddFreeCells(*this);
+	for (int32 X = GridRect.Min.X; X < GridRect.Max.X; ++X)
+	{
+		FVector::FReal const MinX = X * GridCellSize;
+		FVector::FReal MinY, MaxY;
+		int32 MinYEdgeY = 0, MaxYEdgeY = -1, MinXEdgeY = 0, MaxXEdgeY = -1;
+		if (GetPolygonYRange(ConvexPolygon, MinX, MinX + GridCellSize, MinY, MaxY))
+		{
+			MinYEdgeY = FMath::CeilToInt32(MinY / GridCellSize);
+			MaxYEdgeY = FMath::FloorToInt32(MaxY / GridCellSize);
+		}
+		if (GetPolygonYRange(ConvexPolygon, MinX, MinX, MinY, MaxY))
+		{
+			MinXEdgeY = FMath::CeilToInt32(MinY / GridCellSize) - 1;
+			MaxXEdgeY = FMath::FloorToInt32(MaxY / GridCellSize);
+		}
+		FloodFill.SetColumnOpenEdges(X, MinYEdgeY, MaxYEdgeY, MinXEdgeY, MaxXEdgeY);
+	}
+	for (FIntPoint const StartGridCoord : StartGridCoords)
+	{
+		FloodFill.AddSeed(StartGridCoord);
+	}
+	FloodFill.Fill();
+
+	FloodFill.ForEachBoundaryEdge([this, &Tile, &OutEdges](FIntPoint const CellCoord, ECBGridDirection const GridDirection)
 		{
 			if (!Tile->IsInGrid(CellCoord))
 			{
-				Tile = GetTileNavigationData(GetTileCoord(CellCoord)).Get();
+				Tile = FindTileNavigationData(GetTileCoord(CellCoord));
 				check(Tile);
 			}
+			FVector2d EdgeStart, EdgeEnd;
+			GetEdgeCoords2D(CellCoord, GridDirection, GridCellSize, EdgeStart, EdgeEnd);
 			float const CellHeight = Tile->GetCellHeight(CellCoord);
-			OutEdges.Emplace(EdgeStart2d, CellHeight);
-			OutEdges.Emplace(EdgeEnd2d, CellHeight);
-		};
+			OutEdges.Emplace(EdgeStart, CellHeight);
+			OutEdges.Emplace(EdgeEnd, CellHeight);
+		});
+}
 
-	while (!OpenList.IsEmpty())
-	{
-		FIntPoint const CellCoord = OpenList.Pop(EAllowShrinking::No);
-		for (ECBGridDirection const GridDirection : TEnumRange<ECBGridDirection>())
+void ACBNavGrid::InvalidateAffectedFlowFields(FIntPoint const ChangedTileCoord)
+{
+	UE::TScopeLock FlowFieldsScopeLock(FlowFieldsLock);
+	++FlowFieldsGeneration;
+	FlowFields.RemoveAll([ChangedTileCoord](TSharedPtr<FCBNavGridFlowField const> const & FlowField)
 		{
-			FIntPoint const AdjacentCellCoord = CBGridUtilities::GetAdjacentCoordChecked(CellCoord, GridDirection);
-			FVector2d CellEdgeStart, CellEdgeEnd;
-			GetEdgeCoords2D(CellCoord, GridDirection, GridCellSize, CellEdgeStart, CellEdgeEnd);
-
-			if (VisitedSet.Contains(AdjacentCellCoord) || !IntersectSegmentPoly2D(CellEdgeStart, CellEdgeEnd, ConvexPolygon))
-			{
-				continue;
-			}
-			if (!Tile->IsInGrid(AdjacentCellCoord))
-			{
-				FCBNavGridLayer const * NewTile = GetTileNavigationData(GetTileCoord(AdjacentCellCoord)).Get();
-				if (!NewTile)
-				{
-					AddOutEdge(CellCoord, CellEdgeStart, CellEdgeEnd);
-					continue;
-				}
-				Tile = NewTile;
-			}
-			if (Tile->IsCellOccupied(AdjacentCellCoord))
-			{
-				AddOutEdge(CellCoord, CellEdgeStart, CellEdgeEnd);
-			}
-			else
-			{
-				OpenList.Push(AdjacentCellCoord);
-				VisitedSet.Add(AdjacentCellCoord);
-			}
-		}
-	}
+			return FlowField->IsTileCovered(ChangedTileCoord);
+		});
 }
 
 void ACBNavGrid::InvalidateAffectedPaths(FIntPoint const ChangedTileCoord)
@@ -1202,14 +2290,162 @@ void ACBNavGrid::InvalidateAffectedPaths(FIntPoint const ChangedTileCoord)
 FIntRect ACBNavGrid::CalculateBoundingGridRect() const
 {
 	FIntRect GridRect;
-	for (TPair<FIntPoint, FTileData> const & Tile : Tiles)
+	bool bIsFirstTile = true;
+	for (FTileData const & TileData : Tiles)
 	{
-		check(Tile.Value.NavigationData.IsValid());
-		GridRect.Union(Tile.Value.NavigationData->GetGridRect());
+		check(TileData.NavigationData.IsValid());
+		if (bIsFirstTile)
+		{
+			// Union with empty rect would stretch bounds to grid origin.
+			GridRect = TileData.NavigationData->GetGridRect();
+			bIsFirstTile = false;
+		}
+		else
+		{
+			GridRect.Union(TileData.NavigationData->GetGridRect());
+		}
 	}
 	return GridRect;
 }
 
+ACBNavGrid::FTileData & ACBNavGrid::FindOrAddTileData(FIntPoint const TileCoord)
+{
+	int32 TileIndex = FindTileIndex(TileCoord);
+	if (TileIndex == INDEX_NONE)
+	{
+		if (!TileTableRect.Contains(TileCoord))
+		{
+			GrowTileTable(TileCoord);
+		}
+		TileIndex = Tiles.Add(FTileData{ TileCoord });
+		FIntPoint const TableCoord = TileCoord - TileTableRect.Min;
+		TileTable[TableCoord.X * TileTableRect.Height() + TableCoord.Y] = TileIndex;
+	}
+	BumpTileGeneration(TileIndex);
+	InvalidateRandomPointIndex();
+	return Tiles[TileIndex];
+}
+
+bool ACBNavGrid::RemoveTileData(FIntPoint const TileCoord, FTileData & OutTileData)
+{
+	int32 const TileIndex = FindTileIndex(TileCoord);
+	if (TileIndex == INDEX_NONE)
+	{
+		return false;
+	}
+	OutTileData = MoveTemp(Tiles[TileIndex]);
+	Tiles.RemoveAt(TileIndex);
+	BumpTileGeneration(TileIndex);
+	InvalidateRandomPointIndex();
+	FIntPoint const TableCoord = TileCoord - TileTableRect.Min;
+	TileTable[TableCoord.X * TileTableRect.Height() + TableCoord.Y] = INDEX_NONE;
+	return true;
+}
+
+void ACBNavGrid::BumpTileGeneration(int32 const TileIndex)
+{
+	if (TileGenerations.Num() <= TileIndex)
+	{
+		TileGenerations.AddZeroed(TileIndex + 1 - TileGenerations.Num());
+	}
+	uint16 & Generation = TileGenerations[TileIndex];
+	++Generation;
+	if (Generation == 0)
+	{
+		Generation = 1;
+	}
+}
+
+bool ACBNavGrid::DecodeNodeRef(NavNodeRef const NodeRef, FTileData const *& OutTileData, uint32 & OutCellIndex) const
+{
+	int32 const TileIndex = static_cast<int32>((NodeRef >> NodeRefTileIndexShift) & NodeRefTileIndexMask);
+	uint16 const Generation = static_cast<uint16>(NodeRef >> NodeRefGenerationShift);
+	if (!TileGenerations.IsValidIndex(TileIndex) || TileGenerations[TileIndex] != Generation || !Tiles.IsAllocated(TileIndex))
+	{
+		return false;
+	}
+	OutTileData = &Tiles[TileIndex];
+	OutCellIndex = static_cast<uint32>(NodeRef & NodeRefCellIndexMask);
+	return true;
+}
+
+void ACBNavGrid::EmptyTiles()
+{
+	{
+		FRWScopeLock const TilesScopeLock{ TilesLock, SLT_Write };
+		Tiles.Empty();
+		TileTable.Empty();
+		TileTableRect = FIntRect{};
+		BoundingGridRect = FIntRect{};
+		InvalidateRandomPointIndex();
+	}
+
+	UE::TScopeLock FlowFieldsScopeLock(FlowFieldsLock);
+	++FlowFieldsGeneration;
+	FlowFields.Empty();
+}
+
+void ACBNavGrid::InvalidateRandomPointIndex()
+{
+	UE::TScopeLock RandomPointIndexScopeLock(RandomPointIndexLock);
+	bIsRandomPointIndexValid = false;
+}
+
+void ACBNavGrid::UpdateRandomPointIndex() const
+{
+	RandomPointTiles.Reset();
+	RandomPointTilesPrefixSums.Reset();
+	int64 FreeCellsNum = 0;
+	for (FTileData const & TileData : Tiles)
+	{
+		int32 const TileFreeCellsNum = TileData.NavigationData->GetFreeCellsNum();
+		if (TileFreeCellsNum > 0)
+		{
+			FreeCellsNum += TileFreeCellsNum;
+			RandomPointTiles.Add(TileData.NavigationData.Get());
+			RandomPointTilesPrefixSums.Add(FreeCellsNum);
+		}
+	}
+	bIsRandomPointIndexValid = true;
+}
+
+void ACBNavGrid::GrowTileTable(FIntPoint const TileCoord)
+{
+	FIntRect NewTileTableRect{ TileCoord, TileCoord + FIntPoint{ 1, 1 } };
+	if (!TileTable.IsEmpty())
+	{
+		// Table grows geometrically, so filling it tile by tile doesn't reallocate it on every new tile.
+		FIntPoint const Slack{ FMath::Max(TileTableRect.Width() / 2, 1), FMath::Max(TileTableRect.Height() / 2, 1) };
+		NewTileTableRect = TileTableRect;
+		if (TileCoord.X < TileTableRect.Min.X)
+		{
+			NewTileTableRect.Min.X = TileCoord.X - Slack.X;
+		}
+		else if (TileCoord.X >= TileTableRect.Max.X)
+		{
+			NewTileTableRect.Max.X = TileCoord.X + 1 + Slack.X;
+		}
+		if (TileCoord.Y < TileTableRect.Min.Y)
+		{
+			NewTileTableRect.Min.Y = TileCoord.Y - Slack.Y;
+		}
+		else if (TileCoord.Y >= TileTableRect.Max.Y)
+		{
+			NewTileTableRect.Max.Y = TileCoord.Y + 1 + Slack.Y;
+		}
+	}
+
+	TArray<int32> NewTileTable;
+	NewTileTable.Init(INDEX_NONE, NewTileTableRect.Area());
+	for (auto It = Tiles.CreateConstIterator(); It; ++It)
+	{
+		FIntPoint const TableCoord = It->Coord - NewTileTableRect.Min;
+		NewTileTable[TableCoord.X * NewTileTableRect.Height() + TableCoord.Y] = It.GetIndex();
+	}
+	TileTable = MoveTemp(NewTileTable);
+	TileTableRect = NewTileTableRect;
+}
+
 void ACBNavGrid::RequestDrawingUpdate()
 {
 #if UE_ENABLE_DEBUG_DRAWING
@@ -1255,26 +2491,41 @@ void ACBNavGrid::HandleChangePropertyFromCategory(FName const CategoryName)
 
 FArchive & operator <<(FArchive & Archive, ACBNavGrid::FTileData & TileData)
 {
-	auto SerializeSharedPtr = [&Archive]<typename T, ESPMode InMode>(TSharedPtr<T, InMode> & SharedPtr)
+	check(!Archive.IsLoading());
+	// Saving doesn't change tile data, archive API just takes mutable references.
+	auto SaveSharedPtr = [&Archive]<typename T, ESPMode InMode>(TSharedPtr<T, InMode> const & SharedPtr)
 		{
 			bool bIsValid = SharedPtr.IsValid();
 			Archive << bIsValid;
 			if (bIsValid)
 			{
-				if (Archive.IsLoading())
-				{
-					SharedPtr = MakeShared<T, InMode>();
-				}
 				Archive << *const_cast<std::remove_const_t<T> *>(SharedPtr.Get());
 			}
-			else if (Archive.IsLoading())
+		};
+
+	SaveSharedPtr(TileData.Heightfield);
+	SaveSharedPtr(TileData.NavigationData);
+
+	return Archive;
+}
+
+FArchive & operator <<(FArchive & Archive, ACBNavGrid::FLoadedTileData & TileData)
+{
+	check(Archive.IsLoading());
+	auto LoadSharedPtr = [&Archive]<typename T, ESPMode InMode>(TSharedPtr<T, InMode> & SharedPtr)
+		{
+			bool bIsValid = false;
+			Archive << bIsValid;
+			SharedPtr.Reset();
+			if (bIsValid)
 			{
-				SharedPtr.Reset();
+				SharedPtr = MakeShared<T, InMode>();
+				Archive << *SharedPtr;
 			}
 		};
 
-	SerializeSharedPtr(TileData.Heightfield);
-	SerializeSharedPtr(TileData.NavigationData);
+	LoadSharedPtr(TileData.Heightfield);
+	LoadSharedPtr(TileData.NavigationData);
 
 	return Archive;
 }
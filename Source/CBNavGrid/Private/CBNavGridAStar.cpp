@@ -1,14 +1,1204 @@
-#pragma once 
-
 #include "CBNavGridAStar.h"
+#include "Algo/Reverse.h"
 #include "CBGridUtilities.h"
+#include "CBNavGridLayer.h"
 
-int32 FCBNavGridToGraphAdapter::GetNeighbourCount(FNodeRef const NodeRef) const
+namespace
 {
-	return static_cast<int32>(ECBGridDirection::DIRECTIONS_NUM);
+	constexpr uint32 InvalidNodeId = MAX_uint32;
+
+	struct FSearchNode
+	{
+		/** Node belongs to the current search only if stamp is equal to the search stamp. */
+		uint32 SearchStamp;
+		uint32 ParentNodeId;
+
+		/** Which member is used depends on cost policy of the search. */
+		union
+		{
+			float TraversalCost;
+			uint32 FixedPointTraversalCost;
+		};
+
+		uint8 bIsClosed : 1;
+	};
+
+	/** Tile with nodes of the current search. Node storage of the tile starts at SlotIndex * CellsPerTileNum. */
+	struct FSearchTile
+	{
+		FCBNavGridLayer const * NavGridLayer;
+		FIntPoint TileCoord;
+		FIntPoint MinGridCoord;
+	};
+
+	/** Layer is looked up once per search, slot is added only when the first node of the tile is needed. */
+	struct FTileTableEntry
+	{
+		uint32 SearchStamp;
+		int32 SlotIndex;
+		FCBNavGridLayer const * NavGridLayer;
+	};
+
+	/** Open list of floating point cost searches. */
+	class FBinaryHeapOpenList
+	{
+	public:
+		FORCEINLINE void Reset();
+		FORCEINLINE bool IsEmpty() const;
+		FORCEINLINE void Push(FVector::FReal const TotalCost, uint32 const NodeId);
+		FORCEINLINE uint32 Pop();
+
+	private:
+		struct FEntry
+		{
+			FVector::FReal TotalCost;
+			uint32 NodeId;
+		};
+
+		struct FEntryPredicate
+		{
+			FORCEINLINE bool operator ()(FEntry const & A, FEntry const & B) const
+			{
+				return A.TotalCost < B.TotalCost;
+			}
+		};
+
+		TArray<FEntry> Entries;
+	};
+
+	void FBinaryHeapOpenList::Reset()
+	{
+		Entries.Reset();
+	}
+
+	bool FBinaryHeapOpenList::IsEmpty() const
+	{
+		return Entries.IsEmpty();
+	}
+
+	void FBinaryHeapOpenList::Push(FVector::FReal const TotalCost, uint32 const NodeId)
+	{
+		Entries.HeapPush(FEntry{ TotalCost, NodeId }, FEntryPredicate{});
+	}
+
+	uint32 FBinaryHeapOpenList::Pop()
+	{
+		FEntry Entry;
+		Entries.HeapPop(Entry, FEntryPredicate{}, EAllowShrinking::No);
+		return Entry.NodeId;
+	}
+
+	/**
+	 * Open list of fixed point cost searches. Entry is kept in the bucket indexed by the highest bit in which its key
+	 * differs from the last popped key, so every entry is moved between buckets at most 64 times. Radix heap requires
+	 * keys to never be less than the last popped one, slightly inconsistent heuristics (e.g. scaled by 1.00001)
+	 * may break that, so such keys are clamped to the last popped key.
+	 */
+	class FRadixHeapOpenList
+	{
+	public:
+		void Reset();
+		FORCEINLINE bool IsEmpty() const;
+		FORCEINLINE void Push(uint64 const TotalCost, uint32 const NodeId);
+		uint32 Pop();
+
+	private:
+		struct FEntry
+		{
+			uint64 TotalCost;
+			uint32 NodeId;
+		};
+
+		FORCEINLINE int32 GetBucketIndex(uint64 const TotalCost) const;
+		FORCEINLINE void AddToBucket(FEntry const & Entry);
+
+		static constexpr int32 BucketsNum = 65;
+
+		TArray<FEntry> Buckets[BucketsNum];
+
+		/** Bit I - 1 is set if bucket I is not empty. Bucket 0 is not tracked. */
+		uint64 NonEmptyBucketsMask = 0;
+		uint64 LastTotalCost = 0;
+		int32 EntriesNum = 0;
+	};
+
+	void FRadixHeapOpenList::Reset()
+	{
+		for (TArray<FEntry> & Bucket : Buckets)
+		{
+			Bucket.Reset();
+		}
+		NonEmptyBucketsMask = 0;
+		LastTotalCost = 0;
+		EntriesNum = 0;
+	}
+
+	bool FRadixHeapOpenList::IsEmpty() const
+	{
+		return EntriesNum == 0;
+	}
+
+	void FRadixHeapOpenList::Push(uint64 const TotalCost, uint32 const NodeId)
+	{
+		AddToBucket(FEntry{ FMath::Max(TotalCost, LastTotalCost), NodeId });
+		++EntriesNum;
+	}
+
+	uint32 FRadixHeapOpenList::Pop()
+	{
+		check(EntriesNum > 0);
+		if (Buckets[0].IsEmpty())
+		{
+			int32 const BucketIndex = static_cast<int32>(FMath::CountTrailingZeros64(NonEmptyBucketsMask)) + 1;
+			NonEmptyBucketsMask &= ~(uint64{ 1 } << (BucketIndex - 1));
+			TArray<FEntry> & Bucket = Buckets[BucketIndex];
+
+			LastTotalCost = MAX_uint64;
+			for (FEntry const & Entry : Bucket)
+			{
+				LastTotalCost = FMath::Min(LastTotalCost, Entry.TotalCost);
+			}
+
+			// All entries of the bucket land in buckets with lower indices.
+			for (FEntry const & Entry : Bucket)
+			{
+				AddToBucket(Entry);
+			}
+			Bucket.Reset();
+		}
+
+		--EntriesNum;
+		return Buckets[0].Pop(EAllowShrinking::No).NodeId;
+	}
+
+	int32 FRadixHeapOpenList::GetBucketIndex(uint64 const TotalCost) const
+	{
+		return TotalCost == LastTotalCost ? 0 : 64 - static_cast<int32>(FMath::CountLeadingZeros64(TotalCost ^ LastTotalCost));
+	}
+
+	void FRadixHeapOpenList::AddToBucket(FEntry const & Entry)
+	{
+		int32 const BucketIndex = GetBucketIndex(Entry.TotalCost);
+		Buckets[BucketIndex].Add(Entry);
+		if (BucketIndex > 0)
+		{
+			NonEmptyBucketsMask |= uint64{ 1 } << (BucketIndex - 1);
+		}
+	}
+
+	/** Search state reused by all searches running on the same thread. */
+	class FSearchContext
+	{
+	public:
+		void BeginSearch(ACBNavGrid const & InNavGrid, uint32 const InBlockingPlanesMask, uint8 const InMinClearance);
+		FORCEINLINE ACBNavGrid const & GetNavGrid() const;
+		FORCEINLINE uint32 GetBlockingPlanesMask() const;
+		FORCEINLINE uint8 GetMinClearance() const;
+
+		/** Doesn't allocate nodes, so occupancy reads don't grow node storage. Returns nullptr for missing tiles. */
+		FCBNavGridLayer const * FindNavGridLayer(FIntPoint const TileCoord);
+
+		/** Returns INDEX_NONE if there is no tile with such coord. */
+		int32 FindOrAddSlot(FIntPoint const TileCoord);
+		uint32 GetNodeId(FIntPoint const GridCoord);
+		FORCEINLINE uint32 GetNodeId(int32 const SlotIndex, FIntPoint const LocalCoord) const;
+		FORCEINLINE int32 GetSlotIndex(uint32 const NodeId) const;
+		FORCEINLINE FIntPoint GetLocalCoord(uint32 const NodeId) const;
+		FORCEINLINE FIntPoint GetGridCoord(uint32 const NodeId) const;
+		FORCEINLINE FSearchTile const & GetSearchTile(int32 const SlotIndex) const;
+		FORCEINLINE FSearchNode & GetNode(uint32 const NodeId);
+		FORCEINLINE bool IsInTile(FIntPoint const LocalCoord) const;
+
+		/**
+		 * Cells of missing tiles, cells of blocking planes selected for the search and cells with clearance less than
+		 * min clearance of the search are reported as occupied.
+		 */
+		FORCEINLINE bool IsCellOccupied(FIntPoint const GridCoord);
+		FORCEINLINE FCBNavGridLayer::WordType GetOccupancyWord(FIntPoint const GridCoord);
+
+		/**
+		 * Returns true if cells of columns X - 1, X and X + 1 are all free for the search within tiles row containing Y.
+		 * Bounds of the row are returned either way.
+		 */
+		bool AreColumnsFreeInTileRow(int32 const X, int32 const Y, int32 & OutMinY, int32 & OutMaxY);
+
+		/** Marks node as belonging to the current search. Traversal cost is left for the cost policy to initialize. */
+		FORCEINLINE FSearchNode & InitNode(uint32 const NodeId);
+		FORCEINLINE bool IsNodeInitialized(uint32 const NodeId) const;
+
+		FBinaryHeapOpenList BinaryHeapOpenList;
+		FRadixHeapOpenList RadixHeapOpenList;
+
+	private:
+		/** Returns nullptr if tile coord is out of table, entries of previous searches are reset. */
+		FTileTableEntry * FindTileTableEntry(FIntPoint const TileCoord);
+
+		TArray<FSearchNode> Nodes;
+		TArray<FSearchTile> Slots;
+		TArray<FTileTableEntry> TileTable;
+
+		ACBNavGrid const * NavGrid = nullptr;
+		FIntRect TileTableRect;
+		FIntPoint TileSize;
+		uint32 CellsPerTileNum = 0;
+		uint32 SearchStamp = 0;
+		uint32 BlockingPlanesMask = 0;
+		uint8 MinClearance = 0;
+	};
+
+	void FSearchContext::BeginSearch(ACBNavGrid const & InNavGrid, uint32 const InBlockingPlanesMask, uint8 const InMinClearance)
+	{
+		NavGrid = &InNavGrid;
+		BlockingPlanesMask = InBlockingPlanesMask;
+		MinClearance = InMinClearance;
+
+		if (TileSize != InNavGrid.GetTileSize())
+		{
+			TileSize = InNavGrid.GetTileSize();
+			CellsPerTileNum = TileSize.X * TileSize.Y;
+			Nodes.Reset();
+		}
+
+		++SearchStamp;
+		// Zero stamp is never used by searches, so zeroed nodes are always treated as uninitialized.
+		if (SearchStamp == 0)
+		{
+			FMemory::Memzero(Nodes.GetData(), Nodes.Num() * sizeof(FSearchNode));
+			FMemory::Memzero(TileTable.GetData(), TileTable.Num() * sizeof(FTileTableEntry));
+			SearchStamp = 1;
+		}
+
+		FIntRect const NewTileTableRect = CBGridUtilities::GetTileRect(InNavGrid.GetBoundingGridRect(), TileSize);
+		if (NewTileTableRect != TileTableRect)
+		{
+			TileTableRect = NewTileTableRect;
+			TileTable.Reset();
+			TileTable.AddZeroed(FMath::Max(TileTableRect.Area(), 0));
+		}
+
+		Slots.Reset();
+		BinaryHeapOpenList.Reset();
+		RadixHeapOpenList.Reset();
+	}
+
+	ACBNavGrid const & FSearchContext::GetNavGrid() const
+	{
+		return *NavGrid;
+	}
+
+	uint32 FSearchContext::GetBlockingPlanesMask() const
+	{
+		return BlockingPlanesMask;
+	}
+
+	uint8 FSearchContext::GetMinClearance() const
+	{
+		return MinClearance;
+	}
+
+	FTileTableEntry * FSearchContext::FindTileTableEntry(FIntPoint const TileCoord)
+	{
+		if (!TileTableRect.Contains(TileCoord))
+		{
+			return nullptr;
+		}
+
+		FIntPoint const TableCoord = TileCoord - TileTableRect.Min;
+		FTileTableEntry & Entry = TileTable[TableCoord.Y * TileTableRect.Width() + TableCoord.X];
+		if (Entry.SearchStamp != SearchStamp)
+		{
+			Entry.SearchStamp = SearchStamp;
+			Entry.SlotIndex = INDEX_NONE;
+			// Search runs within read scope of nav grid, so layers stay valid and unchanged until it ends.
+			Entry.NavGridLayer = NavGrid->FindTileNavigationData(TileCoord);
+		}
+		return &Entry;
+	}
+
+	FCBNavGridLayer const * FSearchContext::FindNavGridLayer(FIntPoint const TileCoord)
+	{
+		FTileTableEntry const * const Entry = FindTileTableEntry(TileCoord);
+		return Entry ? Entry->NavGridLayer : nullptr;
+	}
+
+	int32 FSearchContext::FindOrAddSlot(FIntPoint const TileCoord)
+	{
+		FTileTableEntry * const Entry = FindTileTableEntry(TileCoord);
+		if (!Entry || !Entry->NavGridLayer)
+		{
+			return INDEX_NONE;
+		}
+
+		if (Entry->SlotIndex == INDEX_NONE)
+		{
+			Entry->SlotIndex = Slots.Add(FSearchTile{ Entry->NavGridLayer, TileCoord, TileCoord * TileSize });
+			int32 const RequiredNodesNum = Slots.Num() * CellsPerTileNum;
+			if (Nodes.Num() < RequiredNodesNum)
+			{
+				Nodes.AddZeroed(RequiredNodesNum - Nodes.Num());
+			}
+		}
+		return Entry->SlotIndex;
+	}
+
+	uint32 FSearchContext::GetNodeId(FIntPoint const GridCoord)
+	{
+		FIntPoint const TileCoord = CBGridUtilities::GetTileCoord(GridCoord, TileSize);
+		int32 const SlotIndex = FindOrAddSlot(TileCoord);
+		if (SlotIndex == INDEX_NONE)
+		{
+			return InvalidNodeId;
+		}
+		return GetNodeId(SlotIndex, GridCoord - Slots[SlotIndex].MinGridCoord);
+	}
+
+	uint32 FSearchContext::GetNodeId(int32 const SlotIndex, FIntPoint const LocalCoord) const
+	{
+		checkSlow(IsInTile(LocalCoord));
+		return SlotIndex * CellsPerTileNum + LocalCoord.X * TileSize.Y + LocalCoord.Y;
+	}
+
+	int32 FSearchContext::GetSlotIndex(uint32 const NodeId) const
+	{
+		return NodeId / CellsPerTileNum;
+	}
+
+	FIntPoint FSearchContext::GetLocalCoord(uint32 const NodeId) const
+	{
+		uint32 const CellIndex = NodeId % CellsPerTileNum;
+		return FIntPoint(CellIndex / TileSize.Y, CellIndex % TileSize.Y);
+	}
+
+	FIntPoint FSearchContext::GetGridCoord(uint32 const NodeId) const
+	{
+		return Slots[GetSlotIndex(NodeId)].MinGridCoord + GetLocalCoord(NodeId);
+	}
+
+	FSearchTile const & FSearchContext::GetSearchTile(int32 const SlotIndex) const
+	{
+		return Slots[SlotIndex];
+	}
+
+	FSearchNode & FSearchContext::GetNode(uint32 const NodeId)
+	{
+		return Nodes[NodeId];
+	}
+
+	bool FSearchContext::IsInTile(FIntPoint const LocalCoord) const
+	{
+		return LocalCoord.X >= 0 && LocalCoord.Y >= 0 && LocalCoord.X < TileSize.X && LocalCoord.Y < TileSize.Y;
+	}
+
+	bool FSearchContext::IsCellOccupied(FIntPoint const GridCoord)
+	{
+		FCBNavGridLayer const * const NavGridLayer = FindNavGridLayer(CBGridUtilities::GetTileCoord(GridCoord, TileSize));
+		return !NavGridLayer || NavGridLayer->IsCellOccupied(GridCoord, BlockingPlanesMask, MinClearance);
+	}
+
+	FCBNavGridLayer::WordType FSearchContext::GetOccupancyWord(FIntPoint const GridCoord)
+	{
+		FCBNavGridLayer const * const NavGridLayer = FindNavGridLayer(CBGridUtilities::GetTileCoord(GridCoord, TileSize));
+		return NavGridLayer ? NavGridLayer->GetOccupancyWord(GridCoord, BlockingPlanesMask, MinClearance) : FCBNavGridLayer::FullWordMask;
+	}
+
+	bool FSearchContext::AreColumnsFreeInTileRow(int32 const X, int32 const Y, int32 & OutMinY, int32 & OutMaxY)
+	{
+		OutMinY = CBGridUtilities::GetTileCoord(FIntPoint{ X, Y }, TileSize).Y * TileSize.Y;
+		OutMaxY = OutMinY + TileSize.Y - 1;
+		for (int32 const ColumnX : { X - 1, X, X + 1 })
+		{
+			FCBNavGridLayer const * const NavGridLayer = FindNavGridLayer(CBGridUtilities::GetTileCoord(FIntPoint{ ColumnX, Y }, TileSize));
+			if (!NavGridLayer || !NavGridLayer->AreAllCellsFree(BlockingPlanesMask, MinClearance))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	FSearchNode & FSearchContext::InitNode(uint32 const NodeId)
+	{
+		FSearchNode & Node = Nodes[NodeId];
+		Node.SearchStamp = SearchStamp;
+		Node.ParentNodeId = InvalidNodeId;
+		Node.bIsClosed = false;
+		return Node;
+	}
+
+	bool FSearchContext::IsNodeInitialized(uint32 const NodeId) const
+	{
+		return Nodes[NodeId].SearchStamp == SearchStamp;
+	}
+
+	FSearchContext & GetSearchContext()
+	{
+		static thread_local FSearchContext SearchContext;
+		return SearchContext;
+	}
+
+	struct FRealCostPolicy
+	{
+		using FCost = FVector::FReal;
+		using FOpenList = FBinaryHeapOpenList;
+
+		static FORCEINLINE FCost ToCost(FVector::FReal const Cost)
+		{
+			return Cost;
+		}
+
+		static FORCEINLINE FCost GetTraversalCost(FSearchNode const & Node)
+		{
+			return Node.TraversalCost;
+		}
+
+		static FORCEINLINE void SetTraversalCost(FSearchNode & Node, FCost const TraversalCost)
+		{
+			Node.TraversalCost = static_cast<float>(TraversalCost);
+		}
+
+		static FORCEINLINE void ResetTraversalCost(FSearchNode & Node)
+		{
+			Node.TraversalCost = TNumericLimits<float>::Max();
+		}
+
+		static FORCEINLINE bool CanStoreTraversalCost(FCost const TraversalCost)
+		{
+			return true;
+		}
+
+		static FORCEINLINE FOpenList & GetOpenList(FSearchContext & Context)
+		{
+			return Context.BinaryHeapOpenList;
+		}
+	};
+
+	/** Costs are kept in 1/65536 units, so node is able to store traversal cost of up to 65535 unit steps. */
+	struct FFixedPointCostPolicy
+	{
+		using FCost = uint64;
+		using FOpenList = FRadixHeapOpenList;
+
+		static constexpr FVector::FReal CostUnit = 65536.;
+
+		static FORCEINLINE FCost ToCost(FVector::FReal const Cost)
+		{
+			FVector::FReal const ScaledCost = Cost * CostUnit + 0.5;
+			return ScaledCost >= static_cast<FVector::FReal>(MAX_uint64) ? MAX_uint64 : static_cast<FCost>(FMath::Max(ScaledCost, 0.));
+		}
+
+		static FORCEINLINE FCost GetTraversalCost(FSearchNode const & Node)
+		{
+			return Node.FixedPointTraversalCost;
+		}
+
+		static FORCEINLINE void SetTraversalCost(FSearchNode & Node, FCost const TraversalCost)
+		{
+			Node.FixedPointTraversalCost = static_cast<uint32>(TraversalCost);
+		}
+
+		static FORCEINLINE void ResetTraversalCost(FSearchNode & Node)
+		{
+			Node.FixedPointTraversalCost = MAX_uint32;
+		}
+
+		static FORCEINLINE bool CanStoreTraversalCost(FCost const TraversalCost)
+		{
+			return TraversalCost < MAX_uint32;
+		}
+
+		static FORCEINLINE FOpenList & GetOpenList(FSearchContext & Context)
+		{
+			return Context.RadixHeapOpenList;
+		}
+	};
+
+	constexpr uint8 DirectionsNum = static_cast<uint8>(ECBGridDirection::DIRECTIONS_NUM);
+	FIntPoint const AdjacentCoordShifts[DirectionsNum] = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
+
+	/** Expands node to its traversable adjacent cells. */
+	struct FAdjacentCellsExpander
+	{
+		template <typename TVisitor>
+		static void Expand(FSearchContext & Context, uint32 const NodeId, FIntPoint const EndGridCoord, FCBNavGridAStarFilter const & Filter, TVisitor && Visitor)
+		{
+			int32 const SlotIndex = Context.GetSlotIndex(NodeId);
+			FIntPoint const LocalCoord = Context.GetLocalCoord(NodeId);
+			FIntPoint const GridCoord = Context.GetSearchTile(SlotIndex).MinGridCoord + LocalCoord;
+			bool const bHasAreaCosts = Filter.HasAreaCosts();
+			uint8 const AreaId = bHasAreaCosts ? Context.GetSearchTile(SlotIndex).NavGridLayer->GetCellArea(GridCoord) : 0;
+
+			for (FIntPoint const & Shift : AdjacentCoordShifts)
+			{
+				FIntPoint const AdjacentGridCoord = GridCoord + Shift;
+				FIntPoint AdjacentLocalCoord = LocalCoord + Shift;
+				int32 AdjacentSlotIndex = SlotIndex;
+				if (!Context.IsInTile(AdjacentLocalCoord))
+				{
+					AdjacentSlotIndex = Context.FindOrAddSlot(Context.GetSearchTile(SlotIndex).TileCoord + Shift);
+					if (AdjacentSlotIndex == INDEX_NONE)
+					{
+						continue;
+					}
+					AdjacentLocalCoord = AdjacentGridCoord - Context.GetSearchTile(AdjacentSlotIndex).MinGridCoord;
+				}
+
+				FCBNavGridLayer const & AdjacentNavGridLayer = *Context.GetSearchTile(AdjacentSlotIndex).NavGridLayer;
+				if (AdjacentNavGridLayer.IsCellOccupied(AdjacentGridCoord, Context.GetBlockingPlanesMask(), Context.GetMinClearance()) || !Filter.IsTraversalAllowed(GridCoord, AdjacentGridCoord))
+				{
+					continue;
+				}
+
+				FVector::FReal TraversalCost = Filter.GetTraversalCost(GridCoord, AdjacentGridCoord);
+				if (bHasAreaCosts)
+				{
+					uint8 const AdjacentAreaId = AdjacentNavGridLayer.GetCellArea(AdjacentGridCoord);
+					if (!Filter.IsAreaAllowed(AdjacentAreaId))
+					{
+						continue;
+					}
+					TraversalCost = Filter.GetAreaTraversalCost(TraversalCost, AreaId, AdjacentAreaId);
+				}
+
+				Visitor(Context.GetNodeId(AdjacentSlotIndex, AdjacentLocalCoord), AdjacentGridCoord, TraversalCost);
+			}
+		}
+	};
+
+	/**
+	 * Scans cells column From.X in DirectionY starting from the cell next to From. Scan stops at the first jump point,
+	 * which is either end cell or cell with forced neighbour, or at the first occupied cell. Side cell is forced
+	 * neighbour if it is free, while the side cell preceding it is occupied. Whole words of the column and of
+	 * both side columns are tested at once, tiles rows where all three columns are free are skipped at once.
+	 */
+	bool JumpY(FSearchContext & Context, FIntPoint const From, int32 const DirectionY, FIntPoint const EndGridCoord, int32 & OutJumpPointY)
+	{
+		using WordType = FCBNavGridLayer::WordType;
+		constexpr int32 BitsPerWordNum = FCBNavGridLayer::BitsPerWordNum;
+		constexpr WordType FullWordMask = FCBNavGridLayer::FullWordMask;
+
+		int32 const FirstY = From.Y + DirectionY;
+		int32 WordMinY = FirstY & ~(BitsPerWordNum - 1);
+		bool const bIsEndColumn = From.X == EndGridCoord.X;
+		auto GetEndCellMask = [bIsEndColumn, &EndGridCoord](int32 const MinY) -> WordType
+			{
+				return bIsEndColumn && EndGridCoord.Y >= MinY && EndGridCoord.Y < MinY + BitsPerWordNum ? WordType{ 1 } << (EndGridCoord.Y - MinY) : 0;
+			};
+
+		// Occupancy of side cells preceding the current word.
+		WordType LeftCarry = Context.IsCellOccupied(FIntPoint{ From.X - 1, From.Y }) ? 1 : 0;
+		WordType RightCarry = Context.IsCellOccupied(FIntPoint{ From.X + 1, From.Y }) ? 1 : 0;
+
+		// Free tiles row has neither obstacles nor forced neighbours, unless side cells preceding it are occupied.
+		int32 TileRowMinY = WordMinY + BitsPerWordNum;
+		int32 TileRowMaxY = WordMinY - 1;
+		auto CanSkipTileRow = [&Context, &From, &EndGridCoord, bIsEndColumn, &LeftCarry, &RightCarry, &TileRowMinY, &TileRowMaxY](int32 const Y)
+			{
+				return Context.AreColumnsFreeInTileRow(From.X, Y, TileRowMinY, TileRowMaxY) && (LeftCarry | RightCarry) == 0
+					&& !(bIsEndColumn && EndGridCoord.Y >= TileRowMinY && EndGridCoord.Y <= TileRowMaxY);
+			};
+
+		if (DirectionY > 0)
+		{
+			WordType ScanMask = FullWordMask << (FirstY - WordMinY);
+			for (;; WordMinY += BitsPerWordNum, ScanMask = FullWordMask)
+			{
+				if (WordMinY > TileRowMaxY && CanSkipTileRow(WordMinY))
+				{
+					WordMinY = TileRowMaxY + 1 - BitsPerWordNum;
+					continue;
+				}
+				WordType const Column = Context.GetOccupancyWord(FIntPoint{ From.X, WordMinY });
+				WordType const Left = Context.GetOccupancyWord(FIntPoint{ From.X - 1, WordMinY });
+				WordType const Right = Context.GetOccupancyWord(FIntPoint{ From.X + 1, WordMinY });
+				WordType JumpPoints = (~Left & ((Left << 1) | LeftCarry)) | (~Right & ((Right << 1) | RightCarry)) | GetEndCellMask(WordMinY);
+				JumpPoints &= ScanMask;
+				WordType const Obstacles = Column & ScanMask;
+				if (Obstacles != 0)
+				{
+					JumpPoints &= (WordType{ 1 } << FMath::CountTrailingZeros(Obstacles)) - 1;
+				}
+				if (JumpPoints != 0)
+				{
+					OutJumpPointY = WordMinY + static_cast<int32>(FMath::CountTrailingZeros(JumpPoints));
+					return true;
+				}
+				if (Obstacles != 0)
+				{
+					return false;
+				}
+				LeftCarry = Left >> (BitsPerWordNum - 1);
+				RightCarry = Right >> (BitsPerWordNum - 1);
+			}
+		}
+		else
+		{
+			WordType ScanMask = FullWordMask >> (BitsPerWordNum - 1 - (FirstY - WordMinY));
+			for (;; WordMinY -= BitsPerWordNum, ScanMask = FullWordMask)
+			{
+				if (WordMinY < TileRowMinY && CanSkipTileRow(WordMinY))
+				{
+					WordMinY = TileRowMinY;
+					continue;
+				}
+				WordType const Column = Context.GetOccupancyWord(FIntPoint{ From.X, WordMinY });
+				WordType const Left = Context.GetOccupancyWord(FIntPoint{ From.X - 1, WordMinY });
+				WordType const Right = Context.GetOccupancyWord(FIntPoint{ From.X + 1, WordMinY });
+				WordType JumpPoints = (~Left & ((Left >> 1) | (LeftCarry << (BitsPerWordNum - 1))))
+					| (~Right & ((Right >> 1) | (RightCarry << (BitsPerWordNum - 1))))
+					| GetEndCellMask(WordMinY);
+				JumpPoints &= ScanMask;
+				WordType const Obstacles = Column & ScanMask;
+				if (Obstacles != 0)
+				{
+					int32 const LastObstacleBit = BitsPerWordNum - 1 - static_cast<int32>(FMath::CountLeadingZeros(Obstacles));
+					JumpPoints &= ~(FullWordMask >> (BitsPerWordNum - 1 - LastObstacleBit));
+				}
+				if (JumpPoints != 0)
+				{
+					OutJumpPointY = WordMinY + BitsPerWordNum - 1 - static_cast<int32>(FMath::CountLeadingZeros(JumpPoints));
+					return true;
+				}
+				if (Obstacles != 0)
+				{
+					return false;
+				}
+				LeftCarry = Left & 1;
+				RightCarry = Right & 1;
+			}
+		}
+	}
+
+	/** Steps along X axis until cell is either end cell or has jump point in any Y direction. */
+	bool JumpX(FSearchContext & Context, FIntPoint const From, int32 const DirectionX, FIntPoint const EndGridCoord, FIntPoint & OutJumpPoint)
+	{
+		int32 JumpPointY;
+		for (FIntPoint Coord{ From.X + DirectionX, From.Y }; !Context.IsCellOccupied(Coord); Coord.X += DirectionX)
+		{
+			if (Coord == EndGridCoord || JumpY(Context, Coord, 1, EndGridCoord, JumpPointY) || JumpY(Context, Coord, -1, EndGridCoord, JumpPointY))
+			{
+				OutJumpPoint = Coord;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Jump point search for 4-connected grids. Canonical paths go along X first and turn to Y freely, while moves
+	 * along Y continue straight and turn to X only at forced neighbours, so only jump points are added to open list.
+	 * Relies on uniform traversal costs, step cost is distance between jump points.
+	 */
+	struct FJumpPointsExpander
+	{
+		template <typename TVisitor>
+		static void Expand(FSearchContext & Context, uint32 const NodeId, FIntPoint const EndGridCoord, FCBNavGridAStarFilter const & Filter, TVisitor && Visitor)
+		{
+			FIntPoint const GridCoord = Context.GetGridCoord(NodeId);
+			uint32 const ParentNodeId = Context.GetNode(NodeId).ParentNodeId;
+			FIntPoint const Direction = ParentNodeId == InvalidNodeId ? FIntPoint::ZeroValue : GetDirection(Context.GetGridCoord(ParentNodeId), GridCoord);
+
+			auto VisitJumpPoint = [&Context, &Visitor, GridCoord](FIntPoint const JumpPoint)
+				{
+					FIntPoint const Delta = JumpPoint - GridCoord;
+					Visitor(Context.GetNodeId(JumpPoint), JumpPoint, static_cast<FVector::FReal>(FMath::Abs(Delta.X) + FMath::Abs(Delta.Y)));
+				};
+			auto JumpAlongX = [&Context, &VisitJumpPoint, GridCoord, EndGridCoord](int32 const DirectionX)
+				{
+					FIntPoint JumpPoint;
+					if (JumpX(Context, GridCoord, DirectionX, EndGridCoord, JumpPoint))
+					{
+						VisitJumpPoint(JumpPoint);
+					}
+				};
+			auto JumpAlongY = [&Context, &VisitJumpPoint, GridCoord, EndGridCoord](int32 const DirectionY)
+				{
+					int32 JumpPointY;
+					if (JumpY(Context, GridCoord, DirectionY, EndGridCoord, JumpPointY))
+					{
+						VisitJumpPoint(FIntPoint{ GridCoord.X, JumpPointY });
+					}
+				};
+
+			if (Direction.Y == 0)
+			{
+				if (Direction.X >= 0)
+				{
+					JumpAlongX(1);
+				}
+				if (Direction.X <= 0)
+				{
+					JumpAlongX(-1);
+				}
+				JumpAlongY(1);
+				JumpAlongY(-1);
+			}
+			else
+			{
+				JumpAlongY(Direction.Y);
+				for (int32 const DirectionX : { 1, -1 })
+				{
+					FIntPoint const SideCoord{ GridCoord.X + DirectionX, GridCoord.Y };
+					if (!Context.IsCellOccupied(SideCoord) && Context.IsCellOccupied(SideCoord - FIntPoint{ 0, Direction.Y }))
+					{
+						JumpAlongX(DirectionX);
+					}
+				}
+			}
+		}
+
+	private:
+		static FIntPoint GetDirection(FIntPoint const From, FIntPoint const To)
+		{
+			return FIntPoint{ FMath::Sign(To.X - From.X), FMath::Sign(To.Y - From.Y) };
+		}
+	};
+
+	/**
+	 * Relies on start and end nodes being valid, traversable and different.
+	 * Returns id of the end node if it was reached, otherwise id of the reached node closest to the end.
+	 */
+	template <typename TCostPolicy, typename TExpander>
+	uint32 Search(FSearchContext & Context, uint32 const StartNodeId, uint32 const EndNodeId, FCBNavGridAStarFilter const & Filter, int32 & InOutVisitedNodesNum)
+	{
+		using FCost = typename TCostPolicy::FCost;
+		typename TCostPolicy::FOpenList & OpenList = TCostPolicy::GetOpenList(Context);
+
+		FIntPoint const EndGridCoord = Context.GetGridCoord(EndNodeId);
+		FVector::FReal const HeuristicScale = Filter.GetHeuristicScale();
+		FCost const CostLimit = TCostPolicy::ToCost(Filter.GetCostLimit());
+		uint32 const MaxSearchNodes = Filter.GetMaxSearchNodes();
+
+		TCostPolicy::SetTraversalCost(Context.InitNode(StartNodeId), 0);
+		++InOutVisitedNodesNum;
+
+		uint32 BestNodeId = StartNodeId;
+		FCost BestNodeHeuristicCost = TCostPolicy::ToCost(Filter.GetHeuristicCost(Context.GetGridCoord(StartNodeId), EndGridCoord) * HeuristicScale);
+		OpenList.Push(BestNodeHeuristicCost, StartNodeId);
+
+		while (!OpenList.IsEmpty())
+		{
+			uint32 const NodeId = OpenList.Pop();
+			FSearchNode & Node = Context.GetNode(NodeId);
+
+			// Open list may contain outdated entries of nodes which cost was decreased later.
+			if (Node.bIsClosed)
+			{
+				continue;
+			}
+			Node.bIsClosed = true;
+
+			if (NodeId == EndNodeId)
+			{
+				return EndNodeId;
+			}
+
+			FCost const NodeTraversalCost = TCostPolicy::GetTraversalCost(Node);
+			TExpander::Expand(Context, NodeId, EndGridCoord, Filter, [&](uint32 const AdjacentNodeId, FIntPoint const AdjacentGridCoord, FVector::FReal const StepCost)
+				{
+					if (!Context.IsNodeInitialized(AdjacentNodeId))
+					{
+						if (static_cast<uint32>(InOutVisitedNodesNum) >= MaxSearchNodes)
+						{
+							return;
+						}
+						TCostPolicy::ResetTraversalCost(Context.InitNode(AdjacentNodeId));
+						++InOutVisitedNodesNum;
+					}
+
+					FSearchNode & AdjacentNode = Context.GetNode(AdjacentNodeId);
+					if (AdjacentNode.bIsClosed)
+					{
+						return;
+					}
+
+					FCost const NewTraversalCost = NodeTraversalCost + TCostPolicy::ToCost(StepCost);
+					FCost const NewHeuristicCost = AdjacentNodeId == EndNodeId ? 0 : TCostPolicy::ToCost(Filter.GetHeuristicCost(AdjacentGridCoord, EndGridCoord) * HeuristicScale);
+					FCost const NewTotalCost = NewTraversalCost + NewHeuristicCost;
+					if (NewTotalCost > CostLimit || !TCostPolicy::CanStoreTraversalCost(NewTraversalCost) || NewTraversalCost >= TCostPolicy::GetTraversalCost(AdjacentNode))
+					{
+						return;
+					}
+
+					TCostPolicy::SetTraversalCost(AdjacentNode, NewTraversalCost);
+					AdjacentNode.ParentNodeId = NodeId;
+					OpenList.Push(NewTotalCost, AdjacentNodeId);
+
+					if (NewHeuristicCost < BestNodeHeuristicCost)
+					{
+						BestNodeHeuristicCost = NewHeuristicCost;
+						BestNodeId = AdjacentNodeId;
+					}
+				});
+		}
+
+		return BestNodeId;
+	}
+
+	template <typename TCostPolicy>
+	uint32 Search(FSearchContext & Context, uint32 const StartNodeId, uint32 const EndNodeId, FCBNavGridAStarFilter const & Filter, int32 & InOutVisitedNodesNum)
+	{
+		if (Filter.UsesAnyAngleSearch())
+		{
+			return SearchAnyAngle<TCostPolicy>(Context, StartNodeId, EndNodeId, Filter, InOutVisitedNodesNum);
+		}
+		return Filter.UsesJumpPointSearch()
+			? Search<TCostPolicy, FJumpPointsExpander>(Context, StartNodeId, EndNodeId, Filter, InOutVisitedNodesNum)
+			: Search<TCostPolicy, FAdjacentCellsExpander>(Context, StartNodeId, EndNodeId, Filter, InOutVisitedNodesNum);
+	}
+
+	FVector::FReal GetAnyAngleHeuristicCost(FIntPoint const GridCoord, FIntPoint const EndGridCoord, FCBNavGridAStarFilter const & Filter)
+	{
+		FVector2d const & AxiswiseHeuristicScale = Filter.GetAxiswiseHeuristicScale();
+		FVector2d const Delta{ (EndGridCoord.X - GridCoord.X) * AxiswiseHeuristicScale.X, (EndGridCoord.Y - GridCoord.Y) * AxiswiseHeuristicScale.Y };
+		return Delta.Size() * Filter.GetHeuristicScale();
+	}
+
+	bool HasLineOfSight(ACBNavGrid const & NavGrid, FIntPoint const FromGridCoord, FIntPoint const ToGridCoord, FCBNavGridAStarFilter const & Filter)
+	{
+		float const CellSize = NavGrid.GetGridCellSize();
+		return !NavGrid.Raycast2d(CBGridUtilities::GetGridCellCenter(FromGridCoord, CellSize), CBGridUtilities::GetGridCellCenter(ToGridCoord, CellSize), nullptr, nullptr, Filter.GetBlockingPlanesMask(), Filter.GetAgentRadius());
+	}
+
+	/**
+	 * Lazy Theta*. Adjacent node is linked to the parent of expanded node as if they see each other, line of sight is
+	 * checked by Raycast2d only when node is expanded itself. If sight is blocked, node is relinked to its best closed
+	 * adjacent node. Step costs are euclidean distances in cells, filter's traversal costs are not used.
+	 */
+	template <typename TCostPolicy>
+	uint32 SearchAnyAngle(FSearchContext & Context, uint32 const StartNodeId, uint32 const EndNodeId, FCBNavGridAStarFilter const & Filter, int32 & InOutVisitedNodesNum)
+	{
+		using FCost = typename TCostPolicy::FCost;
+		typename TCostPolicy::FOpenList & OpenList = TCostPolicy::GetOpenList(Context);
+
+		FIntPoint const EndGridCoord = Context.GetGridCoord(EndNodeId);
+		FCost const CostLimit = TCostPolicy::ToCost(Filter.GetCostLimit());
+		uint32 const MaxSearchNodes = Filter.GetMaxSearchNodes();
+
+		TCostPolicy::SetTraversalCost(Context.InitNode(StartNodeId), 0);
+		++InOutVisitedNodesNum;
+
+		uint32 BestNodeId = StartNodeId;
+		FCost BestNodeHeuristicCost = TCostPolicy::ToCost(GetAnyAngleHeuristicCost(Context.GetGridCoord(StartNodeId), EndGridCoord, Filter));
+		OpenList.Push(BestNodeHeuristicCost, StartNodeId);
+
+		while (!OpenList.IsEmpty())
+		{
+			uint32 const NodeId = OpenList.Pop();
+			if (Context.GetNode(NodeId).bIsClosed)
+			{
+				continue;
+			}
+
+			FIntPoint const GridCoord = Context.GetGridCoord(NodeId);
+			uint32 ParentNodeId = Context.GetNode(NodeId).ParentNodeId;
+			if (ParentNodeId != InvalidNodeId && !HasLineOfSight(Context.GetNavGrid(), Context.GetGridCoord(ParentNodeId), GridCoord, Filter))
+			{
+				// Node was reached from closed adjacent node, so at least one candidate exists.
+				FCost BestTraversalCost = TNumericLimits<FCost>::Max();
+				for (FIntPoint const & Shift : AdjacentCoordShifts)
+				{
+					uint32 const AdjacentNodeId = Context.GetNodeId(GridCoord + Shift);
+					if (AdjacentNodeId == InvalidNodeId || !Context.IsNodeInitialized(AdjacentNodeId) || !Context.GetNode(AdjacentNodeId).bIsClosed)
+					{
+						continue;
+					}
+					FCost const TraversalCost = TCostPolicy::GetTraversalCost(Context.GetNode(AdjacentNodeId)) + TCostPolicy::ToCost(1.);
+					if (TraversalCost < BestTraversalCost)
+					{
+						BestTraversalCost = TraversalCost;
+						ParentNodeId = AdjacentNodeId;
+					}
+				}
+				FSearchNode & Node = Context.GetNode(NodeId);
+				TCostPolicy::SetTraversalCost(Node, BestTraversalCost);
+				Node.ParentNodeId = ParentNodeId;
+			}
+			Context.GetNode(NodeId).bIsClosed = true;
+
+			if (NodeId == EndNodeId)
+			{
+				return EndNodeId;
+			}
+
+			// Best node is chosen among closed nodes only, as they are the ones with verified line of sight to parent.
+			FCost const NodeHeuristicCost = TCostPolicy::ToCost(GetAnyAngleHeuristicCost(GridCoord, EndGridCoord, Filter));
+			if (NodeHeuristicCost < BestNodeHeuristicCost)
+			{
+				BestNodeHeuristicCost = NodeHeuristicCost;
+				BestNodeId = NodeId;
+			}
+
+			// Start node has no parent, so its adjacent nodes are linked to it directly.
+			uint32 const LinkNodeId = ParentNodeId == InvalidNodeId ? NodeId : ParentNodeId;
+			FIntPoint const LinkGridCoord = Context.GetGridCoord(LinkNodeId);
+			FCost const LinkTraversalCost = TCostPolicy::GetTraversalCost(Context.GetNode(LinkNodeId));
+			FAdjacentCellsExpander::Expand(Context, NodeId, EndGridCoord, Filter, [&](uint32 const AdjacentNodeId, FIntPoint const AdjacentGridCoord, FVector::FReal)
+				{
+					if (!Context.IsNodeInitialized(AdjacentNodeId))
+					{
+						if (static_cast<uint32>(InOutVisitedNodesNum) >= MaxSearchNodes)
+						{
+							return;
+						}
+						TCostPolicy::ResetTraversalCost(Context.InitNode(AdjacentNodeId));
+						++InOutVisitedNodesNum;
+					}
+
+					FSearchNode & AdjacentNode = Context.GetNode(AdjacentNodeId);
+					if (AdjacentNode.bIsClosed)
+					{
+						return;
+					}
+
+					FCost const NewTraversalCost = LinkTraversalCost + TCostPolicy::ToCost(FVector2d::Distance(FVector2d{ LinkGridCoord }, FVector2d{ AdjacentGridCoord }));
+					FCost const NewHeuristicCost = AdjacentNodeId == EndNodeId ? 0 : TCostPolicy::ToCost(GetAnyAngleHeuristicCost(AdjacentGridCoord, EndGridCoord, Filter));
+					FCost const NewTotalCost = NewTraversalCost + NewHeuristicCost;
+					if (NewTotalCost > CostLimit || !TCostPolicy::CanStoreTraversalCost(NewTraversalCost) || NewTraversalCost >= TCostPolicy::GetTraversalCost(AdjacentNode))
+					{
+						return;
+					}
+
+					TCostPolicy::SetTraversalCost(AdjacentNode, NewTraversalCost);
+					AdjacentNode.ParentNodeId = LinkNodeId;
+					OpenList.Push(NewTotalCost, AdjacentNodeId);
+				});
+		}
+
+		return BestNodeId;
+	}
+
+	/** Goals number up to which multi-goal search is guided by heuristic, larger sets are searched by plain Dijkstra. */
+	constexpr int32 MaxHeuristicGoalsNum = 64;
+
+	/**
+	 * Multi-goal search over adjacent cells. Heuristic is minimum of heuristics over goals, which stays admissible, so
+	 * the first closed goal is the closest one. Relies on start node being valid, traversable and not being a goal.
+	 * Returns id of the reached goal node, otherwise id of the reached node closest to any goal. Without heuristic, distance
+	 * to the nearest goal is evaluated for closed nodes only and only when partial solution is wanted.
+	 */
+	template <typename TCostPolicy>
+	uint32 SearchNearest(FSearchContext & Context, uint32 const StartNodeId, TMap<uint32, int32> const & GoalNodeIndices, TConstArrayView<FIntPoint> const GoalGridCoords, FCBNavGridAStarFilter const & Filter, int32 & InOutVisitedNodesNum)
+	{
+		using FCost = typename TCostPolicy::FCost;
+		typename TCostPolicy::FOpenList & OpenList = TCostPolicy::GetOpenList(Context);
+
+		FVector::FReal const HeuristicScale = Filter.GetHeuristicScale();
+		FCost const CostLimit = TCostPolicy::ToCost(Filter.GetCostLimit());
+		uint32 const MaxSearchNodes = Filter.GetMaxSearchNodes();
+		bool const bUseHeuristic = GoalGridCoords.Num() <= MaxHeuristicGoalsNum;
+		bool const bTrackClosedBestNode = !bUseHeuristic && Filter.WantsPartialSolution();
+		auto GetNearestGoalDistance = [&Filter, GoalGridCoords](FIntPoint const GridCoord)
+			{
+				FVector::FReal MinHeuristicCost = TNumericLimits<FVector::FReal>::Max();
+				for (FIntPoint const GoalGridCoord : GoalGridCoords)
+				{
+					MinHeuristicCost = FMath::Min(MinHeuristicCost, Filter.GetHeuristicCost(GridCoord, GoalGridCoord));
+				}
+				return MinHeuristicCost;
+			};
+		auto GetHeuristicCost = [&GetNearestGoalDistance, HeuristicScale, bUseHeuristic](FIntPoint const GridCoord) -> FCost
+			{
+				return bUseHeuristic ? TCostPolicy::ToCost(GetNearestGoalDistance(GridCoord) * HeuristicScale) : 0;
+			};
+
+		TCostPolicy::SetTraversalCost(Context.InitNode(StartNodeId), 0);
+		++InOutVisitedNodesNum;
+
+		uint32 BestNodeId = StartNodeId;
+		FCost BestNodeHeuristicCost = GetHeuristicCost(Context.GetGridCoord(StartNodeId));
+		OpenList.Push(BestNodeHeuristicCost, StartNodeId);
+		FVector::FReal BestNodeGoalDistance = TNumericLimits<FVector::FReal>::Max();
+
+		while (!OpenList.IsEmpty())
+		{
+			uint32 const NodeId = OpenList.Pop();
+			FSearchNode & Node = Context.GetNode(NodeId);
+			if (Node.bIsClosed)
+			{
+				continue;
+			}
+			Node.bIsClosed = true;
+
+			if (GoalNodeIndices.Contains(NodeId))
+			{
+				return NodeId;
+			}
+
+			if (bTrackClosedBestNode)
+			{
+				// Nodes are closed in traversal cost order, so ties keep the cheaper node.
+				FVector::FReal const NodeGoalDistance = GetNearestGoalDistance(Context.GetGridCoord(NodeId));
+				if (NodeGoalDistance < BestNodeGoalDistance)
+				{
+					BestNodeGoalDistance = NodeGoalDistance;
+					BestNodeId = NodeId;
+				}
+			}
+
+			FCost const NodeTraversalCost = TCostPolicy::GetTraversalCost(Node);
+			FAdjacentCellsExpander::Expand(Context, NodeId, FIntPoint{}, Filter, [&](uint32 const AdjacentNodeId, FIntPoint const AdjacentGridCoord, FVector::FReal const StepCost)
+				{
+					if (!Context.IsNodeInitialized(AdjacentNodeId))
+					{
+						if (static_cast<uint32>(InOutVisitedNodesNum) >= MaxSearchNodes)
+						{
+							return;
+						}
+						TCostPolicy::ResetTraversalCost(Context.InitNode(AdjacentNodeId));
+						++InOutVisitedNodesNum;
+					}
+
+					FSearchNode & AdjacentNode = Context.GetNode(AdjacentNodeId);
+					if (AdjacentNode.bIsClosed)
+					{
+						return;
+					}
+
+					FCost const NewTraversalCost = NodeTraversalCost + TCostPolicy::ToCost(StepCost);
+					FCost const NewHeuristicCost = GoalNodeIndices.Contains(AdjacentNodeId) ? 0 : GetHeuristicCost(AdjacentGridCoord);
+					FCost const NewTotalCost = NewTraversalCost + NewHeuristicCost;
+					if (NewTotalCost > CostLimit || !TCostPolicy::CanStoreTraversalCost(NewTraversalCost) || NewTraversalCost >= TCostPolicy::GetTraversalCost(AdjacentNode))
+					{
+						return;
+					}
+
+					TCostPolicy::SetTraversalCost(AdjacentNode, NewTraversalCost);
+					AdjacentNode.ParentNodeId = NodeId;
+					OpenList.Push(NewTotalCost, AdjacentNodeId);
+
+					if (bUseHeuristic && NewHeuristicCost < BestNodeHeuristicCost)
+					{
+						BestNodeHeuristicCost = NewHeuristicCost;
+						BestNodeId = AdjacentNodeId;
+					}
+				});
+		}
+
+		return BestNodeId;
+	}
+
+	/** Adds cells between path's last cell and GridCoord, which are expected to be on the same row or column, and GridCoord itself. */
+	void AddStraightPathSegment(TArray<FIntPoint> & OutPath, FIntPoint const GridCoord)
+	{
+		if (!OutPath.IsEmpty())
+		{
+			FIntPoint const LastGridCoord = OutPath.Last();
+			check(LastGridCoord.X == GridCoord.X || LastGridCoord.Y == GridCoord.Y);
+			FIntPoint const Step{ FMath::Sign(GridCoord.X - LastGridCoord.X), FMath::Sign(GridCoord.Y - LastGridCoord.Y) };
+			for (FIntPoint Coord = LastGridCoord + Step; Coord != GridCoord; Coord += Step)
+			{
+				OutPath.Add(Coord);
+			}
+		}
+		OutPath.Add(GridCoord);
+	}
+} // namespace
+
+ECBNavGridAStarResult FCBNavGridAStar::FindPath(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord, FCBNavGridAStarFilter const & Filter, TArray<FIntPoint> & OutPath)
+{
+	FCBNavGridReadScope const ReadScope{ NavGrid };
+	VisitedNodesNum = 0;
+	FSearchContext & Context = GetSearchContext();
+	Context.BeginSearch(NavGrid, Filter.GetBlockingPlanesMask(), NavGrid.GetRequiredClearance(Filter.GetAgentRadius()));
+
+	uint32 const StartNodeId = Context.GetNodeId(StartGridCoord);
+	uint32 const EndNodeId = Context.GetNodeId(EndGridCoord);
+	if (StartNodeId == InvalidNodeId || EndNodeId == InvalidNodeId
+		|| Context.GetSearchTile(Context.GetSlotIndex(StartNodeId)).NavGridLayer->IsCellOccupied(StartGridCoord, Context.GetBlockingPlanesMask(), Context.GetMinClearance())
+		|| Context.GetSearchTile(Context.GetSlotIndex(EndNodeId)).NavGridLayer->IsCellOccupied(EndGridCoord, Context.GetBlockingPlanesMask(), Context.GetMinClearance()))
+	{
+		return ECBNavGridAStarResult::SearchFail;
+	}
+
+	if (StartNodeId == EndNodeId)
+	{
+		return ECBNavGridAStarResult::SearchSuccess;
+	}
+
+	uint32 const BestNodeId = Filter.UsesFixedPointCosts()
+		? Search<FFixedPointCostPolicy>(Context, StartNodeId, EndNodeId, Filter, VisitedNodesNum)
+		: Search<FRealCostPolicy>(Context, StartNodeId, EndNodeId, Filter, VisitedNodesNum);
+
+	ECBNavGridAStarResult const Result = BestNodeId == EndNodeId ? ECBNavGridAStarResult::SearchSuccess : ECBNavGridAStarResult::GoalUnreachable;
+	if (Result == ECBNavGridAStarResult::SearchSuccess || Filter.WantsPartialSolution())
+	{
+		// Consecutive nodes of jump point search are not adjacent, so gaps between them are filled.
+		// Any-angle path is left as is, its consecutive nodes see each other.
+		OutPath.Reset();
+		for (uint32 PathNodeId = BestNodeId; PathNodeId != InvalidNodeId; PathNodeId = Context.GetNode(PathNodeId).ParentNodeId)
+		{
+			if (Filter.UsesAnyAngleSearch())
+			{
+				OutPath.Add(Context.GetGridCoord(PathNodeId));
+			}
+			else
+			{
+				AddStraightPathSegment(OutPath, Context.GetGridCoord(PathNodeId));
+			}
+		}
+		Algo::Reverse(OutPath);
+	}
+
+	return Result;
 }
 
-FCBNavGridToGraphAdapter::FNodeRef FCBNavGridToGraphAdapter::GetNeighbour(FAStarSearchNode const & SearchNode, int32 const NeighbourIndex) const
+ECBNavGridAStarResult FCBNavGridAStar::FindPathToNearest(FIntPoint const StartGridCoord, TConstArrayView<FIntPoint> const EndGridCoords, FCBNavGridAStarFilter const & Filter, TArray<FIntPoint> & OutPath, int32 & OutEndIndex)
 {
-	return CBGridUtilities::GetAdjacentCoordChecked(SearchNode.NodeRef, static_cast<ECBGridDirection>(NeighbourIndex));
+	FCBNavGridReadScope const ReadScope{ NavGrid };
+	VisitedNodesNum = 0;
+	OutEndIndex = INDEX_NONE;
+	FSearchContext & Context = GetSearchContext();
+	Context.BeginSearch(NavGrid, Filter.GetBlockingPlanesMask(), NavGrid.GetRequiredClearance(Filter.GetAgentRadius()));
+
+	uint32 const StartNodeId = Context.GetNodeId(StartGridCoord);
+	if (StartNodeId == InvalidNodeId || Context.GetSearchTile(Context.GetSlotIndex(StartNodeId)).NavGridLayer->IsCellOccupied(StartGridCoord, Context.GetBlockingPlanesMask(), Context.GetMinClearance()))
+	{
+		return ECBNavGridAStarResult::SearchFail;
+	}
+
+	// Invalid and occupied goals are skipped, duplicates keep the first index.
+	TMap<uint32, int32> GoalNodeIndices;
+	TArray<FIntPoint> GoalGridCoords;
+	for (int32 EndIndex = 0; EndIndex < EndGridCoords.Num(); ++EndIndex)
+	{
+		FIntPoint const EndGridCoord = EndGridCoords[EndIndex];
+		uint32 const EndNodeId = Context.GetNodeId(EndGridCoord);
+		if (EndNodeId == InvalidNodeId || GoalNodeIndices.Contains(EndNodeId) || Context.GetSearchTile(Context.GetSlotIndex(EndNodeId)).NavGridLayer->IsCellOccupied(EndGridCoord, Context.GetBlockingPlanesMask(), Context.GetMinClearance()))
+		{
+			continue;
+		}
+		if (EndNodeId == StartNodeId)
+		{
+			OutEndIndex = EndIndex;
+			return ECBNavGridAStarResult::SearchSuccess;
+		}
+		GoalNodeIndices.Add(EndNodeId, EndIndex);
+		GoalGridCoords.Add(EndGridCoord);
+	}
+	if (GoalNodeIndices.IsEmpty())
+	{
+		return ECBNavGridAStarResult::SearchFail;
+	}
+
+	uint32 const BestNodeId = Filter.UsesFixedPointCosts()
+		? SearchNearest<FFixedPointCostPolicy>(Context, StartNodeId, GoalNodeIndices, GoalGridCoords, Filter, VisitedNodesNum)
+		: SearchNearest<FRealCostPolicy>(Context, StartNodeId, GoalNodeIndices, GoalGridCoords, Filter, VisitedNodesNum);
+
+	int32 const * const BestNodeEndIndex = GoalNodeIndices.Find(BestNodeId);
+	ECBNavGridAStarResult const Result = BestNodeEndIndex ? ECBNavGridAStarResult::SearchSuccess : ECBNavGridAStarResult::GoalUnreachable;
+	if (Result == ECBNavGridAStarResult::SearchSuccess || Filter.WantsPartialSolution())
+	{
+		OutPath.Reset();
+		for (uint32 PathNodeId = BestNodeId; PathNodeId != InvalidNodeId; PathNodeId = Context.GetNode(PathNodeId).ParentNodeId)
+		{
+			OutPath.Add(Context.GetGridCoord(PathNodeId));
+		}
+		Algo::Reverse(OutPath);
+	}
+	if (BestNodeEndIndex)
+	{
+		OutEndIndex = *BestNodeEndIndex;
+	}
+
+	return Result;
 }
@@ -0,0 +1,556 @@
+#include "CBNavGridAbstractGraph.h"
+#include "Algo/Reverse.h"
+#include "CBGridUtilities.h"
+#include "CBNavGridLayer.h"
+#include "Misc/ScopeRWLock.h"
+
+namespace
+{
+	/** Runs of free border cells not longer than this get one entrance in the middle, longer ones get two at the ends. */
+	constexpr int32 MaxSingleEntranceRunLength = 8;
+
+	constexpr int32 BordersNum = static_cast<int32>(ECBGridDirection::DIRECTIONS_NUM);
+	FIntPoint const BorderCrossShifts[BordersNum] = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
+
+	int32 GetOppositeBorderIndex(int32 const BorderIndex)
+	{
+		return (BorderIndex + 2) % BordersNum;
+	}
+
+	/** Gets first cell of tile border and step to the next border cell. */
+	void GetBorderCells(FIntRect const & TileRect, int32 const BorderIndex, FIntPoint & OutFirstCell, FIntPoint & OutStep, int32 & OutLength)
+	{
+		switch (static_cast<ECBGridDirection>(BorderIndex))
+		{
+		case ECBGridDirection::PositiveX:
+			OutFirstCell = FIntPoint{ TileRect.Max.X - 1, TileRect.Min.Y };
+			OutStep = FIntPoint{ 0, 1 };
+			OutLength = TileRect.Height();
+			break;
+		case ECBGridDirection::PositiveY:
+			OutFirstCell = FIntPoint{ TileRect.Min.X, TileRect.Max.Y - 1 };
+			OutStep = FIntPoint{ 1, 0 };
+			OutLength = TileRect.Width();
+			break;
+		case ECBGridDirection::NegativeX:
+			OutFirstCell = TileRect.Min;
+			OutStep = FIntPoint{ 0, 1 };
+			OutLength = TileRect.Height();
+			break;
+		case ECBGridDirection::NegativeY:
+			OutFirstCell = TileRect.Min;
+			OutStep = FIntPoint{ 1, 0 };
+			OutLength = TileRect.Width();
+			break;
+		default:
+			checkNoEntry();
+		}
+	}
+
+	int32 GetCellIndexInTile(FIntRect const & TileRect, FIntPoint const GridCoord)
+	{
+		return (GridCoord.X - TileRect.Min.X) * TileRect.Height() + (GridCoord.Y - TileRect.Min.Y);
+	}
+
+	/** Breadth first search constrained to the tile. Distances are indexed by cell index in tile, unreachable cells get INDEX_NONE. */
+	void CalculateDistancesInTile(FCBNavGridLayer const & NavGridLayer, FIntRect const & TileRect, FIntPoint const FromGridCoord, TArray<int32> & OutDistances)
+	{
+		static thread_local TArray<FIntPoint> OpenList;
+		OpenList.Reset();
+		OutDistances.Init(INDEX_NONE, TileRect.Area());
+
+		OutDistances[GetCellIndexInTile(TileRect, FromGridCoord)] = 0;
+		OpenList.Add(FromGridCoord);
+		for (int32 OpenListIndex = 0; OpenListIndex < OpenList.Num(); ++OpenListIndex)
+		{
+			FIntPoint const GridCoord = OpenList[OpenListIndex];
+			int32 const AdjacentDistance = OutDistances[GetCellIndexInTile(TileRect, GridCoord)] + 1;
+			for (FIntPoint const & Shift : BorderCrossShifts)
+			{
+				FIntPoint const AdjacentGridCoord = GridCoord + Shift;
+				if (!TileRect.Contains(AdjacentGridCoord) || NavGridLayer.IsCellOccupied(AdjacentGridCoord))
+				{
+					continue;
+				}
+				int32 & Distance = OutDistances[GetCellIndexInTile(TileRect, AdjacentGridCoord)];
+				if (Distance == INDEX_NONE)
+				{
+					Distance = AdjacentDistance;
+					OpenList.Add(AdjacentGridCoord);
+				}
+			}
+		}
+	}
+
+	struct FAbstractSearchNode
+	{
+		uint32 SearchStamp;
+		int32 ParentNodeIndex;
+		int32 TraversalCost;
+		uint8 bIsClosed : 1;
+	};
+
+	struct FAbstractOpenListEntry
+	{
+		FVector::FReal TotalCost;
+		int32 NodeIndex;
+	};
+
+	struct FAbstractOpenListEntryPredicate
+	{
+		FORCEINLINE bool operator ()(FAbstractOpenListEntry const & A, FAbstractOpenListEntry const & B) const
+		{
+			return A.TotalCost < B.TotalCost;
+		}
+	};
+
+	/** Abstract search state reused by all searches running on the same thread. */
+	struct FAbstractSearchContext
+	{
+		void BeginSearch(int32 const NodesNum)
+		{
+			if (Nodes.Num() < NodesNum)
+			{
+				Nodes.AddZeroed(NodesNum - Nodes.Num());
+			}
+			++SearchStamp;
+			if (SearchStamp == 0)
+			{
+				FMemory::Memzero(Nodes.GetData(), Nodes.Num() * sizeof(FAbstractSearchNode));
+				SearchStamp = 1;
+			}
+			OpenList.Reset();
+		}
+
+		TArray<FAbstractSearchNode> Nodes;
+		TArray<FAbstractOpenListEntry> OpenList;
+		TArray<int32> StartDistances;
+		TArray<int32> EndDistances;
+		uint32 SearchStamp = 0;
+	};
+
+	FAbstractSearchContext & GetAbstractSearchContext()
+	{
+		static thread_local FAbstractSearchContext SearchContext;
+		return SearchContext;
+	}
+} // namespace
+
+FCBNavGridAbstractGraph::FCBNavGridAbstractGraph(ACBNavGrid const & InNavGrid)
+	: NavGrid(InNavGrid)
+{
+	static_assert(FCBNavGridAbstractGraph::BordersNum == ::BordersNum);
+}
+
+void FCBNavGridAbstractGraph::OnTileChanged(FIntPoint const TileCoord)
+{
+	FRWScopeLock const ScopeLock{ Lock, SLT_Write };
+
+	bool const bHasTile = NavGrid.IsValidTileCoord(TileCoord);
+	for (int32 BorderIndex = 0; BorderIndex < BordersNum; ++BorderIndex)
+	{
+		RemoveBorderNodes(TileCoord, BorderIndex);
+		if (bHasTile)
+		{
+			BuildBorderNodes(TileCoord, BorderIndex);
+		}
+	}
+
+	if (!bHasTile)
+	{
+		Clusters.Remove(TileCoord);
+	}
+	MarkIntraEdgesDirty(TileCoord, (1u << BordersNum) - 1);
+}
+
+void FCBNavGridAbstractGraph::OnTileCellsChanged(FIntPoint const TileCoord, FIntRect const & GridRect)
+{
+	FRWScopeLock const ScopeLock{ Lock, SLT_Write };
+
+	FIntRect const TileRect = GetTileGridRect(TileCoord);
+	FIntRect ChangedRect = TileRect;
+	ChangedRect.Clip(GridRect);
+	if (ChangedRect.Width() <= 0 || ChangedRect.Height() <= 0 || !NavGrid.IsValidTileCoord(TileCoord))
+	{
+		return;
+	}
+
+	uint32 ChangedBordersMask = 0;
+	for (int32 BorderIndex = 0; BorderIndex < BordersNum; ++BorderIndex)
+	{
+		FIntPoint FirstCell, Step;
+		int32 BorderLength;
+		GetBorderCells(TileRect, BorderIndex, FirstCell, Step, BorderLength);
+		FIntRect ChangedBorderRect{ FirstCell, FirstCell + Step * (BorderLength - 1) + FIntPoint{ 1, 1 } };
+		ChangedBorderRect.Clip(ChangedRect);
+		if (ChangedBorderRect.Width() <= 0 || ChangedBorderRect.Height() <= 0)
+		{
+			continue;
+		}
+		RemoveBorderNodes(TileCoord, BorderIndex);
+		BuildBorderNodes(TileCoord, BorderIndex);
+		ChangedBordersMask |= 1u << BorderIndex;
+	}
+	MarkIntraEdgesDirty(TileCoord, ChangedBordersMask);
+}
+
+void FCBNavGridAbstractGraph::Rebuild()
+{
+	FRWScopeLock const ScopeLock{ Lock, SLT_Write };
+
+	Nodes.Empty();
+	Clusters.Empty();
+	DirtyClusters.Empty();
+
+	TArray<FIntPoint> const TileCoords = NavGrid.GetTileCoords();
+	// Every border is shared by two tiles, so only positive borders of each tile are built.
+	for (FIntPoint const & TileCoord : TileCoords)
+	{
+		BuildBorderNodes(TileCoord, static_cast<int32>(ECBGridDirection::PositiveX));
+		BuildBorderNodes(TileCoord, static_cast<int32>(ECBGridDirection::PositiveY));
+	}
+	for (FIntPoint const & TileCoord : TileCoords)
+	{
+		BuildIntraEdges(TileCoord);
+	}
+}
+
+void FCBNavGridAbstractGraph::Reset()
+{
+	FRWScopeLock const ScopeLock{ Lock, SLT_Write };
+
+	Nodes.Empty();
+	Clusters.Empty();
+	DirtyClusters.Empty();
+}
+
+ECBNavGridAStarResult FCBNavGridAbstractGraph::FindPath(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord, FCBNavGridAStarFilter const & Filter, TArray<FIntPoint> & OutPath, int32 * const OutVisitedNodesNum) const
+{
+	// Tiles are read locked before the graph, like on every other query thread.
+	FCBNavGridReadScope const ReadScope{ NavGrid };
+	TArray<FIntPoint> AbstractPath;
+	int32 VisitedNodesNum = 0;
+	ECBNavGridAStarResult Result = FindAbstractPath(StartGridCoord, EndGridCoord, Filter, &AbstractPath, VisitedNodesNum);
+
+	if (Result == ECBNavGridAStarResult::SearchSuccess)
+	{
+		// Segments are confined to single tile, so search nodes are limited by tile size instead of query limit.
+		FIntPoint const TileSize = NavGrid.GetTileSize();
+		uint32 const SegmentMaxSearchNodes = 4 * TileSize.X * TileSize.Y;
+		FCBNavGridAStarFilter const SegmentFilter{ Filter.GetHeuristicScale(), Filter.GetAxiswiseHeuristicScale(), TNumericLimits<FVector::FReal>::Max(), SegmentMaxSearchNodes, false, Filter.UsesFixedPointCosts(), Filter.UsesJumpPointSearch() };
+		FCBNavGridAStar AStar{ NavGrid };
+		TArray<FIntPoint> Segment;
+
+		OutPath.Reset();
+		OutPath.Add(AbstractPath[0]);
+		for (int32 AbstractPathIndex = 1; AbstractPathIndex < AbstractPath.Num(); ++AbstractPathIndex)
+		{
+			FIntPoint const SegmentStart = AbstractPath[AbstractPathIndex - 1];
+			FIntPoint const SegmentEnd = AbstractPath[AbstractPathIndex];
+			if ((SegmentEnd - SegmentStart).SizeSquared() <= 1)
+			{
+				if (SegmentEnd != SegmentStart)
+				{
+					OutPath.Add(SegmentEnd);
+				}
+				continue;
+			}
+
+			Segment.Reset();
+			ECBNavGridAStarResult const SegmentResult = AStar.FindPath(SegmentStart, SegmentEnd, SegmentFilter, Segment);
+			VisitedNodesNum += AStar.GetVisitedNodesNum();
+			if (SegmentResult != ECBNavGridAStarResult::SearchSuccess)
+			{
+				OutPath.Reset();
+				Result = ECBNavGridAStarResult::GoalUnreachable;
+				break;
+			}
+			OutPath.Append(Segment.GetData() + 1, Segment.Num() - 1);
+		}
+	}
+
+	if (OutVisitedNodesNum)
+	{
+		*OutVisitedNodesNum = VisitedNodesNum;
+	}
+	return Result;
+}
+
+ECBNavGridAStarResult FCBNavGridAbstractGraph::TestPath(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord, FCBNavGridAStarFilter const & Filter, int32 * const OutVisitedNodesNum) const
+{
+	FCBNavGridReadScope const ReadScope{ NavGrid };
+	int32 VisitedNodesNum = 0;
+	ECBNavGridAStarResult const Result = FindAbstractPath(StartGridCoord, EndGridCoord, Filter, nullptr, VisitedNodesNum);
+	if (OutVisitedNodesNum)
+	{
+		*OutVisitedNodesNum = VisitedNodesNum;
+	}
+	return Result;
+}
+
+void FCBNavGridAbstractGraph::RemoveBorderNodes(FIntPoint const TileCoord, int32 const BorderIndex)
+{
+	auto RemoveNodes = [this](FIntPoint const ClusterTileCoord, int32 const ClusterBorderIndex)
+		{
+			if (FCluster * const Cluster = Clusters.Find(ClusterTileCoord))
+			{
+				for (int32 const NodeIndex : Cluster->BorderNodeIndices[ClusterBorderIndex])
+				{
+					Nodes.RemoveAt(NodeIndex);
+				}
+				Cluster->BorderNodeIndices[ClusterBorderIndex].Reset();
+			}
+		};
+
+	RemoveNodes(TileCoord, BorderIndex);
+	RemoveNodes(TileCoord + BorderCrossShifts[BorderIndex], GetOppositeBorderIndex(BorderIndex));
+}
+
+void FCBNavGridAbstractGraph::BuildBorderNodes(FIntPoint const TileCoord, int32 const BorderIndex)
+{
+	FIntPoint const Shift = BorderCrossShifts[BorderIndex];
+	FIntPoint const NeighbourTileCoord = TileCoord + Shift;
+	FCBNavGridLayer const * const NavGridLayer = NavGrid.FindTileNavigationData(TileCoord);
+	FCBNavGridLayer const * const NeighbourNavGridLayer = NavGrid.FindTileNavigationData(NeighbourTileCoord);
+	if (!NavGridLayer || !NeighbourNavGridLayer)
+	{
+		return;
+	}
+
+	Clusters.FindOrAdd(TileCoord);
+	Clusters.FindOrAdd(NeighbourTileCoord);
+	TArray<int32> & BorderNodeIndices = Clusters[TileCoord].BorderNodeIndices[BorderIndex];
+	TArray<int32> & NeighbourBorderNodeIndices = Clusters[NeighbourTileCoord].BorderNodeIndices[GetOppositeBorderIndex(BorderIndex)];
+
+	auto AddEntrance = [this, TileCoord, NeighbourTileCoord, Shift, &BorderNodeIndices, &NeighbourBorderNodeIndices](FIntPoint const GridCoord)
+		{
+			int32 const NodeIndex = Nodes.Add(FNode{ GridCoord, TileCoord, INDEX_NONE, {} });
+			int32 const NeighbourNodeIndex = Nodes.Add(FNode{ GridCoord + Shift, NeighbourTileCoord, NodeIndex, {} });
+			Nodes[NodeIndex].InterEdgeNodeIndex = NeighbourNodeIndex;
+			BorderNodeIndices.Add(NodeIndex);
+			NeighbourBorderNodeIndices.Add(NeighbourNodeIndex);
+		};
+
+	FIntPoint FirstCell, Step;
+	int32 BorderLength;
+	GetBorderCells(GetTileGridRect(TileCoord), BorderIndex, FirstCell, Step, BorderLength);
+	int32 RunStart = INDEX_NONE;
+	for (int32 CellIndex = 0; CellIndex <= BorderLength; ++CellIndex)
+	{
+		FIntPoint const GridCoord = FirstCell + Step * CellIndex;
+		bool const bIsPassable = CellIndex < BorderLength && !NavGridLayer->IsCellOccupied(GridCoord) && !NeighbourNavGridLayer->IsCellOccupied(GridCoord + Shift);
+		if (bIsPassable && RunStart == INDEX_NONE)
+		{
+			RunStart = CellIndex;
+		}
+		else if (!bIsPassable && RunStart != INDEX_NONE)
+		{
+			int32 const RunLength = CellIndex - RunStart;
+			if (RunLength <= MaxSingleEntranceRunLength)
+			{
+				AddEntrance(FirstCell + Step * (RunStart + RunLength / 2));
+			}
+			else
+			{
+				AddEntrance(FirstCell + Step * RunStart);
+				AddEntrance(FirstCell + Step * (CellIndex - 1));
+			}
+			RunStart = INDEX_NONE;
+		}
+	}
+}
+
+void FCBNavGridAbstractGraph::BuildIntraEdges(FIntPoint const TileCoord) const
+{
+	FCluster const * const Cluster = Clusters.Find(TileCoord);
+	FCBNavGridLayer const * const NavGridLayer = NavGrid.FindTileNavigationData(TileCoord);
+	if (!Cluster || !NavGridLayer)
+	{
+		return;
+	}
+
+	TArray<int32> ClusterNodeIndices;
+	for (TArray<int32> const & BorderNodeIndices : Cluster->BorderNodeIndices)
+	{
+		ClusterNodeIndices.Append(BorderNodeIndices);
+	}
+	for (int32 const NodeIndex : ClusterNodeIndices)
+	{
+		Nodes[NodeIndex].IntraEdges.Reset();
+	}
+
+	FIntRect const TileRect = GetTileGridRect(TileCoord);
+	TArray<int32> Distances;
+	for (int32 FromIndex = 0; FromIndex < ClusterNodeIndices.Num(); ++FromIndex)
+	{
+		int32 const FromNodeIndex = ClusterNodeIndices[FromIndex];
+		CalculateDistancesInTile(*NavGridLayer, TileRect, Nodes[FromNodeIndex].GridCoord, Distances);
+		for (int32 ToIndex = FromIndex + 1; ToIndex < ClusterNodeIndices.Num(); ++ToIndex)
+		{
+			int32 const ToNodeIndex = ClusterNodeIndices[ToIndex];
+			int32 const Distance = Distances[GetCellIndexInTile(TileRect, Nodes[ToNodeIndex].GridCoord)];
+			if (Distance != INDEX_NONE)
+			{
+				Nodes[FromNodeIndex].IntraEdges.Add(FIntraEdge{ ToNodeIndex, Distance });
+				Nodes[ToNodeIndex].IntraEdges.Add(FIntraEdge{ FromNodeIndex, Distance });
+			}
+		}
+	}
+}
+
+void FCBNavGridAbstractGraph::MarkIntraEdgesDirty(FIntPoint const TileCoord, uint32 const BordersMask)
+{
+	DirtyClusters.Add(TileCoord);
+	for (int32 BorderIndex = 0; BorderIndex < BordersNum; ++BorderIndex)
+	{
+		if (BordersMask & (1u << BorderIndex))
+		{
+			DirtyClusters.Add(TileCoord + BorderCrossShifts[BorderIndex]);
+		}
+	}
+}
+
+FIntRect FCBNavGridAbstractGraph::GetTileGridRect(FIntPoint const TileCoord) const
+{
+	FIntPoint const TileSize = NavGrid.GetTileSize();
+	FIntPoint const Min{ TileCoord.X * TileSize.X, TileCoord.Y * TileSize.Y };
+	return FIntRect{ Min, Min + TileSize };
+}
+
+ECBNavGridAStarResult FCBNavGridAbstractGraph::FindAbstractPath(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord, FCBNavGridAStarFilter const & Filter, TArray<FIntPoint> * const OutAbstractPath, int32 & OutVisitedNodesNum) const
+{
+	FRWScopeLock ScopeLock{ Lock, SLT_ReadOnly };
+	if (!DirtyClusters.IsEmpty())
+	{
+		// Stale intra edges may refer to removed nodes, so they are rebuilt before search. Game thread may mark more
+		// tiles dirty while lock is upgraded, so the set is read again under write lock, and search runs under it.
+		ScopeLock.ReleaseReadOnlyLockAndAcquireWriteLock_USE_WITH_CAUTION();
+		for (FIntPoint const TileCoord : DirtyClusters)
+		{
+			BuildIntraEdges(TileCoord);
+		}
+		DirtyClusters.Reset();
+	}
+
+	FIntPoint const StartTileCoord = NavGrid.GetTileCoord(StartGridCoord);
+	FIntPoint const EndTileCoord = NavGrid.GetTileCoord(EndGridCoord);
+	check(StartTileCoord != EndTileCoord);
+	FCBNavGridLayer const * const StartNavGridLayer = NavGrid.FindTileNavigationData(StartTileCoord);
+	FCBNavGridLayer const * const EndNavGridLayer = NavGrid.FindTileNavigationData(EndTileCoord);
+	if (!StartNavGridLayer || !EndNavGridLayer || StartNavGridLayer->IsCellOccupied(StartGridCoord) || EndNavGridLayer->IsCellOccupied(EndGridCoord))
+	{
+		return ECBNavGridAStarResult::SearchFail;
+	}
+
+	FCluster const * const StartCluster = Clusters.Find(StartTileCoord);
+	if (!StartCluster || !Clusters.Contains(EndTileCoord))
+	{
+		return ECBNavGridAStarResult::GoalUnreachable;
+	}
+
+	// Start and end cells are added to the graph as temporary nodes following all graph nodes.
+	int32 const StartNodeIndex = Nodes.GetMaxIndex();
+	int32 const EndNodeIndex = StartNodeIndex + 1;
+	FAbstractSearchContext & Context = GetAbstractSearchContext();
+	Context.BeginSearch(EndNodeIndex + 1);
+
+	FIntRect const StartTileRect = GetTileGridRect(StartTileCoord);
+	FIntRect const EndTileRect = GetTileGridRect(EndTileCoord);
+	CalculateDistancesInTile(*StartNavGridLayer, StartTileRect, StartGridCoord, Context.StartDistances);
+	CalculateDistancesInTile(*EndNavGridLayer, EndTileRect, EndGridCoord, Context.EndDistances);
+
+	auto GetGridCoord = [this, StartNodeIndex, EndNodeIndex, StartGridCoord, EndGridCoord](int32 const NodeIndex)
+		{
+			return NodeIndex == StartNodeIndex ? StartGridCoord : (NodeIndex == EndNodeIndex ? EndGridCoord : Nodes[NodeIndex].GridCoord);
+		};
+
+	FVector::FReal const HeuristicScale = Filter.GetHeuristicScale();
+	FVector::FReal const CostLimit = Filter.GetCostLimit();
+	auto VisitNode = [&Context, &Filter, &GetGridCoord, &OutVisitedNodesNum, EndNodeIndex, EndGridCoord, HeuristicScale, CostLimit](int32 const NodeIndex, int32 const ParentNodeIndex, int32 const TraversalCost)
+		{
+			FAbstractSearchNode & Node = Context.Nodes[NodeIndex];
+			if (Node.SearchStamp != Context.SearchStamp)
+			{
+				Node.SearchStamp = Context.SearchStamp;
+				Node.ParentNodeIndex = INDEX_NONE;
+				Node.TraversalCost = MAX_int32;
+				Node.bIsClosed = false;
+				++OutVisitedNodesNum;
+			}
+			if (Node.bIsClosed || TraversalCost >= Node.TraversalCost)
+			{
+				return;
+			}
+			FVector::FReal const HeuristicCost = NodeIndex == EndNodeIndex ? 0. : Filter.GetHeuristicCost(GetGridCoord(NodeIndex), EndGridCoord) * HeuristicScale;
+			FVector::FReal const TotalCost = TraversalCost + HeuristicCost;
+			if (TotalCost > CostLimit)
+			{
+				return;
+			}
+			Node.TraversalCost = TraversalCost;
+			Node.ParentNodeIndex = ParentNodeIndex;
+			Context.OpenList.HeapPush(FAbstractOpenListEntry{ TotalCost, NodeIndex }, FAbstractOpenListEntryPredicate{});
+		};
+
+	VisitNode(StartNodeIndex, INDEX_NONE, 0);
+	while (!Context.OpenList.IsEmpty())
+	{
+		FAbstractOpenListEntry OpenListEntry;
+		Context.OpenList.HeapPop(OpenListEntry, FAbstractOpenListEntryPredicate{}, EAllowShrinking::No);
+		int32 const NodeIndex = OpenListEntry.NodeIndex;
+		FAbstractSearchNode & Node = Context.Nodes[NodeIndex];
+		if (Node.bIsClosed)
+		{
+			continue;
+		}
+		Node.bIsClosed = true;
+
+		if (NodeIndex == EndNodeIndex)
+		{
+			if (OutAbstractPath)
+			{
+				OutAbstractPath->Reset();
+				for (int32 PathNodeIndex = EndNodeIndex; PathNodeIndex != INDEX_NONE; PathNodeIndex = Context.Nodes[PathNodeIndex].ParentNodeIndex)
+				{
+					OutAbstractPath->Add(GetGridCoord(PathNodeIndex));
+				}
+				Algo::Reverse(*OutAbstractPath);
+			}
+			return ECBNavGridAStarResult::SearchSuccess;
+		}
+
+		int32 const NodeTraversalCost = Node.TraversalCost;
+		if (NodeIndex == StartNodeIndex)
+		{
+			for (TArray<int32> const & BorderNodeIndices : StartCluster->BorderNodeIndices)
+			{
+				for (int32 const BorderNodeIndex : BorderNodeIndices)
+				{
+					int32 const Distance = Context.StartDistances[GetCellIndexInTile(StartTileRect, Nodes[BorderNodeIndex].GridCoord)];
+					if (Distance != INDEX_NONE)
+					{
+						VisitNode(BorderNodeIndex, NodeIndex, NodeTraversalCost + Distance);
+					}
+				}
+			}
+			continue;
+		}
+
+		FNode const & GraphNode = Nodes[NodeIndex];
+		VisitNode(GraphNode.InterEdgeNodeIndex, NodeIndex, NodeTraversalCost + 1);
+		for (FIntraEdge const & IntraEdge : GraphNode.IntraEdges)
+		{
+			VisitNode(IntraEdge.NodeIndex, NodeIndex, NodeTraversalCost + IntraEdge.Cost);
+		}
+		if (GraphNode.TileCoord == EndTileCoord)
+		{
+			int32 const Distance = Context.EndDistances[GetCellIndexInTile(EndTileRect, GraphNode.GridCoord)];
+			if (Distance != INDEX_NONE)
+			{
+				VisitNode(EndNodeIndex, NodeIndex, NodeTraversalCost + Distance);
+			}
+		}
+	}
+
+	return ECBNavGridAStarResult::GoalUnreachable;
+}
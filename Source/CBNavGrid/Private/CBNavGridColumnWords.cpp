@@ -0,0 +1,46 @@
+#include "CBNavGridColumnWords.h"
+#include "CBNavGrid.h"
+
+FCBNavGridColumnWords::FCBNavGridColumnWords(FIntRect const & GridRect)
+	: Origin(GridRect.Min.X, GridRect.Min.Y & ~(BitsPerWordNum - 1))
+	, ColumnsNum(FMath::Max(GridRect.Width(), 0))
+	, WordsPerColumnNum(FMath::Max(FMath::DivideAndRoundUp(GridRect.Max.Y - Origin.Y, BitsPerWordNum), 0))
+{
+}
+
+bool FCBNavGridColumnWords::FindCellWord(FIntPoint const Coord, int32 & OutWordIndex, int32 & OutBit) const
+{
+	FIntPoint const LocalCoord = Coord - Origin;
+	if (LocalCoord.X < 0 || LocalCoord.X >= ColumnsNum || LocalCoord.Y < 0 || LocalCoord.Y >= WordsPerColumnNum * BitsPerWordNum)
+	{
+		return false;
+	}
+	OutWordIndex = GetWordIndex(LocalCoord.X, LocalCoord.Y / BitsPerWordNum);
+	OutBit = LocalCoord.Y % BitsPerWordNum;
+	return true;
+}
+
+void FCBNavGridColumnWords::AddFreeCells(ACBNavGrid const & NavGrid, TArray<WordType> & Words, uint32 const BlockingPlanesMask, uint8 const MinClearance) const
+{
+	check(Words.Num() == GetWordsNum());
+	FCBNavGridReadScope const ReadScope{ NavGrid };
+	// Tile size is multiple of word size, so words match occupancy words of tiles.
+	for (int32 Column = 0; Column < ColumnsNum; ++Column)
+	{
+		FCBNavGridLayer const * Tile = nullptr;
+		bool bAreAllTileCellsFree = false;
+		for (int32 ColumnWordIndex = 0; ColumnWordIndex < WordsPerColumnNum; ++ColumnWordIndex)
+		{
+			FIntPoint const WordMinCoord{ Origin.X + Column, GetWordMinY(ColumnWordIndex) };
+			if (!Tile || !Tile->IsInGrid(WordMinCoord))
+			{
+				Tile = NavGrid.FindTileNavigationData(NavGrid.GetTileCoord(WordMinCoord));
+				bAreAllTileCellsFree = Tile && Tile->AreAllCellsFree(BlockingPlanesMask, MinClearance);
+			}
+			if (Tile)
+			{
+				Words[GetWordIndex(Column, ColumnWordIndex)] |= bAreAllTileCellsFree ? FCBNavGridLayer::FullWordMask : ~Tile->GetOccupancyWord(WordMinCoord, BlockingPlanesMask, MinClearance);
+			}
+		}
+	}
+}
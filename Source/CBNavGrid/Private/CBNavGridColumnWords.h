@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CBNavGridLayer.h"
+#include "CoreMinimal.h"
+
+class ACBNavGrid;
+
+/**
+ * Layout of rect of grid cells kept in column words, words are laid out like words of FCBBitGridLayer and rect is
+ * extended along Y to whole words. Shared by word parallel algorithms, which keep their own arrays of such words.
+ */
+class FCBNavGridColumnWords
+{
+protected:
+	using WordType = FCBNavGridLayer::WordType;
+
+	static constexpr int32 BitsPerWordNum = static_cast<int32>(FCBNavGridLayer::BitsPerWordNum);
+
+	explicit FCBNavGridColumnWords(FIntRect const & GridRect);
+
+	FORCEINLINE int32 GetWordsNum() const;
+	FORCEINLINE int32 GetWordIndex(int32 const Column, int32 const ColumnWordIndex) const;
+	FORCEINLINE int32 GetWordMinY(int32 const ColumnWordIndex) const;
+
+	/** Returns false if cell is out of extended rect, otherwise outputs index of its word and its bit in the word. */
+	bool FindCellWord(FIntPoint const Coord, int32 & OutWordIndex, int32 & OutBit) const;
+
+	/**
+	 * Sets bits of free cells of nav grid in Words, bits of cells of missing tiles are left as is. Cells blocked by
+	 * selected blocking planes or with clearance less than MinClearance aren't free, see FCBNavGridLayer::GetOccupancyWord.
+	 */
+	void AddFreeCells(ACBNavGrid const & NavGrid, TArray<WordType> & Words, uint32 const BlockingPlanesMask = 0, uint8 const MinClearance = 0) const;
+
+	FIntPoint Origin;
+	int32 ColumnsNum;
+	int32 WordsPerColumnNum;
+};
+
+int32 FCBNavGridColumnWords::GetWordsNum() const
+{
+	return ColumnsNum * WordsPerColumnNum;
+}
+
+int32 FCBNavGridColumnWords::GetWordIndex(int32 const Column, int32 const ColumnWordIndex) const
+{
+	return Column * WordsPerColumnNum + ColumnWordIndex;
+}
+
+int32 FCBNavGridColumnWords::GetWordMinY(int32 const ColumnWordIndex) const
+{
+	return Origin.Y + ColumnWordIndex * BitsPerWordNum;
+}
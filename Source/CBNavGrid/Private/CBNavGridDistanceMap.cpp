@@ -0,0 +1,298 @@
+#include "CBNavGridDistanceMap.h"
+#include "CBGridUtilities.h"
+#include "CBNavGrid.h"
+
+namespace
+{
+	constexpr int32 BitsPerWordNum = static_cast<int32>(FCBNavGridLayer::BitsPerWordNum);
+} // namespace
+
+FCBNavGridDistanceMap::FCBNavGridDistanceMap(ACBNavGrid const & InNavGrid, FIntRect const & InGridRect, uint16 const InMaxDistance)
+	: NavGrid(InNavGrid)
+	, GridRect(InGridRect)
+	, TileSize(InNavGrid.GetTileSize())
+	, MaxDistance(FMath::Min<uint16>(InMaxDistance, UnreachedDistance - 1))
+{
+}
+
+void FCBNavGridDistanceMap::AddSource(FIntPoint const GridCoord)
+{
+	FCBNavGridReadScope const ReadScope{ NavGrid };
+	if (Sources.Contains(GridCoord))
+	{
+		return;
+	}
+	Sources.Add(GridCoord);
+	if (IsCellFree(GridCoord))
+	{
+		SetDistance(GridCoord, 0);
+		TArray<FOpenCell> Seeds{ FOpenCell{ GridCoord, 0 } };
+		Propagate(Seeds);
+	}
+}
+
+void FCBNavGridDistanceMap::RemoveSource(FIntPoint const GridCoord)
+{
+	FCBNavGridReadScope const ReadScope{ NavGrid };
+	if (Sources.Remove(GridCoord) == 0 || GetDistance(GridCoord) != 0)
+	{
+		return;
+	}
+	TArray<FIntPoint> DependentGridCoords;
+	CollectDependentCells(MakeArrayView(&GridCoord, 1), DependentGridCoords);
+	Repair(DependentGridCoords);
+}
+
+TConstArrayView<FIntPoint> FCBNavGridDistanceMap::GetSources() const
+{
+	return Sources;
+}
+
+void FCBNavGridDistanceMap::OnTileChanged(FIntPoint const TileCoord)
+{
+	FCBNavGridReadScope const ReadScope{ NavGrid };
+	FIntRect TileGridRect{ TileCoord * TileSize, (TileCoord + FIntPoint{ 1, 1 }) * TileSize };
+	TileGridRect.Clip(GridRect);
+	if (TileGridRect.Width() <= 0 || TileGridRect.Height() <= 0)
+	{
+		return;
+	}
+
+	// Cells freed in the tile have no distances yet, they are reset too, so they are refilled from their neighbours.
+	TArray<FIntPoint> TileGridCoords;
+	TileGridCoords.Reserve(TileGridRect.Area());
+	for (int32 X = TileGridRect.Min.X; X < TileGridRect.Max.X; ++X)
+	{
+		for (int32 Y = TileGridRect.Min.Y; Y < TileGridRect.Max.Y; ++Y)
+		{
+			TileGridCoords.Add(FIntPoint{ X, Y });
+		}
+	}
+	TArray<FIntPoint> ResetGridCoords;
+	CollectDependentCells(TileGridCoords, ResetGridCoords);
+	for (FIntPoint const GridCoord : TileGridCoords)
+	{
+		// Reached cells of the tile are already collected as roots.
+		if (!IsCellCovered(GridCoord))
+		{
+			ResetGridCoords.Add(GridCoord);
+		}
+	}
+	Repair(ResetGridCoords);
+}
+
+void FCBNavGridDistanceMap::Rebuild()
+{
+	FCBNavGridReadScope const ReadScope{ NavGrid };
+	Tiles.Reset();
+	TArray<FOpenCell> Seeds;
+	for (FIntPoint const SourceGridCoord : Sources)
+	{
+		if (IsCellFree(SourceGridCoord))
+		{
+			SetDistance(SourceGridCoord, 0);
+			Seeds.Add(FOpenCell{ SourceGridCoord, 0 });
+		}
+	}
+	Propagate(Seeds);
+}
+
+uint16 FCBNavGridDistanceMap::GetDistance(FIntPoint const GridCoord) const
+{
+	if (!GridRect.Contains(GridCoord))
+	{
+		return UnreachedDistance;
+	}
+	FIntPoint const TileCoord = CBGridUtilities::GetTileCoord(GridCoord, TileSize);
+	FTileDistances const * const TileDistances = Tiles.Find(TileCoord);
+	if (!TileDistances)
+	{
+		return UnreachedDistance;
+	}
+	FIntPoint const CoordInTile = GridCoord - TileCoord * TileSize;
+	return TileDistances->Distances[CoordInTile.X * TileSize.Y + CoordInTile.Y];
+}
+
+bool FCBNavGridDistanceMap::IsCellCovered(FIntPoint const GridCoord) const
+{
+	return GetDistance(GridCoord) != UnreachedDistance;
+}
+
+FCBNavGridDistanceMap::WordType FCBNavGridDistanceMap::GetCoverageWord(FIntPoint const GridCoord) const
+{
+	FIntPoint const TileCoord = CBGridUtilities::GetTileCoord(GridCoord, TileSize);
+	FTileDistances const * const TileDistances = Tiles.Find(TileCoord);
+	if (!TileDistances)
+	{
+		return 0;
+	}
+	FIntPoint const CoordInTile = GridCoord - TileCoord * TileSize;
+	return TileDistances->CoverageWords[CoordInTile.X * (TileSize.Y / BitsPerWordNum) + CoordInTile.Y / BitsPerWordNum];
+}
+
+FIntRect const & FCBNavGridDistanceMap::GetGridRect() const
+{
+	return GridRect;
+}
+
+uint16 FCBNavGridDistanceMap::GetMaxDistance() const
+{
+	return MaxDistance;
+}
+
+bool FCBNavGridDistanceMap::IsCellFree(FIntPoint const GridCoord) const
+{
+	if (!GridRect.Contains(GridCoord))
+	{
+		return false;
+	}
+	FCBNavGridLayer const * const Tile = NavGrid.FindTileNavigationData(NavGrid.GetTileCoord(GridCoord));
+	return Tile && !Tile->IsCellOccupied(GridCoord);
+}
+
+void FCBNavGridDistanceMap::SetDistance(FIntPoint const GridCoord, uint16 const Distance)
+{
+	FIntPoint const TileCoord = CBGridUtilities::GetTileCoord(GridCoord, TileSize);
+	FTileDistances * TileDistances = Tiles.Find(TileCoord);
+	if (!TileDistances)
+	{
+		if (Distance == UnreachedDistance)
+		{
+			return;
+		}
+		TileDistances = &Tiles.Add(TileCoord);
+		TileDistances->Distances.Init(UnreachedDistance, TileSize.X * TileSize.Y);
+		TileDistances->CoverageWords.SetNumZeroed(TileSize.X * (TileSize.Y / BitsPerWordNum));
+	}
+
+	FIntPoint const CoordInTile = GridCoord - TileCoord * TileSize;
+	TileDistances->Distances[CoordInTile.X * TileSize.Y + CoordInTile.Y] = Distance;
+	WordType & CoverageWord = TileDistances->CoverageWords[CoordInTile.X * (TileSize.Y / BitsPerWordNum) + CoordInTile.Y / BitsPerWordNum];
+	WordType const CellMask = WordType{ 1 } << (CoordInTile.Y % BitsPerWordNum);
+	CoverageWord = Distance == UnreachedDistance ? CoverageWord & ~CellMask : CoverageWord | CellMask;
+}
+
+void FCBNavGridDistanceMap::Propagate(TArray<FOpenCell> & Seeds)
+{
+	// Steps cost 1, so cells are expanded in order of distance by merging sorted seeds with FIFO queue of reached
+	// cells, which distances never decrease. Entries outdated by shorter distances found later are skipped.
+	Seeds.Sort([](FOpenCell const & A, FOpenCell const & B)
+		{
+			return A.Distance < B.Distance;
+		});
+	TArray<FOpenCell> OpenList;
+	int32 SeedIndex = 0;
+	int32 OpenIndex = 0;
+	while (SeedIndex < Seeds.Num() || OpenIndex < OpenList.Num())
+	{
+		bool const bPopSeed = OpenIndex >= OpenList.Num() || (SeedIndex < Seeds.Num() && Seeds[SeedIndex].Distance <= OpenList[OpenIndex].Distance);
+		FOpenCell const Cell = bPopSeed ? Seeds[SeedIndex++] : OpenList[OpenIndex++];
+		if (Cell.Distance >= MaxDistance || GetDistance(Cell.GridCoord) != Cell.Distance)
+		{
+			continue;
+		}
+
+		uint16 const AdjacentDistance = Cell.Distance + 1;
+		for (ECBGridDirection const GridDirection : TEnumRange<ECBGridDirection>())
+		{
+			FIntPoint const AdjacentGridCoord = CBGridUtilities::GetAdjacentCoordChecked(Cell.GridCoord, GridDirection);
+			if (AdjacentDistance < GetDistance(AdjacentGridCoord) && IsCellFree(AdjacentGridCoord))
+			{
+				SetDistance(AdjacentGridCoord, AdjacentDistance);
+				OpenList.Add(FOpenCell{ AdjacentGridCoord, AdjacentDistance });
+			}
+		}
+	}
+}
+
+void FCBNavGridDistanceMap::CollectDependentCells(TConstArrayView<FIntPoint> const RootGridCoords, TArray<FIntPoint> & OutGridCoords)
+{
+	// Bumped stamp unmarks cells collected by previous calls, stamps are cleared once it wraps around.
+	if (++CollectStamp == 0)
+	{
+		for (TPair<FIntPoint, FTileDistances> & Tile : Tiles)
+		{
+			Tile.Value.CollectStamps.Empty();
+		}
+		CollectStamp = 1;
+	}
+
+	// If any shortest path of a cell goes through a root, every step of it after the root increases distance by one.
+	TArray<FIntPoint> OpenList;
+	for (FIntPoint const RootGridCoord : RootGridCoords)
+	{
+		if (MarkCollected(RootGridCoord))
+		{
+			OutGridCoords.Add(RootGridCoord);
+			OpenList.Add(RootGridCoord);
+		}
+	}
+	while (!OpenList.IsEmpty())
+	{
+		FIntPoint const GridCoord = OpenList.Pop(EAllowShrinking::No);
+		uint16 const NextDistance = GetDistance(GridCoord) + 1;
+		for (ECBGridDirection const GridDirection : TEnumRange<ECBGridDirection>())
+		{
+			FIntPoint const AdjacentGridCoord = CBGridUtilities::GetAdjacentCoordChecked(GridCoord, GridDirection);
+			if (GetDistance(AdjacentGridCoord) == NextDistance && MarkCollected(AdjacentGridCoord))
+			{
+				OutGridCoords.Add(AdjacentGridCoord);
+				OpenList.Add(AdjacentGridCoord);
+			}
+		}
+	}
+}
+
+bool FCBNavGridDistanceMap::MarkCollected(FIntPoint const GridCoord)
+{
+	if (!IsCellCovered(GridCoord))
+	{
+		return false;
+	}
+	FIntPoint const TileCoord = CBGridUtilities::GetTileCoord(GridCoord, TileSize);
+	FTileDistances & TileDistances = Tiles.FindChecked(TileCoord);
+	if (TileDistances.CollectStamps.IsEmpty())
+	{
+		TileDistances.CollectStamps.SetNumZeroed(TileDistances.Distances.Num());
+	}
+	FIntPoint const CoordInTile = GridCoord - TileCoord * TileSize;
+	uint32 & Stamp = TileDistances.CollectStamps[CoordInTile.X * TileSize.Y + CoordInTile.Y];
+	if (Stamp == CollectStamp)
+	{
+		return false;
+	}
+	Stamp = CollectStamp;
+	return true;
+}
+
+void FCBNavGridDistanceMap::Repair(TConstArrayView<FIntPoint> const ResetGridCoords)
+{
+	for (FIntPoint const GridCoord : ResetGridCoords)
+	{
+		SetDistance(GridCoord, UnreachedDistance);
+	}
+
+	TArray<FOpenCell> Seeds;
+	for (FIntPoint const GridCoord : ResetGridCoords)
+	{
+		for (ECBGridDirection const GridDirection : TEnumRange<ECBGridDirection>())
+		{
+			FIntPoint const AdjacentGridCoord = CBGridUtilities::GetAdjacentCoordChecked(GridCoord, GridDirection);
+			uint16 const AdjacentDistance = GetDistance(AdjacentGridCoord);
+			if (AdjacentDistance != UnreachedDistance)
+			{
+				Seeds.Add(FOpenCell{ AdjacentGridCoord, AdjacentDistance });
+			}
+		}
+	}
+	// Free sources keep distance 0 unless they are reset.
+	for (FIntPoint const SourceGridCoord : Sources)
+	{
+		if (GetDistance(SourceGridCoord) != 0 && IsCellFree(SourceGridCoord))
+		{
+			SetDistance(SourceGridCoord, 0);
+			Seeds.Add(FOpenCell{ SourceGridCoord, 0 });
+		}
+	}
+	Propagate(Seeds);
+}
@@ -0,0 +1,102 @@
+#include "CBNavGridErosion.h"
+
+FCBNavGridErosion::FCBNavGridErosion(FIntRect const & GridRect)
+	: FCBNavGridColumnWords(GridRect)
+{
+	FreeWords.SetNumZeroed(GetWordsNum());
+}
+
+void FCBNavGridErosion::AddFreeCells(ACBNavGrid const & NavGrid, uint32 const BlockingPlanesMask, uint8 const MinClearance)
+{
+	FCBNavGridColumnWords::AddFreeCells(NavGrid, FreeWords, BlockingPlanesMask, MinClearance);
+}
+
+void FCBNavGridErosion::ErodeByRect(FIntPoint const FootprintSize)
+{
+	check(FootprintSize.X > 0 && FootprintSize.Y > 0);
+	ErodeColumns(FootprintSize.Y);
+	ErodeRows(FootprintSize.X);
+}
+
+void FCBNavGridErosion::ErodeByMask(FIntPoint const FootprintSize, TBitArray<> const & FootprintMask)
+{
+	check(FootprintSize.X > 0 && FootprintSize.Y > 0 && FootprintMask.Num() == FootprintSize.X * FootprintSize.Y);
+	TArray<WordType> const SourceWords = FreeWords;
+	FreeWords.Init(FCBNavGridLayer::FullWordMask, SourceWords.Num());
+	for (TConstSetBitIterator<> It{ FootprintMask }; It; ++It)
+	{
+		FIntPoint const Offset{ It.GetIndex() / FootprintSize.Y, It.GetIndex() % FootprintSize.Y };
+		for (int32 Column = 0; Column < ColumnsNum; ++Column)
+		{
+			for (int32 ColumnWordIndex = 0; ColumnWordIndex < WordsPerColumnNum; ++ColumnWordIndex)
+			{
+				FreeWords[GetWordIndex(Column, ColumnWordIndex)] &= GetShiftedWord(SourceWords, Column + Offset.X, ColumnWordIndex, Offset.Y);
+			}
+		}
+	}
+}
+
+bool FCBNavGridErosion::IsCellFree(FIntPoint const Coord) const
+{
+	int32 WordIndex, Bit;
+	return FindCellWord(Coord, WordIndex, Bit) && ((FreeWords[WordIndex] >> Bit) & 1u);
+}
+
+FCBNavGridErosion::WordType FCBNavGridErosion::GetShiftedWord(TArray<WordType> const & Words, int32 const Column, int32 const ColumnWordIndex, int32 const Shift) const
+{
+	check(Shift >= 0);
+	if (Column >= ColumnsNum)
+	{
+		return 0;
+	}
+
+	auto GetColumnWord = [this, &Words, Column](int32 const Index) -> WordType
+		{
+			return Index < WordsPerColumnNum ? Words[GetWordIndex(Column, Index)] : 0;
+		};
+
+	int32 const FirstWordIndex = ColumnWordIndex + Shift / BitsPerWordNum;
+	int32 const BitShift = Shift % BitsPerWordNum;
+	WordType Word = GetColumnWord(FirstWordIndex) >> BitShift;
+	if (BitShift > 0)
+	{
+		Word |= GetColumnWord(FirstWordIndex + 1) << (BitsPerWordNum - BitShift);
+	}
+	return Word;
+}
+
+void FCBNavGridErosion::ErodeColumns(int32 const Length)
+{
+	// AND of window with itself shifted by at most its length grows the window by the shift, so passes are logarithmic.
+	// Shifted words are read from higher indices only, which aren't updated yet by the ascending pass.
+	for (int32 WindowLength = 1; WindowLength < Length;)
+	{
+		int32 const Shift = FMath::Min(WindowLength, Length - WindowLength);
+		for (int32 Column = 0; Column < ColumnsNum; ++Column)
+		{
+			for (int32 ColumnWordIndex = 0; ColumnWordIndex < WordsPerColumnNum; ++ColumnWordIndex)
+			{
+				FreeWords[GetWordIndex(Column, ColumnWordIndex)] &= GetShiftedWord(FreeWords, Column, ColumnWordIndex, Shift);
+			}
+		}
+		WindowLength += Shift;
+	}
+}
+
+void FCBNavGridErosion::ErodeRows(int32 const Length)
+{
+	for (int32 WindowLength = 1; WindowLength < Length;)
+	{
+		int32 const Shift = FMath::Min(WindowLength, Length - WindowLength);
+		for (int32 Column = 0; Column < ColumnsNum; ++Column)
+		{
+			bool const bHasShiftedColumn = Column + Shift < ColumnsNum;
+			for (int32 ColumnWordIndex = 0; ColumnWordIndex < WordsPerColumnNum; ++ColumnWordIndex)
+			{
+				WordType const ShiftedWord = bHasShiftedColumn ? FreeWords[GetWordIndex(Column + Shift, ColumnWordIndex)] : 0;
+				FreeWords[GetWordIndex(Column, ColumnWordIndex)] &= ShiftedWord;
+			}
+		}
+		WindowLength += Shift;
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CBNavGridColumnWords.h"
+#include "CoreMinimal.h"
+
+/**
+ * Free cells of rect of grid cells eroded by footprint. Cells are kept in column words. Erosion ANDs words shifted
+ * along Y and whole columns shifted along X, so every pass tests a word of footprint positions at once.
+ */
+class FCBNavGridErosion : protected FCBNavGridColumnWords
+{
+public:
+	using WordType = FCBNavGridLayer::WordType;
+
+	/** All cells are occupied initially. */
+	explicit FCBNavGridErosion(FIntRect const & GridRect);
+
+	/** Marks free cells of nav grid as free, cells of missing tiles are left occupied. */
+	void AddFreeCells(ACBNavGrid const & NavGrid, uint32 const BlockingPlanesMask = 0, uint8 const MinClearance = 0);
+
+	/** Keeps cell free only if all cells of rect of FootprintSize with min corner at the cell are free. */
+	void ErodeByRect(FIntPoint const FootprintSize);
+
+	/**
+	 * Keeps cell free only if all footprint cells placed with min corner at the cell are free. Footprint cells are set
+	 * bits of FootprintMask, which covers rect of FootprintSize in column-major order.
+	 */
+	void ErodeByMask(FIntPoint const FootprintSize, TBitArray<> const & FootprintMask);
+
+	/** Cells out of rect are reported as occupied. */
+	bool IsCellFree(FIntPoint const Coord) const;
+
+private:
+	/** Returns word of Words with cells shifted towards lower Y by Shift cells, cells out of rect are occupied. */
+	WordType GetShiftedWord(TArray<WordType> const & Words, int32 const Column, int32 const ColumnWordIndex, int32 const Shift) const;
+
+	/** Keeps cell free only if Length cells starting at the cell along Y are free. */
+	void ErodeColumns(int32 const Length);
+
+	/** Keeps cell free only if Length cells starting at the cell along X are free. */
+	void ErodeRows(int32 const Length);
+
+	TArray<WordType> FreeWords;
+};
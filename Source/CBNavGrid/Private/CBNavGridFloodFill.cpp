@@ -0,0 +1,224 @@
+#include "CBNavGridFloodFill.h"
+
+namespace
+{
+	using WordType = FCBNavGridFloodFill::WordType;
+
+	/** Spreads seeds towards higher bits through bits set in mask, bit of mask is set if cell is enterable from the lower bit. */
+	WordType FillUp(WordType Seeds, WordType Mask)
+	{
+		Seeds |= Mask & (Seeds << 1);
+		Mask &= Mask << 1;
+		Seeds |= Mask & (Seeds << 2);
+		Mask &= Mask << 2;
+		Seeds |= Mask & (Seeds << 4);
+		Mask &= Mask << 4;
+		Seeds |= Mask & (Seeds << 8);
+		Mask &= Mask << 8;
+		return Seeds | (Mask & (Seeds << 16));
+	}
+
+	/** Spreads seeds towards lower bits through bits set in mask, bit of mask is set if cell is enterable from the higher bit. */
+	WordType FillDown(WordType Seeds, WordType Mask)
+	{
+		Seeds |= Mask & (Seeds >> 1);
+		Mask &= Mask >> 1;
+		Seeds |= Mask & (Seeds >> 2);
+		Mask &= Mask >> 2;
+		Seeds |= Mask & (Seeds >> 4);
+		Mask &= Mask >> 4;
+		Seeds |= Mask & (Seeds >> 8);
+		Mask &= Mask >> 8;
+		return Seeds | (Mask & (Seeds >> 16));
+	}
+} // namespace
+
+FCBNavGridFloodFill::FCBNavGridFloodFill(FIntRect const & GridRect)
+	: FCBNavGridColumnWords(GridRect)
+{
+	int32 const WordsNum = GetWordsNum();
+	PassableWords.SetNumZeroed(WordsNum);
+	ReachedWords.SetNumZeroed(WordsNum);
+	YEdgesWords.Init(FCBNavGridLayer::FullWordMask, WordsNum);
+	XEdgesWords.Init(FCBNavGridLayer::FullWordMask, WordsNum);
+}
+
+void FCBNavGridFloodFill::AddFreeCells(ACBNavGrid const & NavGrid, uint32 const BlockingPlanesMask, uint8 const MinClearance)
+{
+	FCBNavGridColumnWords::AddFreeCells(NavGrid, PassableWords, BlockingPlanesMask, MinClearance);
+}
+
+void FCBNavGridFloodFill::ClipColumn(int32 const X, int32 const MinY, int32 const MaxY)
+{
+	int32 const Column = X - Origin.X;
+	if (Column < 0 || Column >= ColumnsNum)
+	{
+		return;
+	}
+	for (int32 ColumnWordIndex = 0; ColumnWordIndex < WordsPerColumnNum; ++ColumnWordIndex)
+	{
+		PassableWords[GetWordIndex(Column, ColumnWordIndex)] &= GetRangeMask(ColumnWordIndex, MinY, MaxY);
+	}
+}
+
+void FCBNavGridFloodFill::SetColumnOpenEdges(int32 const X, int32 const MinYEdgeY, int32 const MaxYEdgeY, int32 const MinXEdgeY, int32 const MaxXEdgeY)
+{
+	int32 const Column = X - Origin.X;
+	if (Column < 0 || Column >= ColumnsNum)
+	{
+		return;
+	}
+	for (int32 ColumnWordIndex = 0; ColumnWordIndex < WordsPerColumnNum; ++ColumnWordIndex)
+	{
+		int32 const WordIndex = GetWordIndex(Column, ColumnWordIndex);
+		YEdgesWords[WordIndex] = GetRangeMask(ColumnWordIndex, MinYEdgeY, MaxYEdgeY);
+		XEdgesWords[WordIndex] = GetRangeMask(ColumnWordIndex, MinXEdgeY, MaxXEdgeY);
+	}
+}
+
+void FCBNavGridFloodFill::AddSeed(FIntPoint const Coord)
+{
+	int32 WordIndex, Bit;
+	if (!FindCellWord(Coord, WordIndex, Bit))
+	{
+		return;
+	}
+	ReachedWords[WordIndex] |= WordType{ 1 } << Bit;
+	SeedColumns.AddUnique(Coord.X - Origin.X);
+}
+
+void FCBNavGridFloodFill::Fill()
+{
+	TArray<int32> OpenColumns;
+	TBitArray<> OpenColumnsMask{ false, ColumnsNum };
+	auto OpenColumn = [this, &OpenColumns, &OpenColumnsMask](int32 const Column)
+		{
+			if (Column >= 0 && Column < ColumnsNum && !OpenColumnsMask[Column])
+			{
+				OpenColumnsMask[Column] = true;
+				OpenColumns.Add(Column);
+			}
+		};
+
+	for (int32 const SeedColumn : SeedColumns)
+	{
+		OpenColumn(SeedColumn - 1);
+		OpenColumn(SeedColumn);
+		OpenColumn(SeedColumn + 1);
+	}
+
+	while (!OpenColumns.IsEmpty())
+	{
+		int32 const Column = OpenColumns.Pop(EAllowShrinking::No);
+		OpenColumnsMask[Column] = false;
+		if (FillColumn(Column))
+		{
+			OpenColumn(Column - 1);
+			OpenColumn(Column + 1);
+		}
+	}
+}
+
+int32 FCBNavGridFloodFill::GetReachedCellsNum() const
+{
+	int32 ReachedCellsNum = 0;
+	for (WordType const Reached : ReachedWords)
+	{
+		ReachedCellsNum += static_cast<int32>(FMath::CountBits(Reached));
+	}
+	return ReachedCellsNum;
+}
+
+FIntPoint FCBNavGridFloodFill::GetReachedCell(int32 const ReachedCellIndex) const
+{
+	int32 CellsToSkipNum = ReachedCellIndex;
+	for (int32 WordIndex = 0; WordIndex < ReachedWords.Num(); ++WordIndex)
+	{
+		WordType Reached = ReachedWords[WordIndex];
+		int32 const WordReachedCellsNum = static_cast<int32>(FMath::CountBits(Reached));
+		if (CellsToSkipNum >= WordReachedCellsNum)
+		{
+			CellsToSkipNum -= WordReachedCellsNum;
+			continue;
+		}
+		for (; CellsToSkipNum > 0; --CellsToSkipNum)
+		{
+			Reached &= Reached - 1;
+		}
+		int32 const Column = WordIndex / WordsPerColumnNum;
+		int32 const ColumnWordIndex = WordIndex % WordsPerColumnNum;
+		return FIntPoint{ Origin.X + Column, GetWordMinY(ColumnWordIndex) + static_cast<int32>(FMath::CountTrailingZeros(Reached)) };
+	}
+	checkNoEntry();
+	return Origin;
+}
+
+FCBNavGridFloodFill::WordType FCBNavGridFloodFill::GetRangeMask(int32 const ColumnWordIndex, int32 const MinY, int32 const MaxY) const
+{
+	int32 const WordMinY = GetWordMinY(ColumnWordIndex);
+	int32 const WordMaxY = WordMinY + BitsPerWordNum - 1;
+	if (MinY > MaxY || MaxY < WordMinY || MinY > WordMaxY)
+	{
+		return 0;
+	}
+	WordType Mask = FCBNavGridLayer::FullWordMask;
+	if (MinY > WordMinY)
+	{
+		Mask &= Mask << (MinY - WordMinY);
+	}
+	if (MaxY < WordMaxY)
+	{
+		Mask &= FCBNavGridLayer::FullWordMask >> (WordMaxY - MaxY);
+	}
+	return Mask;
+}
+
+bool FCBNavGridFloodFill::FillColumn(int32 const Column)
+{
+	bool bIsChanged = false;
+	auto UpdateReached = [this, &bIsChanged](int32 const WordIndex, WordType const NewReached)
+		{
+			bIsChanged |= NewReached != ReachedWords[WordIndex];
+			ReachedWords[WordIndex] = NewReached;
+		};
+
+	// Reached cells of adjacent columns enter this column through open edges.
+	for (int32 ColumnWordIndex = 0; ColumnWordIndex < WordsPerColumnNum; ++ColumnWordIndex)
+	{
+		int32 const WordIndex = GetWordIndex(Column, ColumnWordIndex);
+		WordType Incoming = 0;
+		if (Column > 0)
+		{
+			Incoming |= ReachedWords[WordIndex - WordsPerColumnNum] & XEdgesWords[WordIndex];
+		}
+		if (Column + 1 < ColumnsNum)
+		{
+			Incoming |= ReachedWords[WordIndex + WordsPerColumnNum] & XEdgesWords[WordIndex + WordsPerColumnNum];
+		}
+		UpdateReached(WordIndex, ReachedWords[WordIndex] | (Incoming & PassableWords[WordIndex]));
+	}
+
+	// Upward sweep carries top cell of every word into the bottom cell of the next one, downward sweep does the opposite.
+	WordType Carry = 0;
+	for (int32 ColumnWordIndex = 0; ColumnWordIndex < WordsPerColumnNum; ++ColumnWordIndex)
+	{
+		int32 const WordIndex = GetWordIndex(Column, ColumnWordIndex);
+		WordType const UpMask = PassableWords[WordIndex] & YEdgesWords[WordIndex];
+		WordType const NewReached = FillUp(ReachedWords[WordIndex] | (Carry & UpMask), UpMask);
+		UpdateReached(WordIndex, NewReached);
+		Carry = NewReached >> (BitsPerWordNum - 1);
+	}
+
+	Carry = 0;
+	for (int32 ColumnWordIndex = WordsPerColumnNum - 1; ColumnWordIndex >= 0; --ColumnWordIndex)
+	{
+		int32 const WordIndex = GetWordIndex(Column, ColumnWordIndex);
+		WordType const NextWordEdges = ColumnWordIndex + 1 < WordsPerColumnNum ? YEdgesWords[WordIndex + 1] << (BitsPerWordNum - 1) : 0;
+		WordType const DownMask = PassableWords[WordIndex] & ((YEdgesWords[WordIndex] >> 1) | NextWordEdges);
+		WordType const NewReached = FillDown(ReachedWords[WordIndex] | (Carry & DownMask), DownMask);
+		UpdateReached(WordIndex, NewReached);
+		Carry = NewReached << (BitsPerWordNum - 1);
+	}
+
+	return bIsChanged;
+}
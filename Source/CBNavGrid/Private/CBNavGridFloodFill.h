@@ -0,0 +1,105 @@
+#pragma once
+
+#include "CBGridUtilities.h"
+#include "CBNavGridColumnWords.h"
+#include "CoreMinimal.h"
+
+/**
+ * Flood fill over rect of grid cells. Passable, reached and open edge states are kept in column words. Fill spreads
+ * through a word with shifted masks and to adjacent columns with ANDs of whole words, columns are refilled until
+ * wavefront stops changing.
+ */
+class FCBNavGridFloodFill : protected FCBNavGridColumnWords
+{
+public:
+	using WordType = FCBNavGridLayer::WordType;
+
+	/** All cells are impassable and all edges are open initially. */
+	explicit FCBNavGridFloodFill(FIntRect const & GridRect);
+
+	/** Makes free cells of nav grid passable, cells of missing tiles are left impassable. */
+	void AddFreeCells(ACBNavGrid const & NavGrid, uint32 const BlockingPlanesMask = 0, uint8 const MinClearance = 0);
+
+	/** Makes cells of column X out of [MinY, MaxY] impassable. */
+	void ClipColumn(int32 const X, int32 const MinY, int32 const MaxY);
+
+	/**
+	 * Closes all edges of column X except edges between cells (X, Y - 1) and (X, Y) with Y in [MinYEdgeY, MaxYEdgeY]
+	 * and edges between cells (X - 1, Y) and (X, Y) with Y in [MinXEdgeY, MaxXEdgeY].
+	 */
+	void SetColumnOpenEdges(int32 const X, int32 const MinYEdgeY, int32 const MaxYEdgeY, int32 const MinXEdgeY, int32 const MaxXEdgeY);
+
+	/** Seed is reached even if it is impassable, seeds out of rect are ignored. */
+	void AddSeed(FIntPoint const Coord);
+	void Fill();
+
+	int32 GetReachedCellsNum() const;
+
+	/** Returns reached cell with specified index in column-major order. */
+	FIntPoint GetReachedCell(int32 const ReachedCellIndex) const;
+
+	/** Calls Visitor with coord of reached cell and direction of every its open edge leading to impassable cell. */
+	template <typename TVisitor>
+	void ForEachBoundaryEdge(TVisitor && Visitor) const;
+
+private:
+	/** Returns mask of cells of the word with Y in [MinY, MaxY]. */
+	WordType GetRangeMask(int32 const ColumnWordIndex, int32 const MinY, int32 const MaxY) const;
+
+	/** Pulls reached cells from adjacent columns and spreads them along the column, returns true if column changed. */
+	bool FillColumn(int32 const Column);
+
+	TArray<WordType> PassableWords;
+	TArray<WordType> ReachedWords;
+
+	/** Bit of cell is set if edge between the cell and the cell below it is open. */
+	TArray<WordType> YEdgesWords;
+
+	/** Bit of cell is set if edge between the cell and the cell of previous column is open. */
+	TArray<WordType> XEdgesWords;
+	TArray<int32> SeedColumns;
+};
+
+template <typename TVisitor>
+void FCBNavGridFloodFill::ForEachBoundaryEdge(TVisitor && Visitor) const
+{
+	auto VisitCells = [this, &Visitor](int32 const Column, int32 const ColumnWordIndex, WordType Cells, ECBGridDirection const GridDirection)
+		{
+			while (Cells != 0)
+			{
+				int32 const Bit = static_cast<int32>(FMath::CountTrailingZeros(Cells));
+				Cells &= Cells - 1;
+				Visitor(FIntPoint{ Origin.X + Column, GetWordMinY(ColumnWordIndex) + Bit }, GridDirection);
+			}
+		};
+
+	for (int32 Column = 0; Column < ColumnsNum; ++Column)
+	{
+		for (int32 ColumnWordIndex = 0; ColumnWordIndex < WordsPerColumnNum; ++ColumnWordIndex)
+		{
+			int32 const WordIndex = GetWordIndex(Column, ColumnWordIndex);
+			WordType const Reached = ReachedWords[WordIndex];
+			if (Reached == 0)
+			{
+				continue;
+			}
+
+			bool const bHasPrevWord = ColumnWordIndex > 0;
+			bool const bHasNextWord = ColumnWordIndex + 1 < WordsPerColumnNum;
+			WordType const Passable = PassableWords[WordIndex];
+			WordType const YEdges = YEdgesWords[WordIndex];
+			WordType const AbovePassable = (Passable >> 1) | (bHasNextWord ? PassableWords[WordIndex + 1] << (BitsPerWordNum - 1) : 0);
+			WordType const AboveEdges = (YEdges >> 1) | (bHasNextWord ? YEdgesWords[WordIndex + 1] << (BitsPerWordNum - 1) : 0);
+			WordType const BelowPassable = (Passable << 1) | (bHasPrevWord ? PassableWords[WordIndex - 1] >> (BitsPerWordNum - 1) : 0);
+			VisitCells(Column, ColumnWordIndex, Reached & AboveEdges & ~AbovePassable, ECBGridDirection::PositiveY);
+			VisitCells(Column, ColumnWordIndex, Reached & YEdges & ~BelowPassable, ECBGridDirection::NegativeY);
+
+			bool const bHasNextColumn = Column + 1 < ColumnsNum;
+			WordType const NextColumnPassable = bHasNextColumn ? PassableWords[WordIndex + WordsPerColumnNum] : 0;
+			WordType const NextColumnEdges = bHasNextColumn ? XEdgesWords[WordIndex + WordsPerColumnNum] : 0;
+			WordType const PrevColumnPassable = Column > 0 ? PassableWords[WordIndex - WordsPerColumnNum] : 0;
+			VisitCells(Column, ColumnWordIndex, Reached & NextColumnEdges & ~NextColumnPassable, ECBGridDirection::PositiveX);
+			VisitCells(Column, ColumnWordIndex, Reached & XEdgesWords[WordIndex] & ~PrevColumnPassable, ECBGridDirection::NegativeX);
+		}
+	}
+}
@@ -0,0 +1,143 @@
+#include "CBNavGridFlowField.h"
+#include "CBGridUtilities.h"
+#include "CBNavGrid.h"
+#include "CBNavGridLayer.h"
+
+namespace
+{
+	constexpr int32 DirectionsNum = static_cast<int32>(ECBGridDirection::DIRECTIONS_NUM);
+
+	ECBGridDirection GetOppositeDirection(ECBGridDirection const GridDirection)
+	{
+		return static_cast<ECBGridDirection>((static_cast<int32>(GridDirection) + DirectionsNum / 2) % DirectionsNum);
+	}
+} // namespace
+
+FCBNavGridFlowField::FCBNavGridFlowField(ACBNavGrid const & NavGrid, FIntPoint const InGoalGridCoord, FIntRect const & InGridRect)
+	: GoalGridCoord(InGoalGridCoord)
+	, GridRect(InGridRect)
+	, TileRect(CBGridUtilities::GetTileRect(InGridRect, NavGrid.GetTileSize()))
+	, TileSize(NavGrid.GetTileSize())
+{
+	struct FOpenCell
+	{
+		FIntPoint GridCoord;
+		uint16 Cost;
+	};
+
+	FCBNavGridReadScope const ReadScope{ NavGrid };
+	TileFields.SetNum(FMath::Max(TileRect.Area(), 0));
+
+	// Open list is a FIFO queue, cells are popped by advancing the index, so costs are final once cells are added.
+	TArray<FOpenCell> OpenList;
+	auto OpenCell = [this, &NavGrid, &OpenList](FIntPoint const GridCoord, uint16 const Cost, ECBGridDirection const NextDirection)
+		{
+			if (!GridRect.Contains(GridCoord))
+			{
+				return;
+			}
+			FIntPoint const CellTileCoord = NavGrid.GetTileCoord(GridCoord);
+			FCBNavGridLayer const * const Tile = NavGrid.FindTileNavigationData(CellTileCoord);
+			if (!Tile || Tile->IsCellOccupied(GridCoord))
+			{
+				return;
+			}
+
+			FTileField & TileField = TileFields[GetTileFieldIndex(CellTileCoord)];
+			if (TileField.Costs.IsEmpty())
+			{
+				TileField.Costs.Init(UnreachableCost, TileSize.X * TileSize.Y);
+				TileField.NextDirections.Init(static_cast<uint8>(ECBGridDirection::NONE), TileSize.X * TileSize.Y);
+			}
+			FIntPoint const CoordInTile = GridCoord - CellTileCoord * TileSize;
+			int32 const CellIndex = CoordInTile.X * TileSize.Y + CoordInTile.Y;
+			if (TileField.Costs[CellIndex] != UnreachableCost)
+			{
+				return;
+			}
+			TileField.Costs[CellIndex] = Cost;
+			TileField.NextDirections[CellIndex] = static_cast<uint8>(NextDirection);
+			OpenList.Add(FOpenCell{ GridCoord, Cost });
+		};
+
+	OpenCell(GoalGridCoord, 0, ECBGridDirection::NONE);
+	for (int32 OpenIndex = 0; OpenIndex < OpenList.Num(); ++OpenIndex)
+	{
+		FOpenCell const Cell = OpenList[OpenIndex];
+		if (Cell.Cost == MaxCost)
+		{
+			// Queue is ordered by cost, so all further cells are at max cost too.
+			break;
+		}
+		for (ECBGridDirection const GridDirection : TEnumRange<ECBGridDirection>())
+		{
+			OpenCell(CBGridUtilities::GetAdjacentCoordChecked(Cell.GridCoord, GridDirection), static_cast<uint16>(Cell.Cost + 1), GetOppositeDirection(GridDirection));
+		}
+	}
+}
+
+FIntPoint FCBNavGridFlowField::GetGoalGridCoord() const
+{
+	return GoalGridCoord;
+}
+
+FIntRect const & FCBNavGridFlowField::GetGridRect() const
+{
+	return GridRect;
+}
+
+uint16 FCBNavGridFlowField::GetCost(FIntPoint const GridCoord) const
+{
+	int32 CellIndex;
+	FTileField const * const TileField = FindTileField(GridCoord, CellIndex);
+	return TileField ? TileField->Costs[CellIndex] : UnreachableCost;
+}
+
+bool FCBNavGridFlowField::GetNextGridCoord(FIntPoint const GridCoord, FIntPoint & OutNextGridCoord) const
+{
+	int32 CellIndex;
+	FTileField const * const TileField = FindTileField(GridCoord, CellIndex);
+	if (!TileField)
+	{
+		return false;
+	}
+	ECBGridDirection const NextDirection = static_cast<ECBGridDirection>(TileField->NextDirections[CellIndex]);
+	if (NextDirection == ECBGridDirection::NONE)
+	{
+		return false;
+	}
+	OutNextGridCoord = CBGridUtilities::GetAdjacentCoordChecked(GridCoord, NextDirection);
+	return true;
+}
+
+FVector2d FCBNavGridFlowField::GetFlowDirection(FIntPoint const GridCoord) const
+{
+	FIntPoint NextGridCoord;
+	if (!GetNextGridCoord(GridCoord, NextGridCoord))
+	{
+		return FVector2d::ZeroVector;
+	}
+	return static_cast<FVector2d>(NextGridCoord - GridCoord);
+}
+
+bool FCBNavGridFlowField::IsTileCovered(FIntPoint const TileCoord) const
+{
+	return TileRect.Contains(TileCoord);
+}
+
+FCBNavGridFlowField::FTileField const * FCBNavGridFlowField::FindTileField(FIntPoint const GridCoord, int32 & OutCellIndex) const
+{
+	if (!GridRect.Contains(GridCoord))
+	{
+		return nullptr;
+	}
+	FIntPoint const CellTileCoord = CBGridUtilities::GetTileCoord(GridCoord, TileSize);
+	FTileField const & TileField = TileFields[GetTileFieldIndex(CellTileCoord)];
+	if (TileField.Costs.IsEmpty())
+	{
+		return nullptr;
+	}
+	FIntPoint const CoordInTile = GridCoord - CellTileCoord * TileSize;
+	OutCellIndex = CoordInTile.X * TileSize.Y + CoordInTile.Y;
+	return &TileField;
+}
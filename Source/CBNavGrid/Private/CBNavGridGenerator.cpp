@@ -12,6 +12,9 @@ FCBNavGridBuildConfig::FCBNavGridBuildConfig()
 	, MaxNavigableCellHeightsDifference(50.)
 	, MinZ(-1e9f)
 	, MaxZ(1e9f)
+	, bBuildOccupiedCellsSums(false)
+	, MaxClearance(0)
+	, DefaultAreaId(0)
 {
 }
 
@@ -113,10 +116,16 @@ void FCBNavGridGenerator::ConfigureBuildProperties(FCBNavGridBuildConfig & OutCo
 	OutConfig.MaxNavigableCellHeightsDifference = DestNavGrid.GetMaxNavigableCellHeightsDifference();
 	OutConfig.MinZ = DestNavGrid.GetMinZ();
 	OutConfig.MaxZ = DestNavGrid.GetMaxZ();
+	OutConfig.bBuildOccupiedCellsSums = DestNavGrid.ShouldBuildOccupiedCellsSums();
+	OutConfig.MaxClearance = DestNavGrid.GetMaxClearance();
+	UpdateAreaIds(OutConfig);
 }
 
 void FCBNavGridGenerator::RebuildDirtyAreas(TArray<FCBNavigationDirtyArea> const & DirtyAreas)
 {
+	// Nav area classes may be registered after init, tile generators copy config when they are created.
+	UpdateAreaIds(Config);
+
 	// Finds all tiles that need regeneration.
 	TSet<FPendingTile> DirtyTiles;
 
@@ -162,6 +171,20 @@ void FCBNavGridGenerator::RebuildDirtyAreas(TArray<FCBNavigationDirtyArea> const
 	}
 }
 
+void FCBNavGridGenerator::UpdateAreaIds(FCBNavGridBuildConfig & OutConfig) const
+{
+	OutConfig.AreaClassToIdMap.Reset();
+	for (FSupportedAreaData const & SupportedArea : DestNavGrid.GetSupportedAreas())
+	{
+		if (SupportedArea.AreaClass && SupportedArea.AreaID >= 0 && SupportedArea.AreaID <= MAX_uint8)
+		{
+			OutConfig.AreaClassToIdMap.Add(SupportedArea.AreaClass, static_cast<uint8>(SupportedArea.AreaID));
+		}
+	}
+	uint8 const * const DefaultAreaId = OutConfig.AreaClassToIdMap.Find(FNavigationSystem::GetDefaultWalkableArea());
+	OutConfig.DefaultAreaId = DefaultAreaId ? *DefaultAreaId : 0;
+}
+
 void FCBNavGridGenerator::UpdateNavigationBounds()
 {
 	NavigationGridRects.Reset();
@@ -209,6 +232,11 @@ int32 FCBNavGridGenerator::ProcessCompletedTileGenerationTasks()
 			++CompletedTasksNum;
 		}
 	}
+
+	if (CompletedTasksNum > 0)
+	{
+		DestNavGrid.UpdateIslands();
+	}
 	return CompletedTasksNum;
 }
 
@@ -0,0 +1,164 @@
+#include "CBNavGridIslands.h"
+#include "CBNavGrid.h"
+#include "CBNavGridLayer.h"
+#include "Misc/ScopeRWLock.h"
+
+namespace
+{
+	int32 FindRoot(TArray<int32> & Parents, int32 Index)
+	{
+		while (Parents[Index] != Index)
+		{
+			Parents[Index] = Parents[Parents[Index]];
+			Index = Parents[Index];
+		}
+		return Index;
+	}
+
+	void Union(TArray<int32> & Parents, int32 const Index1, int32 const Index2)
+	{
+		int32 const Root1 = FindRoot(Parents, Index1);
+		int32 const Root2 = FindRoot(Parents, Index2);
+		if (Root1 != Root2)
+		{
+			Parents[FMath::Max(Root1, Root2)] = FMath::Min(Root1, Root2);
+		}
+	}
+} // namespace
+
+FCBNavGridIslands::FCBNavGridIslands(ACBNavGrid const & InNavGrid)
+	: NavGrid(InNavGrid)
+{
+}
+
+void FCBNavGridIslands::Rebuild()
+{
+	TMap<FIntPoint, FTileIslands> NewTiles;
+	TArray<int32> Parents;
+	for (FIntPoint const & TileCoord : NavGrid.GetTileCoords())
+	{
+		TSharedPtr<FCBNavGridLayer const> NavigationData = NavGrid.GetTileNavigationData(TileCoord);
+		check(NavigationData);
+		int32 const ComponentsOffset = Parents.Num();
+		for (int32 Label = 0; Label < NavigationData->GetComponentsNum(); ++Label)
+		{
+			Parents.Add(ComponentsOffset + Label);
+		}
+		NewTiles.Add(TileCoord, FTileIslands{ MoveTemp(NavigationData), ComponentsOffset });
+	}
+
+	// Every border is shared by two tiles, so only positive borders of each tile are merged.
+	for (TPair<FIntPoint, FTileIslands> const & TileEntry : NewTiles)
+	{
+		FTileIslands const & TileIslands = TileEntry.Value;
+		FIntRect const TileGridRect = TileIslands.NavigationData->GetGridRect();
+		for (FIntPoint const Shift : { FIntPoint{ 1, 0 }, FIntPoint{ 0, 1 } })
+		{
+			FTileIslands const * const NeighbourTileIslands = NewTiles.Find(TileEntry.Key + Shift);
+			if (!NeighbourTileIslands)
+			{
+				continue;
+			}
+
+			FIntPoint const FirstCell = Shift.X ? FIntPoint{ TileGridRect.Max.X - 1, TileGridRect.Min.Y } : FIntPoint{ TileGridRect.Min.X, TileGridRect.Max.Y - 1 };
+			FIntPoint const Step{ Shift.Y, Shift.X };
+			int32 const BorderLength = Shift.X ? TileGridRect.Height() : TileGridRect.Width();
+			for (int32 CellIndex = 0; CellIndex < BorderLength; ++CellIndex)
+			{
+				FIntPoint const GridCoord = FirstCell + Step * CellIndex;
+				int32 const Label = TileIslands.NavigationData->GetComponentLabel(GridCoord);
+				int32 const NeighbourLabel = NeighbourTileIslands->NavigationData->GetComponentLabel(GridCoord + Shift);
+				if (Label != INDEX_NONE && NeighbourLabel != INDEX_NONE)
+				{
+					Union(Parents, TileIslands.ComponentsOffset + Label, NeighbourTileIslands->ComponentsOffset + NeighbourLabel);
+				}
+			}
+		}
+	}
+
+	for (int32 Index = 0; Index < Parents.Num(); ++Index)
+	{
+		Parents[Index] = FindRoot(Parents, Index);
+	}
+
+	FRWScopeLock const ScopeLock{ Lock, SLT_Write };
+	Tiles = MoveTemp(NewTiles);
+	ComponentIslands = MoveTemp(Parents);
+	InvalidIslands.Init(false, ComponentIslands.Num());
+}
+
+void FCBNavGridIslands::Reset()
+{
+	FRWScopeLock const ScopeLock{ Lock, SLT_Write };
+	Tiles.Empty();
+	ComponentIslands.Empty();
+	InvalidIslands.Empty();
+}
+
+void FCBNavGridIslands::OnTileChanged(FIntPoint const TileCoord)
+{
+	FRWScopeLock const ScopeLock{ Lock, SLT_Write };
+	if (FTileIslands const * const TileIslands = Tiles.Find(TileCoord))
+	{
+		for (int32 Label = 0; Label < TileIslands->NavigationData->GetComponentsNum(); ++Label)
+		{
+			InvalidIslands[ComponentIslands[TileIslands->ComponentsOffset + Label]] = true;
+		}
+		Tiles.Remove(TileCoord);
+	}
+
+	// New cells of the tile may connect islands of neighbouring tiles, even if the tile wasn't indexed before.
+
+	for (FIntPoint const Shift : { FIntPoint{ 1, 0 }, FIntPoint{ 0, 1 }, FIntPoint{ -1, 0 }, FIntPoint{ 0, -1 } })
+	{
+		FTileIslands const * const NeighbourTileIslands = Tiles.Find(TileCoord + Shift);
+		if (!NeighbourTileIslands)
+		{
+			continue;
+		}
+
+		// Border cells of neighbouring tile facing the changed tile.
+		FIntRect const NeighbourGridRect = NeighbourTileIslands->NavigationData->GetGridRect();
+		FIntPoint const FirstCell{ Shift.X < 0 ? NeighbourGridRect.Max.X - 1 : NeighbourGridRect.Min.X, Shift.Y < 0 ? NeighbourGridRect.Max.Y - 1 : NeighbourGridRect.Min.Y };
+		FIntPoint const Step{ FMath::Abs(Shift.Y), FMath::Abs(Shift.X) };
+		int32 const BorderLength = Shift.X ? NeighbourGridRect.Height() : NeighbourGridRect.Width();
+		for (int32 CellIndex = 0; CellIndex < BorderLength; ++CellIndex)
+		{
+			int32 const Label = NeighbourTileIslands->NavigationData->GetComponentLabel(FirstCell + Step * CellIndex);
+			if (Label != INDEX_NONE)
+			{
+				InvalidIslands[ComponentIslands[NeighbourTileIslands->ComponentsOffset + Label]] = true;
+			}
+		}
+	}
+}
+
+int32 FCBNavGridIslands::GetIslandId(FIntPoint const GridCoord) const
+{
+	FRWScopeLock const ScopeLock{ Lock, SLT_ReadOnly };
+	return GetIslandIdUnsafe(GridCoord);
+}
+
+bool FCBNavGridIslands::AreInDifferentIslands(FIntPoint const GridCoord1, FIntPoint const GridCoord2) const
+{
+	FRWScopeLock const ScopeLock{ Lock, SLT_ReadOnly };
+	int32 const IslandId1 = GetIslandIdUnsafe(GridCoord1);
+	int32 const IslandId2 = GetIslandIdUnsafe(GridCoord2);
+	return IslandId1 != INDEX_NONE && IslandId2 != INDEX_NONE && IslandId1 != IslandId2;
+}
+
+int32 FCBNavGridIslands::GetIslandIdUnsafe(FIntPoint const GridCoord) const
+{
+	FTileIslands const * const TileIslands = Tiles.Find(NavGrid.GetTileCoord(GridCoord));
+	if (!TileIslands)
+	{
+		return INDEX_NONE;
+	}
+	int32 const Label = TileIslands->NavigationData->GetComponentLabel(GridCoord);
+	if (Label == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+	int32 const IslandId = ComponentIslands[TileIslands->ComponentsOffset + Label];
+	return InvalidIslands[IslandId] ? INDEX_NONE : IslandId;
+}
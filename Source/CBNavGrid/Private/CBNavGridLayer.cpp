@@ -1,9 +1,13 @@
 #include "CBNavGridLayer.h"
 #include "CBGridUtilities.h"
+#include "CBNavGridCustomVersion.h"
 #include "GeomTools.h"
 
 namespace
 {
+	/** Label of occupied and unlabeled cells, also limits number of labeled components. */
+	constexpr uint16 NoComponentLabel = MAX_uint16;
+
 	void CheckRect(FIntRect const & GridRect)
 	{
 		check(GridRect.Min.X <= GridRect.Max.X && GridRect.Min.Y <= GridRect.Max.Y);
@@ -36,22 +40,66 @@ namespace
 			}
 		}
 	}
+
+	/** Calls Body with every cell of layer which center is inside of circle. */
+	template <std::invocable<FIntPoint> BodyType>
+	void ForEachCellInCircle(FCBNavGridLayer const & Layer, FVector2d const CircleOrigin, double const Radius, BodyType && Body)
+	{
+		float const CellSize = Layer.GetCellSize();
+		FIntRect const BoundingRect = CBGridUtilities::GetGridRectFromBoundingBox2d(FBox2d{ CircleOrigin - Radius, CircleOrigin + Radius }, CellSize);
+		ForRect(Layer.ClipWithGridRect(BoundingRect), [CellSize, CircleOrigin, Radius, &Body](FIntPoint const Coord)
+			{
+				double const CellCenterToOriginDistSquared = FVector2d::DistSquared(CBGridUtilities::GetGridCellCenter(Coord, CellSize), CircleOrigin);
+				if (FMath::Square(Radius) >= CellCenterToOriginDistSquared)
+				{
+					Body(Coord);
+				}
+			});
+	}
+
+	/** Calls Body with every cell of layer which center is inside of convex polygon. */
+	template <std::invocable<FIntPoint> BodyType>
+	void ForEachCellInConvex(FCBNavGridLayer const & Layer, TArray<FVector2d> const & CCWConvex, BodyType && Body)
+	{
+		if (CCWConvex.Num() < 3)
+		{
+			return;
+		}
+
+		float const CellSize = Layer.GetCellSize();
+		FIntRect const BoundingRect = CBGridUtilities::GetGridRectFromBoundingBox2d(FBox2d{ CCWConvex }, CellSize);
+		ForRect(Layer.ClipWithGridRect(BoundingRect), [CellSize, &CCWConvex, &Body](FIntPoint const Coord)
+			{
+				if (IsPointInConvexPolygon(CBGridUtilities::GetGridCellCenter(Coord, CellSize), CCWConvex))
+				{
+					Body(Coord);
+				}
+			});
+	}
 } // namespace
 
 FCBNavGridLayer::FCBNavGridLayer()
 	: FCBBitGridLayer{}
 	, Origin{ 0 , 0 }
 	, CellSize{ 0.f }
+	, FreeCellsNum{ 0 }
+	, ComponentsNum{ 0 }
+	, MaxClearance{ 0 }
 {
 }
 
-FCBNavGridLayer::FCBNavGridLayer(FIntRect const & InGridRect, float const InGridCellSize, bool const bIsOccupied, float const InitHeights)
+FCBNavGridLayer::FCBNavGridLayer(FIntRect const & InGridRect, float const InGridCellSize, bool const bIsOccupied, float const InitHeights, uint8 const InitAreaId)
 	: FCBBitGridLayer(static_cast<FUintPoint>(InGridRect.Size()), bIsOccupied)
+	, Overlay(static_cast<FUintPoint>(InGridRect.Size()), false)
 	, Origin(InGridRect.Min)
 	, CellSize(InGridCellSize)
+	, FreeCellsNum(0)
+	, ComponentsNum(0)
+	, MaxClearance(0)
 {
 	CheckRect(InGridRect);
 	CellHeights.Init(InitHeights, InGridRect.Area());
+	CellAreas.Init(InitAreaId, InGridRect.Area());
 }
 
 void FCBNavGridLayer::Serialize(FArchive & Archive)
@@ -59,15 +107,32 @@ void FCBNavGridLayer::Serialize(FArchive & Archive)
 	FCBBitGridLayer::Serialize(Archive);
 
 	Archive << Origin << CellSize << CellHeights;
+
+	if (Archive.CustomVer(FCBNavGridCustomVersion::GUID) >= FCBNavGridCustomVersion::CellAreas)
+	{
+		Archive << CellAreas;
+	}
+	else if (Archive.IsLoading())
+	{
+		CellAreas.Init(0, CellHeights.Num());
+	}
+
+	if (Archive.IsLoading())
+	{
+		Overlay = FCBBitGridLayer{ GetSize(), false };
+		UpdateComponentLabels();
+		UpdateFreeCellCounts();
+	}
 }
 
-bool FCBNavGridLayer::IsCellOccupied(FIntPoint const Coord) const
+bool FCBNavGridLayer::IsCellOccupied(FIntPoint const Coord, uint32 const BlockingPlanesMask, uint8 const MinClearance) const
 {
 	if (!IsInGrid(Coord))
 	{
 		return false;
 	}
-	return operator [](GetUnsignedCoordUnsafe(Coord));
+	FUintPoint const UnsignedCoord = GetUnsignedCoordUnsafe(Coord);
+	return ((GetCombinedWord(UnsignedCoord, BlockingPlanesMask, MinClearance) >> (UnsignedCoord.Y % BitsPerWordNum)) & 1u) != 0;
 }
 
 bool FCBNavGridLayer::SetCellState(FIntPoint const Coord, bool const bIsOccupied)
@@ -76,10 +141,19 @@ bool FCBNavGridLayer::SetCellState(FIntPoint const Coord, bool const bIsOccupied
 	{
 		return false;
 	}
-	operator [](GetUnsignedCoordUnsafe(Coord)) = bIsOccupied;
+	SetCell(GetUnsignedCoordUnsafe(Coord), bIsOccupied);
 	return true;
 }
 
+FCBNavGridLayer::WordType FCBNavGridLayer::GetOccupancyWord(FIntPoint const Coord, uint32 const BlockingPlanesMask, uint8 const MinClearance) const
+{
+	if (!IsInGrid(Coord))
+	{
+		return FullWordMask;
+	}
+	return GetCombinedWord(GetUnsignedCoordUnsafe(Coord), BlockingPlanesMask, MinClearance);
+}
+
 float FCBNavGridLayer::GetCellHeight(FIntPoint const Coord) const
 {
 	if (IsInGrid(Coord))
@@ -97,6 +171,23 @@ void FCBNavGridLayer::SetCellHeight(FIntPoint const Coord, float const Height)
 	}
 }
 
+uint8 FCBNavGridLayer::GetCellArea(FIntPoint const Coord) const
+{
+	if (IsInGrid(Coord))
+	{
+		return CellAreas[GetCellIndexUnsafe(Coord)];
+	}
+	return 0;
+}
+
+void FCBNavGridLayer::SetCellArea(FIntPoint const Coord, uint8 const AreaId)
+{
+	if (IsInGrid(Coord))
+	{
+		CellAreas[GetCellIndexUnsafe(Coord)] = AreaId;
+	}
+}
+
 float FCBNavGridLayer::GetCellSize() const
 {
 	return CellSize;
@@ -126,13 +217,165 @@ bool FCBNavGridLayer::IsInGrid(FIntPoint const Coord) const
 
 bool FCBNavGridLayer::HasOccupiedCell(FIntRect const & Rect) const
 {
+	if (HasOccupiedCellsSums())
+	{
+		return CountOccupiedCells(Rect) > 0;
+	}
 	bool const bValue = true;
-	return Contains(GetUnsignedRectUnsafe(ClipWithGridRect(Rect)), bValue);
+	FUintRect const UnsignedRect = GetUnsignedRectUnsafe(ClipWithGridRect(Rect));
+	return Contains(UnsignedRect, bValue) || Overlay.Contains(UnsignedRect, bValue);
+}
+
+bool FCBNavGridLayer::AreAllCellsFree(uint32 const BlockingPlanesMask, uint8 const MinClearance) const
+{
+	bool const bValue = false;
+	if (!IsFilled(bValue) || !Overlay.IsFilled(bValue) || MinClearance == NoFitClearance || (MinClearance > 1 && !CellClearances.IsEmpty()))
+	{
+		return false;
+	}
+	for (uint32 PlanesMask = BlockingPlanesMask; PlanesMask != 0; PlanesMask &= PlanesMask - 1)
+	{
+		int32 const PlaneIndex = static_cast<int32>(FMath::CountTrailingZeros(PlanesMask));
+		if (PlaneIndex >= BlockingPlanes.Num())
+		{
+			break;
+		}
+		if (!BlockingPlanes[PlaneIndex].IsFilled(bValue))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FCBNavGridLayer::AreAllCellsOccupied() const
+{
+	bool const bValue = true;
+	return IsFilled(bValue) || Overlay.IsFilled(bValue);
+}
+
+int32 FCBNavGridLayer::CountOccupiedCells(FIntRect const & Rect) const
+{
+	FIntRect const ClippedRect = ClipWithGridRect(Rect);
+	if (ClippedRect.Width() <= 0 || ClippedRect.Height() <= 0)
+	{
+		return 0;
+	}
+
+	FIntRect const LocalRect = ClippedRect - Origin;
+	if (AreAllCellsFree())
+	{
+		return 0;
+	}
+	if (AreAllCellsOccupied())
+	{
+		return LocalRect.Area();
+	}
+
+	constexpr int32 SignedBitsPerWordNum = static_cast<int32>(BitsPerWordNum);
+	int32 const MaxY = LocalRect.Max.Y - 1;
+	auto CountWordCells = [&LocalRect, MaxY](int32 const WordMinY, WordType Occupied)
+		{
+			if (LocalRect.Min.Y > WordMinY)
+			{
+				Occupied &= FullWordMask << (LocalRect.Min.Y - WordMinY);
+			}
+			if (MaxY < WordMinY + SignedBitsPerWordNum - 1)
+			{
+				Occupied &= FullWordMask >> (WordMinY + SignedBitsPerWordNum - 1 - MaxY);
+			}
+			return static_cast<int32>(FMath::CountBits(Occupied));
+		};
+
+	if (HasOccupiedCellsSums() && LocalRect.Area() <= MAX_uint16)
+	{
+		int32 const SumsYSize = static_cast<int32>(GetYSize()) + 1;
+		auto GetSum = [this, SumsYSize](int32 const X, int32 const Y)
+			{
+				return OccupiedCellsSums[X * SumsYSize + Y];
+			};
+		// Wrapped differences are exact, since count can't exceed rect area.
+		int32 OccupiedCellsNum = static_cast<uint16>(GetSum(LocalRect.Max.X, LocalRect.Max.Y) - GetSum(LocalRect.Min.X, LocalRect.Max.Y)
+			- GetSum(LocalRect.Max.X, LocalRect.Min.Y) + GetSum(LocalRect.Min.X, LocalRect.Min.Y));
+
+		// Sums cover generated occupancy only, overlay cells free in it are added from overlay tiles having set cells.
+		bool const bValue = false;
+		if (Overlay.IsFilled(bValue))
+		{
+			return OccupiedCellsNum;
+		}
+		int32 const OverlayTileXSize = static_cast<int32>(FCBBitGridLayer::GetTileSize().X);
+		for (int32 TileMinX = LocalRect.Min.X - LocalRect.Min.X % OverlayTileXSize; TileMinX < LocalRect.Max.X; TileMinX += OverlayTileXSize)
+		{
+			for (int32 WordMinY = LocalRect.Min.Y & ~(SignedBitsPerWordNum - 1); WordMinY <= MaxY; WordMinY += SignedBitsPerWordNum)
+			{
+				if (Overlay.IsTileFilled(FUintPoint{ static_cast<uint32>(TileMinX), static_cast<uint32>(WordMinY) }, bValue))
+				{
+					continue;
+				}
+				for (int32 X = FMath::Max(TileMinX, LocalRect.Min.X); X < FMath::Min(TileMinX + OverlayTileXSize, LocalRect.Max.X); ++X)
+				{
+					FUintPoint const WordCoord{ static_cast<uint32>(X), static_cast<uint32>(WordMinY) };
+					OccupiedCellsNum += CountWordCells(WordMinY, Overlay.GetWord(WordCoord) & ~GetWord(WordCoord));
+				}
+			}
+		}
+		return OccupiedCellsNum;
+	}
+
+	int32 OccupiedCellsNum = 0;
+	for (int32 X = LocalRect.Min.X; X < LocalRect.Max.X; ++X)
+	{
+		for (int32 WordMinY = LocalRect.Min.Y & ~(SignedBitsPerWordNum - 1); WordMinY <= MaxY; WordMinY += SignedBitsPerWordNum)
+		{
+			OccupiedCellsNum += CountWordCells(WordMinY, GetCombinedWord(FUintPoint{ static_cast<uint32>(X), static_cast<uint32>(WordMinY) }));
+		}
+	}
+	return OccupiedCellsNum;
+}
+
+bool FCBNavGridLayer::FindOccupiedCellInColumn(int32 const X, int32 const FromY, int32 const ToY, int32 & OutY, uint32 const BlockingPlanesMask, uint8 const MinClearance) const
+{
+	check(IsInGrid(FIntPoint{ X, FromY }) && IsInGrid(FIntPoint{ X, ToY }));
+	constexpr int32 SignedBitsPerWordNum = static_cast<int32>(BitsPerWordNum);
+	uint32 const LocalX = static_cast<uint32>(X - Origin.X);
+	int32 const MinY = FMath::Min(FromY, ToY) - Origin.Y;
+	int32 const MaxY = FMath::Max(FromY, ToY) - Origin.Y;
+	bool const bIsAscending = FromY <= ToY;
+	int32 const WordStep = bIsAscending ? SignedBitsPerWordNum : -SignedBitsPerWordNum;
+	if (AreAllCellsFree(BlockingPlanesMask, MinClearance))
+	{
+		return false;
+	}
+
+	for (int32 WordMinY = (bIsAscending ? MinY : MaxY) & ~(SignedBitsPerWordNum - 1); WordMinY <= MaxY && WordMinY + SignedBitsPerWordNum > MinY; WordMinY += WordStep)
+	{
+		WordType Mask = FullWordMask;
+		if (MinY > WordMinY)
+		{
+			Mask &= FullWordMask << (MinY - WordMinY);
+		}
+		if (MaxY < WordMinY + SignedBitsPerWordNum - 1)
+		{
+			Mask &= FullWordMask >> (WordMinY + SignedBitsPerWordNum - 1 - MaxY);
+		}
+
+		WordType const Occupied = GetCombinedWord(FUintPoint{ LocalX, static_cast<uint32>(WordMinY) }, BlockingPlanesMask, MinClearance) & Mask;
+		if (Occupied != 0)
+		{
+			int32 const Bit = bIsAscending
+				? static_cast<int32>(FMath::CountTrailingZeros(Occupied))
+				: SignedBitsPerWordNum - 1 - static_cast<int32>(FMath::CountLeadingZeros(Occupied));
+			OutY = Origin.Y + WordMinY + Bit;
+			return true;
+		}
+	}
+	return false;
 }
 
 void FCBNavGridLayer::SetCellsState(FIntRect const & Rect, bool const bIsOccupied)
 {
-	SetCells(GetUnsignedRectUnsafe(ClipWithGridRect(Rect)), bIsOccupied);
+	StampRect(*this, Rect, bIsOccupied);
 }
 
 void FCBNavGridLayer::SetCellsStateInBox(FBox2d const & Box, bool const bIsOccupied)
@@ -142,36 +385,426 @@ void FCBNavGridLayer::SetCellsStateInBox(FBox2d const & Box, bool const bIsOccup
 
 void FCBNavGridLayer::SetCellsStateInCircle(FVector2d const CircleOrigin, double const Radius, bool const bIsOccupied)
 {
-	FIntRect const BoundingRect = CBGridUtilities::GetGridRectFromBoundingBox2d(FBox2d{ CircleOrigin - Radius, CircleOrigin + Radius }, CellSize);
-	FIntRect const ClippedBoundingRect = ClipWithGridRect(BoundingRect);
-	ForRect(ClippedBoundingRect, [this, CircleOrigin, Radius, bIsOccupied](FIntPoint const Coord)
+	StampCircle(*this, CircleOrigin, Radius, bIsOccupied);
+}
+
+void FCBNavGridLayer::SetCellsStateInConvex(TArray<FVector2d> const & CCWConvex, bool const bIsOccupied)
+{
+	StampConvex(*this, CCWConvex, bIsOccupied);
+}
+
+void FCBNavGridLayer::SetCellsArea(FIntRect const & Rect, uint8 const AreaId)
+{
+	ForRect(ClipWithGridRect(Rect), [this, AreaId](FIntPoint const Coord)
+		{
+			CellAreas[GetCellIndexUnsafe(Coord)] = AreaId;
+		});
+}
+
+void FCBNavGridLayer::SetCellsAreaInBox(FBox2d const & Box, uint8 const AreaId)
+{
+	SetCellsArea(CBGridUtilities::GetGridRectFromBoundingBox2d(Box, CellSize), AreaId);
+}
+
+void FCBNavGridLayer::SetCellsAreaInCircle(FVector2d const CircleOrigin, double const Radius, uint8 const AreaId)
+{
+	ForEachCellInCircle(*this, CircleOrigin, Radius, [this, AreaId](FIntPoint const Coord)
+		{
+			CellAreas[GetCellIndexUnsafe(Coord)] = AreaId;
+		});
+}
+
+void FCBNavGridLayer::SetCellsAreaInConvex(TArray<FVector2d> const & CCWConvex, uint8 const AreaId)
+{
+	ForEachCellInConvex(*this, CCWConvex, [this, AreaId](FIntPoint const Coord)
 		{
-			double const CellCenterToOriginDistSquared = FVector2d::DistSquared(CBGridUtilities::GetGridCellCenter(Coord, CellSize), CircleOrigin);
-			if (FMath::Square(Radius) >= CellCenterToOriginDistSquared)
+			CellAreas[GetCellIndexUnsafe(Coord)] = AreaId;
+		});
+}
+
+void FCBNavGridLayer::SetOverlayCellsState(FIntRect const & Rect, bool const bIsOccupied, int32 const PlaneIndex)
+{
+	StampRect(GetOverlayTarget(PlaneIndex), Rect, bIsOccupied);
+}
+
+void FCBNavGridLayer::SetOverlayCellsStateInBox(FBox2d const & Box, bool const bIsOccupied, int32 const PlaneIndex)
+{
+	SetOverlayCellsState(CBGridUtilities::GetGridRectFromBoundingBox2d(Box, CellSize), bIsOccupied, PlaneIndex);
+}
+
+void FCBNavGridLayer::SetOverlayCellsStateInCircle(FVector2d const CircleOrigin, double const Radius, bool const bIsOccupied, int32 const PlaneIndex)
+{
+	StampCircle(GetOverlayTarget(PlaneIndex), CircleOrigin, Radius, bIsOccupied);
+}
+
+void FCBNavGridLayer::SetOverlayCellsStateInConvex(TArray<FVector2d> const & CCWConvex, bool const bIsOccupied, int32 const PlaneIndex)
+{
+	StampConvex(GetOverlayTarget(PlaneIndex), CCWConvex, bIsOccupied);
+}
+
+bool FCBNavGridLayer::HasOverlayCells() const
+{
+	bool const bValue = true;
+	FUintRect const Rect{ FUintPoint{ 0, 0 }, GetSize() };
+	if (Overlay.Contains(Rect, bValue))
+	{
+		return true;
+	}
+	for (FCBBitGridLayer const & BlockingPlane : BlockingPlanes)
+	{
+		if (BlockingPlane.Contains(Rect, bValue))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FCBNavGridLayer::ClearOverlay()
+{
+	Overlay = FCBBitGridLayer{ GetSize(), false };
+	for (FCBBitGridLayer & BlockingPlane : BlockingPlanes)
+	{
+		BlockingPlane = FCBBitGridLayer{ GetSize(), false };
+	}
+}
+
+void FCBNavGridLayer::CopyOverlay(FCBNavGridLayer const & Src)
+{
+	check(GetGridRect() == Src.GetGridRect());
+	Overlay = Src.Overlay;
+	BlockingPlanes = Src.BlockingPlanes;
+}
+
+void FCBNavGridLayer::SetBlockingPlanesNum(int32 const BlockingPlanesNum)
+{
+	check(BlockingPlanesNum >= 0 && BlockingPlanesNum <= MaxBlockingPlanesNum);
+	int32 const OldBlockingPlanesNum = BlockingPlanes.Num();
+	BlockingPlanes.SetNum(BlockingPlanesNum);
+	for (int32 PlaneIndex = OldBlockingPlanesNum; PlaneIndex < BlockingPlanesNum; ++PlaneIndex)
+	{
+		BlockingPlanes[PlaneIndex] = FCBBitGridLayer{ GetSize(), false };
+	}
+}
+
+int32 FCBNavGridLayer::GetBlockingPlanesNum() const
+{
+	return BlockingPlanes.Num();
+}
+
+void FCBNavGridLayer::UpdateComponentLabels()
+{
+	FIntRect const GridRect = GetGridRect();
+	ComponentLabels.Init(NoComponentLabel, GridRect.Area());
+	ComponentsNum = 0;
+
+	TArray<FIntPoint> OpenList;
+	ForRect(GridRect, [this, &OpenList](FIntPoint const Coord)
+		{
+			uint16 & CellLabel = ComponentLabels[GetCellIndexUnsafe(Coord)];
+			if (CellLabel != NoComponentLabel || ComponentsNum == NoComponentLabel || operator [](GetUnsignedCoordUnsafe(Coord)))
+			{
+				return;
+			}
+
+			uint16 const Label = static_cast<uint16>(ComponentsNum++);
+			CellLabel = Label;
+			OpenList.Add(Coord);
+			while (!OpenList.IsEmpty())
 			{
-				operator [](GetUnsignedCoordUnsafe(Coord)) = bIsOccupied;
+				FIntPoint const CellCoord = OpenList.Pop(EAllowShrinking::No);
+				for (ECBGridDirection const GridDirection : TEnumRange<ECBGridDirection>())
+				{
+					FIntPoint const AdjacentCellCoord = CBGridUtilities::GetAdjacentCoordChecked(CellCoord, GridDirection);
+					if (!IsInGrid(AdjacentCellCoord) || operator [](GetUnsignedCoordUnsafe(AdjacentCellCoord)))
+					{
+						continue;
+					}
+					uint16 & AdjacentCellLabel = ComponentLabels[GetCellIndexUnsafe(AdjacentCellCoord)];
+					if (AdjacentCellLabel == NoComponentLabel)
+					{
+						AdjacentCellLabel = Label;
+						OpenList.Add(AdjacentCellCoord);
+					}
+				}
 			}
 		});
 }
 
-void FCBNavGridLayer::SetCellsStateInConvex(TArray<FVector2d> const & CCWConvex, bool const bIsOccupied)
+int32 FCBNavGridLayer::GetComponentLabel(FIntPoint const Coord) const
 {
-	if (CCWConvex.Num() < 3)
+	if (!IsInGrid(Coord) || ComponentLabels.IsEmpty())
+	{
+		return INDEX_NONE;
+	}
+	uint16 const Label = ComponentLabels[GetCellIndexUnsafe(Coord)];
+	return Label == NoComponentLabel ? INDEX_NONE : Label;
+}
+
+int32 FCBNavGridLayer::GetComponentsNum() const
+{
+	return ComponentsNum;
+}
+
+void FCBNavGridLayer::UpdateClearances(FIntRect const & Rect, TConstArrayView<FCBNavGridLayer const *> const NeighbourLayers, uint8 const InMaxClearance)
+{
+	FIntRect const GridRect = GetGridRect();
+	FIntRect UpdatedRect = Rect;
+	if (CellClearances.IsEmpty() || MaxClearance != InMaxClearance)
+	{
+		CellClearances.SetNumZeroed(GridRect.Area());
+		MaxClearance = InMaxClearance;
+		UpdatedRect = GridRect;
+	}
+	UpdatedRect.Clip(GridRect);
+	if (UpdatedRect.Width() <= 0 || UpdatedRect.Height() <= 0 || MaxClearance == 0)
 	{
 		return;
 	}
 
-	FIntRect const BoundingRect = CBGridUtilities::GetGridRectFromBoundingBox2d(FBox2d{ CCWConvex }, CellSize);
-	FIntRect const ClippedBoundingRect = ClipWithGridRect(BoundingRect);
-	ForRect(ClippedBoundingRect, [this, &CCWConvex, bIsOccupied](FIntPoint const Coord)
+	// Chamfer distances of cells of rect extended by max clearance, steps along axes cost 3 and diagonal steps cost 4.
+	// Path of chamfer distance less than 3 * MaxClearance + 3 from updated cell doesn't leave extended rect.
+	constexpr uint16 AxisStepDistance = 3;
+	constexpr uint16 DiagonalStepDistance = 4;
+	int32 const Margin = MaxClearance;
+	FIntRect const ExtendedRect{ UpdatedRect.Min - FIntPoint{ Margin, Margin }, UpdatedRect.Max + FIntPoint{ Margin, Margin } };
+	FIntPoint const ExtendedSize = ExtendedRect.Size();
+	uint16 const MaxDistance = AxisStepDistance * (MaxClearance + 1);
+	TArray<uint16> Distances;
+	Distances.SetNumZeroed(ExtendedSize.X * ExtendedSize.Y);
+	auto GetDistance = [&Distances, &ExtendedRect, &ExtendedSize](int32 const X, int32 const Y) -> uint16 &
+		{
+			return Distances[(X - ExtendedRect.Min.X) * ExtendedSize.Y + (Y - ExtendedRect.Min.Y)];
+		};
+
+	auto AddFreeCells = [&ExtendedRect, &GetDistance, MaxDistance](FCBNavGridLayer const & Layer)
+		{
+			ForRect(Layer.ClipWithGridRect(ExtendedRect), [&Layer, &GetDistance, MaxDistance](FIntPoint const Coord)
+				{
+					FUintPoint const UnsignedCoord = Layer.GetUnsignedCoordUnsafe(Coord);
+					if (!Layer[UnsignedCoord] && !Layer.Overlay[UnsignedCoord])
+					{
+						GetDistance(Coord.X, Coord.Y) = MaxDistance;
+					}
+				});
+		};
+	AddFreeCells(*this);
+	for (FCBNavGridLayer const * const NeighbourLayer : NeighbourLayers)
+	{
+		if (NeighbourLayer && NeighbourLayer != this)
+		{
+			AddFreeCells(*NeighbourLayer);
+		}
+	}
+
+	auto Relax = [&ExtendedRect, &GetDistance](uint16 & Distance, int32 const X, int32 const Y, uint16 const StepDistance)
+		{
+			if (ExtendedRect.Contains(FIntPoint{ X, Y }))
+			{
+				Distance = FMath::Min<uint16>(Distance, GetDistance(X, Y) + StepDistance);
+			}
+		};
+	for (int32 X = ExtendedRect.Min.X; X < ExtendedRect.Max.X; ++X)
+	{
+		for (int32 Y = ExtendedRect.Min.Y; Y < ExtendedRect.Max.Y; ++Y)
 		{
-			if (IsPointInConvexPolygon(CBGridUtilities::GetGridCellCenter(Coord, CellSize), CCWConvex))
+			uint16 & Distance = GetDistance(X, Y);
+			if (Distance != 0)
 			{
-				operator [](GetUnsignedCoordUnsafe(Coord)) = bIsOccupied;
+				Relax(Distance, X - 1, Y - 1, DiagonalStepDistance);
+				Relax(Distance, X - 1, Y, AxisStepDistance);
+				Relax(Distance, X - 1, Y + 1, DiagonalStepDistance);
+				Relax(Distance, X, Y - 1, AxisStepDistance);
 			}
+		}
+	}
+	for (int32 X = ExtendedRect.Max.X - 1; X >= ExtendedRect.Min.X; --X)
+	{
+		for (int32 Y = ExtendedRect.Max.Y - 1; Y >= ExtendedRect.Min.Y; --Y)
+		{
+			uint16 & Distance = GetDistance(X, Y);
+			if (Distance != 0)
+			{
+				Relax(Distance, X + 1, Y + 1, DiagonalStepDistance);
+				Relax(Distance, X + 1, Y, AxisStepDistance);
+				Relax(Distance, X + 1, Y - 1, DiagonalStepDistance);
+				Relax(Distance, X, Y + 1, AxisStepDistance);
+			}
+		}
+	}
+
+	ForRect(UpdatedRect, [this, &GetDistance](FIntPoint const Coord)
+		{
+			CellClearances[GetCellIndexUnsafe(Coord)] = static_cast<uint8>(FMath::Min<uint16>(GetDistance(Coord.X, Coord.Y) / AxisStepDistance, MaxClearance));
 		});
 }
 
+void FCBNavGridLayer::EmptyClearances()
+{
+	CellClearances.Empty();
+	MaxClearance = 0;
+}
+
+bool FCBNavGridLayer::HasClearances() const
+{
+	return !CellClearances.IsEmpty();
+}
+
+uint8 FCBNavGridLayer::GetMaxClearance() const
+{
+	return MaxClearance;
+}
+
+uint8 FCBNavGridLayer::GetCellClearance(FIntPoint const Coord) const
+{
+	if (IsInGrid(Coord) && !CellClearances.IsEmpty())
+	{
+		return CellClearances[GetCellIndexUnsafe(Coord)];
+	}
+	return 0;
+}
+
+void FCBNavGridLayer::UpdateFreeCellCounts()
+{
+	uint32 const WordsPerColumnNum = GetYSize() / BitsPerWordNum;
+	int32 const WordsNum = static_cast<int32>(GetXSize() * WordsPerColumnNum);
+	WordFreeCellsNums.SetNumUninitialized(WordsNum);
+	FreeCellsTree.SetNumUninitialized(WordsNum);
+	FreeCellsNum = 0;
+	for (uint32 X = 0; X < GetXSize(); ++X)
+	{
+		for (uint32 WordIndex = 0; WordIndex < WordsPerColumnNum; ++WordIndex)
+		{
+			uint8 const WordFreeCellsNum = static_cast<uint8>(FMath::CountBits(~GetCombinedWord(FUintPoint{ X, WordIndex * BitsPerWordNum })));
+			WordFreeCellsNums[X * WordsPerColumnNum + WordIndex] = WordFreeCellsNum;
+			FreeCellsNum += WordFreeCellsNum;
+		}
+	}
+
+	for (int32 TreeIndex = 0; TreeIndex < WordsNum; ++TreeIndex)
+	{
+		FreeCellsTree[TreeIndex] = WordFreeCellsNums[TreeIndex];
+	}
+	// Every element is added to its parent once, which builds the tree in linear time.
+	for (int32 TreeIndex = 1; TreeIndex <= WordsNum; ++TreeIndex)
+	{
+		int32 const ParentIndex = TreeIndex + (TreeIndex & -TreeIndex);
+		if (ParentIndex <= WordsNum)
+		{
+			FreeCellsTree[ParentIndex - 1] += FreeCellsTree[TreeIndex - 1];
+		}
+	}
+}
+
+void FCBNavGridLayer::UpdateFreeCellCounts(FIntRect const & Rect)
+{
+	if (WordFreeCellsNums.IsEmpty())
+	{
+		UpdateFreeCellCounts();
+		return;
+	}
+
+	FIntRect const ClippedRect = ClipWithGridRect(Rect);
+	if (ClippedRect.Width() <= 0 || ClippedRect.Height() <= 0)
+	{
+		return;
+	}
+
+	FIntRect const LocalRect = ClippedRect - Origin;
+	int32 const WordsPerColumnNum = static_cast<int32>(GetYSize() / BitsPerWordNum);
+	int32 const WordsNum = WordFreeCellsNums.Num();
+	int32 const MinWordIndex = LocalRect.Min.Y / static_cast<int32>(BitsPerWordNum);
+	int32 const MaxWordIndex = (LocalRect.Max.Y - 1) / static_cast<int32>(BitsPerWordNum);
+	for (int32 X = LocalRect.Min.X; X < LocalRect.Max.X; ++X)
+	{
+		for (int32 WordIndex = MinWordIndex; WordIndex <= MaxWordIndex; ++WordIndex)
+		{
+			int32 const ColumnWordIndex = X * WordsPerColumnNum + WordIndex;
+			uint8 const WordFreeCellsNum = static_cast<uint8>(FMath::CountBits(~GetCombinedWord(FUintPoint{ static_cast<uint32>(X), WordIndex * BitsPerWordNum })));
+			int32 const Delta = static_cast<int32>(WordFreeCellsNum) - WordFreeCellsNums[ColumnWordIndex];
+			if (Delta == 0)
+			{
+				continue;
+			}
+			WordFreeCellsNums[ColumnWordIndex] = WordFreeCellsNum;
+			FreeCellsNum += Delta;
+			for (int32 TreeIndex = ColumnWordIndex + 1; TreeIndex <= WordsNum; TreeIndex += TreeIndex & -TreeIndex)
+			{
+				FreeCellsTree[TreeIndex - 1] += Delta;
+			}
+		}
+	}
+}
+
+int32 FCBNavGridLayer::GetFreeCellsNum() const
+{
+	return FreeCellsNum;
+}
+
+FIntPoint FCBNavGridLayer::GetFreeCell(int32 const FreeCellIndex) const
+{
+	check(FreeCellIndex >= 0 && FreeCellIndex < GetFreeCellsNum());
+
+	// Descends the tree to the word containing the cell, i.e. the last word with at most FreeCellIndex free cells before it.
+	int32 const WordsNum = FreeCellsTree.Num();
+	int32 WordIndex = 0;
+	int32 SkippedCellsNum = FreeCellIndex;
+	for (int32 Step = 1 << FMath::FloorLog2(static_cast<uint32>(WordsNum)); Step > 0; Step >>= 1)
+	{
+		int32 const NextWordIndex = WordIndex + Step;
+		if (NextWordIndex <= WordsNum && FreeCellsTree[NextWordIndex - 1] <= SkippedCellsNum)
+		{
+			WordIndex = NextWordIndex;
+			SkippedCellsNum -= FreeCellsTree[NextWordIndex - 1];
+		}
+	}
+	uint32 const WordsPerColumnNum = GetYSize() / BitsPerWordNum;
+	uint32 const X = static_cast<uint32>(WordIndex) / WordsPerColumnNum;
+	uint32 const WordMinY = static_cast<uint32>(WordIndex) % WordsPerColumnNum * BitsPerWordNum;
+
+	// Selects free cell within the word by dropping lower free cells.
+	WordType FreeCells = ~GetCombinedWord(FUintPoint{ X, WordMinY });
+	for (; SkippedCellsNum > 0; --SkippedCellsNum)
+	{
+		FreeCells &= FreeCells - 1;
+	}
+	check(FreeCells != 0);
+	return Origin + FIntPoint{ static_cast<int32>(X), static_cast<int32>(WordMinY + FMath::CountTrailingZeros(FreeCells)) };
+}
+
+void FCBNavGridLayer::UpdateOccupiedCellsSums()
+{
+	uint32 const SumsYSize = GetYSize() + 1;
+	OccupiedCellsSums.SetNumZeroed((GetXSize() + 1) * SumsYSize);
+	for (uint32 X = 0; X < GetXSize(); ++X)
+	{
+		// Column sum of cells below Y is added to sum of previous columns.
+		uint32 const PrevColumnIndex = X * SumsYSize;
+		uint32 const ColumnIndex = PrevColumnIndex + SumsYSize;
+		uint16 ColumnOccupiedCellsNum = 0;
+		for (uint32 WordMinY = 0; WordMinY < GetYSize(); WordMinY += BitsPerWordNum)
+		{
+			WordType const Occupied = GetWord(FUintPoint{ X, WordMinY });
+			for (uint32 Bit = 0; Bit < BitsPerWordNum; ++Bit)
+			{
+				ColumnOccupiedCellsNum += static_cast<uint16>((Occupied >> Bit) & 1u);
+				uint32 const Y = WordMinY + Bit + 1;
+				OccupiedCellsSums[ColumnIndex + Y] = static_cast<uint16>(OccupiedCellsSums[PrevColumnIndex + Y] + ColumnOccupiedCellsNum);
+			}
+		}
+	}
+}
+
+void FCBNavGridLayer::EmptyOccupiedCellsSums()
+{
+	OccupiedCellsSums.Empty();
+}
+
+bool FCBNavGridLayer::HasOccupiedCellsSums() const
+{
+	return !OccupiedCellsSums.IsEmpty();
+}
+
 void FCBNavGridLayer::Copy(FCBNavGridLayer & Dst, FCBNavGridLayer const & Src, FIntRect const & Rect)
 {
 	FIntRect RectToCopy = Rect;
@@ -179,6 +812,7 @@ void FCBNavGridLayer::Copy(FCBNavGridLayer & Dst, FCBNavGridLayer const & Src, F
 	ForRect(RectToCopy, [&Dst, &Src](FIntPoint const Coord)
 		{
 			Dst.SetCellHeight(Coord, Src.GetCellHeight(Coord));
+			Dst.SetCellArea(Coord, Src.GetCellArea(Coord));
 			Dst.SetCellState(Coord, Src.IsCellOccupied(Coord));
 		});
 }
@@ -203,3 +837,63 @@ FUintRect FCBNavGridLayer::GetUnsignedRectUnsafe(FIntRect const & SignedRect) co
 {
 	return FUintRect{ GetUnsignedCoordUnsafe(SignedRect.Min), GetUnsignedCoordUnsafe(SignedRect.Max) };
 }
+
+FCBNavGridLayer::WordType FCBNavGridLayer::GetCombinedWord(FUintPoint const Coord, uint32 const BlockingPlanesMask, uint8 const MinClearance) const
+{
+	if (MinClearance == NoFitClearance)
+	{
+		return FullWordMask;
+	}
+	WordType Word = GetWord(Coord) | Overlay.GetWord(Coord);
+	for (uint32 PlanesMask = BlockingPlanesMask; PlanesMask != 0; PlanesMask &= PlanesMask - 1)
+	{
+		int32 const PlaneIndex = static_cast<int32>(FMath::CountTrailingZeros(PlanesMask));
+		if (PlaneIndex >= BlockingPlanes.Num())
+		{
+			break;
+		}
+		Word |= BlockingPlanes[PlaneIndex].GetWord(Coord);
+	}
+	// Free cells have clearance of at least 1, so only greater min clearance blocks any of them.
+	if (MinClearance > 1 && !CellClearances.IsEmpty())
+	{
+		uint32 const WordMinY = Coord.Y - Coord.Y % BitsPerWordNum;
+		uint8 const * const WordClearances = &CellClearances[Coord.X * GetYSize() + WordMinY];
+		for (uint32 Bit = 0; Bit < BitsPerWordNum; ++Bit)
+		{
+			Word |= static_cast<WordType>(WordClearances[Bit] < MinClearance) << Bit;
+		}
+	}
+	return Word;
+}
+
+FCBBitGridLayer & FCBNavGridLayer::GetOverlayTarget(int32 const PlaneIndex)
+{
+	if (PlaneIndex == INDEX_NONE)
+	{
+		return Overlay;
+	}
+	check(BlockingPlanes.IsValidIndex(PlaneIndex));
+	return BlockingPlanes[PlaneIndex];
+}
+
+void FCBNavGridLayer::StampRect(FCBBitGridLayer & Target, FIntRect const & Rect, bool const bIsOccupied)
+{
+	Target.SetCells(GetUnsignedRectUnsafe(ClipWithGridRect(Rect)), bIsOccupied);
+}
+
+void FCBNavGridLayer::StampCircle(FCBBitGridLayer & Target, FVector2d const CircleOrigin, double const Radius, bool const bIsOccupied)
+{
+	ForEachCellInCircle(*this, CircleOrigin, Radius, [this, &Target, bIsOccupied](FIntPoint const Coord)
+		{
+			Target.SetCell(GetUnsignedCoordUnsafe(Coord), bIsOccupied);
+		});
+}
+
+void FCBNavGridLayer::StampConvex(FCBBitGridLayer & Target, TArray<FVector2d> const & CCWConvex, bool const bIsOccupied)
+{
+	ForEachCellInConvex(*this, CCWConvex, [this, &Target, bIsOccupied](FIntPoint const Coord)
+		{
+			Target.SetCell(GetUnsignedCoordUnsafe(Coord), bIsOccupied);
+		});
+}
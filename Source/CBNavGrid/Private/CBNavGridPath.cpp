@@ -6,6 +6,7 @@ FNavPathType const FCBNavGridPath::Type;
 FCBNavGridPath::FCBNavGridPath()
 	: GridBoundingBox()
 	, bWantsStringPulling(true)
+	, bWantsAnyAngle(false)
 {
 	PathType = FCBNavGridPath::Type;
 }
@@ -13,6 +14,7 @@ FCBNavGridPath::FCBNavGridPath()
 void FCBNavGridPath::ApplyFlags(int32 const NavDataFlags)
 {
 	bWantsStringPulling = !(NavDataFlags & static_cast<int32>(ECBNavGridPathFlags::SkipStringPulling));
+	bWantsAnyAngle = !!(NavDataFlags & static_cast<int32>(ECBNavGridPathFlags::AnyAngle));
 }
 
 bool FCBNavGridPath::ContainsCustomLink(FNavLinkId const UniqueLinkId) const
@@ -1,33 +1,64 @@
 #include "CBNavGridQueryFilter.h"
 
-FCBNavGridQueryFilter::FCBNavGridQueryFilter(float const InHeuristicScale, FVector2f const InAxiswiseHeuristicScale)
-	: HeuristicScale(InHeuristicScale)
+FCBNavGridQueryFilter::FCBNavGridQueryFilter(float const InHeuristicScale, FVector2f const InAxiswiseHeuristicScale, bool const bInUseFixedPointCosts, bool const bInUseJumpPointSearch, uint32 const InBlockingPlanesMask, float const InAgentRadius)
+	: AreaCosts(InPlace, 1.f)
+	, AreaEnteringCosts(InPlace, 0.f)
+	, MinAreaCost(1.f)
+	, HeuristicScale(InHeuristicScale)
 	, AxiswiseHeuristicScale(InAxiswiseHeuristicScale)
+	, BlockingPlanesMask(InBlockingPlanesMask)
+	, AgentRadius(InAgentRadius)
+	, bUseFixedPointCosts(bInUseFixedPointCosts)
+	, bUseJumpPointSearch(bInUseJumpPointSearch)
+	, bHasAreaCosts(false)
 {
 }
 
 void FCBNavGridQueryFilter::Reset()
 {
+	for (int32 AreaId = 0; AreaId < AreasNum; ++AreaId)
+	{
+		AreaCosts[AreaId] = 1.f;
+		AreaEnteringCosts[AreaId] = 0.f;
+	}
+	UpdateAreaCostsState();
 }
 
 void FCBNavGridQueryFilter::SetAreaCost(uint8 const AreaType, float const Cost)
 {
+	AreaCosts[AreaType] = Cost;
+	UpdateAreaCostsState();
 }
 
 void FCBNavGridQueryFilter::SetFixedAreaEnteringCost(uint8 const AreaType, float const Cost)
 {
+	AreaEnteringCosts[AreaType] = Cost;
+	UpdateAreaCostsState();
 }
 
 void FCBNavGridQueryFilter::SetExcludedArea(uint8 const AreaType)
 {
+	SetAreaCost(AreaType, TNumericLimits<float>::Max());
 }
 
 void FCBNavGridQueryFilter::SetAllAreaCosts(float const * const CostArray, int32 const Count)
 {
+	int32 const CostsNum = FMath::Min(Count, AreasNum);
+	for (int32 AreaId = 0; AreaId < CostsNum; ++AreaId)
+	{
+		AreaCosts[AreaId] = CostArray[AreaId];
+	}
+	UpdateAreaCostsState();
 }
 
 void FCBNavGridQueryFilter::GetAllAreaCosts(float * const CostArray, float * const FixedCostArray, int32 const Count) const
 {
+	int32 const CostsNum = FMath::Min(Count, AreasNum);
+	for (int32 AreaId = 0; AreaId < CostsNum; ++AreaId)
+	{
+		CostArray[AreaId] = AreaCosts[AreaId];
+		FixedCostArray[AreaId] = AreaEnteringCosts[AreaId];
+	}
 }
 
 void FCBNavGridQueryFilter::SetBacktrackingEnabled(bool const bBacktracking)
@@ -76,3 +107,20 @@ INavigationQueryFilterInterface * FCBNavGridQueryFilter::CreateCopy() const
 {
 	return new FCBNavGridQueryFilter(*this);
 }
+
+void FCBNavGridQueryFilter::UpdateAreaCostsState()
+{
+	bool bHasNonDefaultCosts = false;
+	float MinCost = TNumericLimits<float>::Max();
+	for (int32 AreaId = 0; AreaId < AreasNum; ++AreaId)
+	{
+		bHasNonDefaultCosts |= AreaCosts[AreaId] != 1.f || AreaEnteringCosts[AreaId] != 0.f;
+		if (AreaCosts[AreaId] < TNumericLimits<float>::Max())
+		{
+			MinCost = FMath::Min(MinCost, AreaCosts[AreaId]);
+		}
+	}
+	bHasAreaCosts = bHasNonDefaultCosts;
+	// If every area is excluded nothing is reachable, heuristic scale doesn't matter then.
+	MinAreaCost = MinCost < TNumericLimits<float>::Max() ? FMath::Max(MinCost, 0.f) : 1.f;
+}
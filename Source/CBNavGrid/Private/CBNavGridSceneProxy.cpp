@@ -171,7 +171,7 @@ void FCBNavGridSceneProxy::GatherData(ACBNavGrid const & NavGrid)
 
 	for (FIntPoint const & TileCoord : NavGrid.GetTileCoords())
 	{
-		FCBNavGridLayer const * const NavigationData = NavGrid.GetTileNavigationData(TileCoord).Get();
+		FCBNavGridLayer const * const NavigationData = NavGrid.FindTileNavigationData(TileCoord);
 		if (!NavigationData)
 		{
 			continue;
@@ -213,7 +213,7 @@ void FCBNavGridSceneProxy::GatherData(ACBNavGrid const & NavGrid)
 						else
 						{
 							FIntPoint const OtherTileCoord = NavGrid.GetTileCoord(FIntPoint{ X, Y });
-							FCBNavGridLayer const * const OtherNavigationData = NavGrid.GetTileNavigationData(OtherTileCoord).Get();
+							FCBNavGridLayer const * const OtherNavigationData = NavGrid.FindTileNavigationData(OtherTileCoord);
 							if (OtherNavigationData && !OtherNavigationData->IsCellOccupied(X, Y))
 							{
 								FreeCellsHeightSum += OtherNavigationData->GetCellHeight(X, Y);
@@ -258,7 +258,7 @@ void FCBNavGridSceneProxy::GatherData(ACBNavGrid const & NavGrid)
 					Lines.Emplace(GetJunctionPoint(StartX, StartY), GetJunctionPoint(EndX, EndY), CellEdgeColor, CellEdgeThickness);
 				};
 
-			FCBNavGridLayer const * const YNegativeNavigationData = NavGrid.GetTileNavigationData(TileCoord + FIntPoint{ 0, -1 }).Get();
+			FCBNavGridLayer const * const YNegativeNavigationData = NavGrid.FindTileNavigationData(TileCoord + FIntPoint{ 0, -1 });
 			bool const bHasYPositiveNavigationData = NavGrid.IsValidTileCoord(TileCoord + FIntPoint{ 0, 1 });
 			for (int32 X = TileRect.Min.X; X < TileRect.Max.X; ++X)
 			{
@@ -281,7 +281,7 @@ void FCBNavGridSceneProxy::GatherData(ACBNavGrid const & NavGrid)
 				}
 			}
 
-			FCBNavGridLayer const * const XNegativeNavigationData = NavGrid.GetTileNavigationData(TileCoord + FIntPoint{ -1, 0 }).Get();
+			FCBNavGridLayer const * const XNegativeNavigationData = NavGrid.FindTileNavigationData(TileCoord + FIntPoint{ -1, 0 });
 			bool const bHasXPositiveNavigationData = NavGrid.IsValidTileCoord(TileCoord + FIntPoint{ 1, 0 });
 			for (int32 Y = TileRect.Min.Y; Y < TileRect.Max.Y; ++Y)
 			{
@@ -360,7 +360,7 @@ void FCBNavGridSceneProxy::GatherData(ACBNavGrid const & NavGrid)
 					Lines.Emplace(GetJunctionPoint(StartX, StartY), GetJunctionPoint(EndX, EndY), NavGridEdgeColor, NavGridEdgeThickness);
 				};
 
-			FCBNavGridLayer const * const YNegativeNavigationData = NavGrid.GetTileNavigationData(TileCoord + FIntPoint{ 0, -1 }).Get();
+			FCBNavGridLayer const * const YNegativeNavigationData = NavGrid.FindTileNavigationData(TileCoord + FIntPoint{ 0, -1 });
 			bool const bHasYPositiveNavigationData = NavGrid.IsValidTileCoord(TileCoord + FIntPoint{ 0, 1 });
 			for (int32 X = TileRect.Min.X; X < TileRect.Max.X; ++X)
 			{
@@ -383,7 +383,7 @@ void FCBNavGridSceneProxy::GatherData(ACBNavGrid const & NavGrid)
 				}
 			}
 
-			FCBNavGridLayer const * const XNegativeNavigationData = NavGrid.GetTileNavigationData(TileCoord + FIntPoint{ -1, 0 }).Get();
+			FCBNavGridLayer const * const XNegativeNavigationData = NavGrid.FindTileNavigationData(TileCoord + FIntPoint{ -1, 0 });
 			bool const bHasXPositiveNavigationData = NavGrid.IsValidTileCoord(TileCoord + FIntPoint{ 1, 0 });
 			for (int32 Y = TileRect.Min.Y; Y < TileRect.Max.Y; ++Y)
 			{
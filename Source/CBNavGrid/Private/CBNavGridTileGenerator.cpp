@@ -2,6 +2,7 @@
 #include "AI/NavigationModifier.h"
 #include "GeomTools.h"
 #include "NavAreas/NavArea_Null.h"
+#include "CBGridUtilities.h"
 #include "CBHeightfield.h"
 #include "CBNavGrid.h"
 #include "CBNavGridLayer.h"
@@ -113,15 +114,16 @@ namespace
 	};
 
 	template <EGridCellsUpdateMethod UpdateMethod>
-	void SetGridCellsData(FCBNavGridLayer & OutNavGridLayer, FCBHeightfield const & Heightfield, TArrayView<FIntRect const> const GridRects, float const MaxNavigableCellHeightsDifference)
+	void SetGridCellsData(FCBNavGridLayer & OutNavGridLayer, FCBHeightfield const & Heightfield, TArrayView<FIntRect const> const GridRects, float const MaxNavigableCellHeightsDifference, uint8 const DefaultAreaId)
 	{
 		for (FIntRect const & GridRect : GridRects)
 		{
-			ForRect(GridRect, [&OutNavGridLayer, &Heightfield, MaxNavigableCellHeightsDifference](FIntPoint const Coord)
+			ForRect(GridRect, [&OutNavGridLayer, &Heightfield, MaxNavigableCellHeightsDifference, DefaultAreaId](FIntPoint const Coord)
 				{
 					FCBSpan const * Span = Heightfield.GetSpans(Coord);
 					bool const bIsOccupied = Span ? Span->Max - Span->Min > MaxNavigableCellHeightsDifference : true;
 					OutNavGridLayer.SetCellState(Coord, bIsOccupied);
+					OutNavGridLayer.SetCellArea(Coord, DefaultAreaId);
 					if constexpr (UpdateMethod == EGridCellsUpdateMethod::GeometryChanged)
 					{
 						float const CellHeight = Span ? (Span->Min + Span->Max) * 0.5f : std::numeric_limits<float>::quiet_NaN();
@@ -131,9 +133,11 @@ namespace
 		}
 	}
 
-	void MarkDynamicArea(FAreaNavModifier const & Modifier, FTransform const & LocalToWorld, FCBNavGridLayer & OutLayer)
+	/** Null area occupies cells, other areas set area id of cells, so null area wins regardless of modifiers order. */
+	void MarkDynamicArea(FAreaNavModifier const & Modifier, FTransform const & LocalToWorld, TMap<UClass const *, uint8> const & AreaClassToIdMap, FCBNavGridLayer & OutLayer)
 	{
 		bool const bIsOccupied = true;
+		uint8 const * const AreaId = Modifier.GetAreaClass() == UNavArea_Null::StaticClass() ? nullptr : AreaClassToIdMap.Find(Modifier.GetAreaClass());
 		switch (Modifier.GetShapeType())
 		{
 			case ENavigationShapeType::Cylinder:
@@ -145,7 +149,14 @@ namespace
 				CylinderData.Radius = CylinderData.Radius * FMath::Max(Scale3D.X, Scale3D.Y);
 				CylinderData.Origin = LocalToWorld.TransformPosition(CylinderData.Origin);
 
-				OutLayer.SetCellsStateInCircle(static_cast<FVector2d>(CylinderData.Origin), CylinderData.Radius, bIsOccupied);
+				if (AreaId)
+				{
+					OutLayer.SetCellsAreaInCircle(static_cast<FVector2d>(CylinderData.Origin), CylinderData.Radius, *AreaId);
+				}
+				else
+				{
+					OutLayer.SetCellsStateInCircle(static_cast<FVector2d>(CylinderData.Origin), CylinderData.Radius, bIsOccupied);
+				}
 				break;
 			}
 			case ENavigationShapeType::Box:
@@ -156,7 +167,14 @@ namespace
 				FBox const WorldBox = FBox::BuildAABB(BoxData.Origin, BoxData.Extent).TransformBy(LocalToWorld);
 				FBox2d const WorldBox2d{ static_cast<FVector2d>(WorldBox.Min), static_cast<FVector2d>(WorldBox.Max) };
 
-				OutLayer.SetCellsStateInBox(WorldBox2d, bIsOccupied);
+				if (AreaId)
+				{
+					OutLayer.SetCellsAreaInBox(WorldBox2d, *AreaId);
+				}
+				else
+				{
+					OutLayer.SetCellsStateInBox(WorldBox2d, bIsOccupied);
+				}
 				break;
 			}
 			case ENavigationShapeType::Convex:
@@ -177,7 +195,14 @@ namespace
 				TArray<FVector2d> CCWConvex;
 				FGeomTools2D::GenerateConvexHullFromPoints(CCWConvex, Points);
 
-				OutLayer.SetCellsStateInConvex(CCWConvex, bIsOccupied);
+				if (AreaId)
+				{
+					OutLayer.SetCellsAreaInConvex(CCWConvex, *AreaId);
+				}
+				else
+				{
+					OutLayer.SetCellsStateInConvex(CCWConvex, bIsOccupied);
+				}
 				break;
 			}
 		}
@@ -195,6 +220,24 @@ FCBNavGridTileGenerator::FCBNavGridTileGenerator(FCBNavGridGenerator const & InP
 	ACBNavGrid const & ParentGeneratorOwner = ParentGenerator.GetOwner();
 	PreviousNavigationData = ParentGeneratorOwner.GetTileNavigationData(TileCoord);
 	PreviousHeightfield = ParentGeneratorOwner.GetTileHeightfield(TileCoord);
+	if (Config.MaxClearance > 0)
+	{
+		FIntRect const TileGridRect = GetTileGridRect();
+		FIntPoint const Margin{ Config.MaxClearance, Config.MaxClearance };
+		FIntRect const NeighbourTileRect = CBGridUtilities::GetTileRect(FIntRect{ TileGridRect.Min - Margin, TileGridRect.Max + Margin }, Config.GridTileSize);
+		for (int32 TileX = NeighbourTileRect.Min.X; TileX < NeighbourTileRect.Max.X; ++TileX)
+		{
+			for (int32 TileY = NeighbourTileRect.Min.Y; TileY < NeighbourTileRect.Max.Y; ++TileY)
+			{
+				FIntPoint const NeighbourTileCoord{ TileX, TileY };
+				TSharedPtr<FCBNavGridLayer const> NeighbourLayer = ParentGeneratorOwner.GetTileNavigationData(NeighbourTileCoord);
+				if (NeighbourLayer && NeighbourTileCoord != TileCoord)
+				{
+					NeighbourNavigationData.Add(MoveTemp(NeighbourLayer));
+				}
+			}
+		}
+	}
 	GatherTileOverlappingNavigationGridRects(ParentGenerator.GetNavigationGridRects());
 }
 
@@ -290,8 +333,8 @@ void FCBNavGridTileGenerator::AppendAreaNavModifiers(TArrayView<FAreaNavModifier
 
 	for (FAreaNavModifier const & Area : Areas)
 	{
-		// Doesn't support any area classes except for null.
-		if (Area.GetAreaClass() == UNavArea_Null::StaticClass())
+		// Area classes unknown to nav grid have no area id yet, such modifiers are skipped.
+		if (Area.GetAreaClass() == UNavArea_Null::StaticClass() || Config.AreaClassToIdMap.Contains(Area.GetAreaClass()))
 		{
 			AreaNavModifierCollection.Areas.Emplace(Area);
 		}
@@ -451,14 +494,46 @@ void FCBNavGridTileGenerator::GenerateNavigationData()
 
 	if (PreviousNavigationData)
 	{
+		// Published layer is changed in place on game thread, so it is copied within read scope.
+		FCBNavGridReadScope const ReadScope{ ParentGenerator.GetOwner() };
 		GeneratedNavigationData = MakeUnique<FCBNavGridLayer>(*PreviousNavigationData);
+
+		// Overlay may be stamped on game thread meanwhile, nav grid carries over its current state on completion.
+		GeneratedNavigationData->ClearOverlay();
 	}
 	else
 	{
-		GeneratedNavigationData = MakeUnique<FCBNavGridLayer>(GetTileGridRect(), Config.GridCellSize);
+		bool const bIsOccupied = false;
+		GeneratedNavigationData = MakeUnique<FCBNavGridLayer>(GetTileGridRect(), Config.GridCellSize, bIsOccupied, std::numeric_limits<float>::quiet_NaN(), Config.DefaultAreaId);
 	}
 
 	GenerateNavigationDataLayer(*GeneratedNavigationData);
+	GeneratedNavigationData->UpdateComponentLabels();
+	GeneratedNavigationData->UpdateFreeCellCounts();
+	if (Config.bBuildOccupiedCellsSums)
+	{
+		GeneratedNavigationData->UpdateOccupiedCellsSums();
+	}
+	else
+	{
+		GeneratedNavigationData->EmptyOccupiedCellsSums();
+	}
+	if (Config.MaxClearance > 0)
+	{
+		// Published neighbours are changed in place on game thread, so they are read within read scope. Nav grid
+		// refreshes border bands on completion, since neighbours may be regenerated meanwhile.
+		FCBNavGridReadScope const ReadScope{ ParentGenerator.GetOwner() };
+		TArray<FCBNavGridLayer const *, TInlineAllocator<8>> NeighbourLayers;
+		for (TSharedPtr<FCBNavGridLayer const> const & NeighbourLayer : NeighbourNavigationData)
+		{
+			NeighbourLayers.Add(NeighbourLayer.Get());
+		}
+		GeneratedNavigationData->UpdateClearances(GetTileGridRect(), NeighbourLayers, Config.MaxClearance);
+	}
+	else
+	{
+		GeneratedNavigationData->EmptyClearances();
+	}
 }
 
 void FCBNavGridTileGenerator::GenerateNavigationDataLayer(FCBNavGridLayer & OutNavGridLayer) const
@@ -469,8 +544,8 @@ void FCBNavGridTileGenerator::GenerateNavigationDataLayer(FCBNavGridLayer & OutN
 		return;
 	}
 
-	SetGridCellsData<EGridCellsUpdateMethod::GeometryChanged>(OutNavGridLayer, *Heightfield, GeometryDirtyGridRects, Config.MaxNavigableCellHeightsDifference);
-	SetGridCellsData<EGridCellsUpdateMethod::ModifiersOnly>(OutNavGridLayer, *Heightfield, ModifiersOnlyDirtyGridRects, Config.MaxNavigableCellHeightsDifference);
+	SetGridCellsData<EGridCellsUpdateMethod::GeometryChanged>(OutNavGridLayer, *Heightfield, GeometryDirtyGridRects, Config.MaxNavigableCellHeightsDifference, Config.DefaultAreaId);
+	SetGridCellsData<EGridCellsUpdateMethod::ModifiersOnly>(OutNavGridLayer, *Heightfield, ModifiersOnlyDirtyGridRects, Config.MaxNavigableCellHeightsDifference, Config.DefaultAreaId);
 	MarkDynamicAreas(OutNavGridLayer);
 	FilterNavigableGridCells(OutNavGridLayer);
 }
@@ -504,13 +579,13 @@ void FCBNavGridTileGenerator::MarkDynamicAreas(FCBNavGridLayer & OutNavGridLayer
 		{
 			if (AreaNavModifierCollection.PerInstanceTransform.IsEmpty())
 			{
-				MarkDynamicArea(Area, FTransform::Identity, OutNavGridLayer);
+				MarkDynamicArea(Area, FTransform::Identity, Config.AreaClassToIdMap, OutNavGridLayer);
 			}
 			else
 			{
 				for (FTransform const & LocalToWorld : AreaNavModifierCollection.PerInstanceTransform)
 				{
-					MarkDynamicArea(Area, LocalToWorld, OutNavGridLayer);
+					MarkDynamicArea(Area, LocalToWorld, Config.AreaClassToIdMap, OutNavGridLayer);
 				}
 			}
 		}
@@ -3,9 +3,17 @@
 #include "CBBitGridTile.h"
 #include "CoreMinimal.h"
 
+/**
+ * Bit grid stored as 16 x 32 cells tiles. Every tile has summary telling if all its cells are set or all are clear,
+ * summaries are kept in sync by SetCell and SetCells, so uniform tiles and uniform layer are detected in constant time.
+ */
 class CBNAVGRID_API FCBBitGridLayer
 {
 public:
+	using WordType = uint32;
+	static constexpr uint32 BitsPerWordNum = sizeof(WordType) * CHAR_BIT;
+	static constexpr WordType FullWordMask = ~0u;
+
 	FCBBitGridLayer();
 
 	/**
@@ -16,13 +24,26 @@ public:
 	explicit FCBBitGridLayer(FUintPoint const InSize, bool const bValue);
 	explicit FCBBitGridLayer(FUintPoint const InSize, ENoInit);
 
-	FBitReference operator [](FUintPoint const Coord);
+	/** Cells are set only through SetCell and SetCells to keep tile summaries valid. */
 	FConstBitReference const operator [](FUintPoint const Coord) const;
 
+	/** Returns word of cells column Coord.X containing cell Coord. Bit I of the word is cell with Y equal to Coord.Y rounded down to BitsPerWordNum plus I. */
+	WordType GetWord(FUintPoint const Coord) const;
+
 	void Serialize(FArchive & Archive);
 	bool Contains(FUintRect const & Rect, bool const bValue) const;
+	void SetCell(FUintPoint const Coord, bool const bValue);
 	void SetCells(FUintRect const & Rect, bool const bValue);
 
+	/** Returns true if all cells of layer are equal to bValue. */
+	bool IsFilled(bool const bValue) const;
+
+	/** Returns true if all cells of tile containing cell Coord are equal to bValue. */
+	bool IsTileFilled(FUintPoint const Coord, bool const bValue) const;
+
+	/** Size of tiles checked by IsTileFilled. */
+	static FUintPoint GetTileSize();
+
 	/** Size getters. */
 	FUintPoint GetSize() const;
 	uint32 GetXSize() const;
@@ -36,9 +57,14 @@ protected:
 	void SetSize(FUintPoint const NewSize);
 
 private:
-	using WordType = uint32;
 	static constexpr uint32 WordsPerTileNum = 64 / sizeof(WordType);
-	static constexpr WordType FullWordMask = ~0u;
+
+	enum class ETileSummary : uint8
+	{
+		Mixed,
+		Clear,
+		Set
+	};
 
 	/** Tile of grid. Contains info about 16 x 32 grid cells. 64 bytes to fit in one cache line of most modern CPUs. */
 	struct alignas(64) FBitGridTile : public TCBBitGridTile<WordType, WordsPerTileNum>
@@ -59,8 +85,20 @@ private:
 	FUintPoint GetTileNum() const;
 	uint32 GetXTileNum() const;
 	uint32 GetYTileNum() const;
+	static ETileSummary GetFilledTileSummary(bool const bValue);
+	void SetTileSummary(uint32 const TileIndex, ETileSummary const Summary);
+
+	/** Recomputes summary of tile from its words. */
+	void UpdateTileSummary(uint32 const TileIndex);
+	void UpdateTileSummaries(FUintRect const & TileRect);
+	void ResetTileSummaries(ETileSummary const Summary);
 
 	TArray<FBitGridTile> GridLayerData;
+
+	/** Summary per tile in GridLayerData order, tiles of layer constructed with ENoInit are mixed until changed. */
+	TArray<ETileSummary> TileSummaries;
+	uint32 ClearTilesNum;
+	uint32 SetTilesNum;
 	FUintPoint Size;
 };
 
@@ -3,17 +3,51 @@
 #include "NavigationData.h"
 #include "CBNavGrid.generated.h"
 
+class ACBNavGrid;
 class FCBHeightfield;
+class FCBNavGridAbstractGraph;
+class FCBNavGridFlowField;
+class FCBNavGridIslands;
 class FCBNavGridLayer;
 class FCBNavGridAStarFilter;
 struct FCBNavGridPath;
 
 enum class ECBNavGridPathFlags : int32
 {
-	SkipStringPulling = (1 << 0)
+	SkipStringPulling = (1 << 0),
+
+	/** Searches for any-angle path, which needs no string pulling. Such queries are never hierarchical. */
+	AnyAngle = (1 << 1)
 };
 ENUM_CLASS_FLAGS(ECBNavGridPathFlags);
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FCBNavGridTileChangedDelegate, FIntPoint const /* TileCoord */);
+
+/**
+ * Keeps tiles of nav grid from being changed while alive. Tiles are changed only on game thread, so scopes taken there
+ * don't lock. Scopes nested on the same thread don't lock again. Every query reading tiles off game thread holds one.
+ */
+class CBNAVGRID_API FCBNavGridReadScope
+{
+public:
+	explicit FCBNavGridReadScope(ACBNavGrid const & NavGrid);
+
+	/**
+	 * Scope of task ParentScope's thread waits for, e.g. ParallelFor body. Relies on the lock held by ParentScope, as
+	 * locking again behind pending change of tiles would deadlock with the parent.
+	 */
+	FCBNavGridReadScope(ACBNavGrid const & NavGrid, FCBNavGridReadScope const & ParentScope);
+	~FCBNavGridReadScope();
+
+	UE_NONCOPYABLE(FCBNavGridReadScope);
+
+private:
+	/** Lock held during the scope, nullptr on game thread. */
+	FRWLock * TilesLock = nullptr;
+	bool bIsRegistered = false;
+	bool bIsLocked = false;
+};
+
 USTRUCT()
 struct CBNAVGRID_API FCBNavGridDebugSettings
 {
@@ -41,8 +75,8 @@ struct CBNAVGRID_API FCBNavGridDebugSettings
 };
 
 /**
- * One-layered squared navigation grid. Supports only default and null nav areas.
- * Ignores nav areas requirements passed to methods in filter. Doesen't support any links.
+ * One-layered squared navigation grid. Null nav area occupies cells, other nav areas set per cell area id.
+ * Filters with area costs apply area and entering costs of cells and skip excluded areas. Doesen't support any links.
  * Treats navigation bounds and dynamic areas as 2d rectangles projected on grid.
  * Creates navigation only for the highest collision geometry.
  */
@@ -106,44 +140,148 @@ public:
 
 	virtual void RecreateDefaultFilter();
 
-	bool Raycast2d(FVector2d const & RayStart, FVector2d const & RayEnd, FVector2d * const OutHitLocation = nullptr, FIntPoint * const OutHitGridCoord = nullptr) const;
-	bool Raycast(FVector const & RayStart, FVector const & RayEnd, FNavLocation & OutHitLocation, bool & bOutIsRayEndInCorridor) const;
-	bool ProjectPoint(FVector const & Point, FVector const & Extent, FVector * const OutLocation = nullptr, FIntPoint * const OutGridCoord = nullptr) const;
+	/**
+	 * Cells of blocking planes selected by BlockingPlanesMask are treated as occupied, see GetBlockingPlanesMask. Cells
+	 * without clearance for agent of AgentRadius are treated as occupied too, see GetRequiredClearance.
+	 */
+	bool Raycast2d(FVector2d const & RayStart, FVector2d const & RayEnd, FVector2d * const OutHitLocation = nullptr, FIntPoint * const OutHitGridCoord = nullptr, uint32 const BlockingPlanesMask = 0, float const AgentRadius = 0.f) const;
+	bool Raycast(FVector const & RayStart, FVector const & RayEnd, FNavLocation & OutHitLocation, bool & bOutIsRayEndInCorridor, uint32 const BlockingPlanesMask = 0, float const AgentRadius = 0.f) const;
+	bool ProjectPoint(FVector const & Point, FVector const & Extent, FVector * const OutLocation = nullptr, FIntPoint * const OutGridCoord = nullptr, uint32 const BlockingPlanesMask = 0, float const AgentRadius = 0.f) const;
 	ENavigationQueryResult::Type FindPath(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord, FCBNavGridAStarFilter const & Filter, TArray<FIntPoint> & OutPath) const;
 
+	/**
+	 * Finds path to the closest of end cells in one multi-goal search instead of one search per end cell. OutEndIndex is
+	 * index of reached end cell in EndGridCoords, INDEX_NONE if none was reached.
+	 */
+	ENavigationQueryResult::Type FindPathToNearest(FIntPoint const StartGridCoord, TConstArrayView<FIntPoint> const EndGridCoords, FCBNavGridAStarFilter const & Filter, TArray<FIntPoint> & OutPath, int32 & OutEndIndex) const;
+
+	/**
+	 * Searches tile entrances graph first if start and end are in different tiles, then refines found path to cells.
+	 * Entrances graph ignores blocking planes, area costs and clearances, so filters selecting any plane, having area
+	 * costs or agent radius fall back to grid search.
+	 */
+	ENavigationQueryResult::Type FindHierarchicalPath(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord, FCBNavGridAStarFilter const & Filter, TArray<FIntPoint> & OutPath) const;
+
 	FORCEINLINE TArray<FIntPoint> GetTileCoords() const;
 	FORCEINLINE FIntPoint GetTileSize() const;
 	FORCEINLINE bool IsValidTileCoord(FIntPoint const TileCoord) const;
+
+	FIntRect GetBoundingGridRect() const;
 	bool GetHeight(FVector2d const & Location, float & OutHeight) const;
 	FIntPoint GetTileCoord(FIntPoint const GridCoord) const;
 	TSharedPtr<FCBNavGridLayer const> GetTileNavigationData(FIntPoint const TileCoord) const;
+
+	/**
+	 * Doesn't touch shared pointer refcount or lock. Off game thread must be called within FCBNavGridReadScope,
+	 * returned layer stays valid and unchanged until the scope ends.
+	 */
+	FORCEINLINE FCBNavGridLayer const * FindTileNavigationData(FIntPoint const TileCoord) const;
 	TSharedPtr<FCBHeightfield const> GetTileHeightfield(FIntPoint const TileCoord) const;
 	void OnTileGenerationCompleted(FIntPoint const TileCoord, TUniquePtr<FCBNavGridLayer const> GeneratedNavGridLayer, TUniquePtr<FCBHeightfield const> GeneratedHeightfield);
 
+	/** Broadcast on game thread after tile is generated, removed or its overlay is stamped, e.g. to update FCBNavGridDistanceMap. */
+	FORCEINLINE FCBNavGridTileChangedDelegate & OnTileChanged();
+
+	/**
+	 * Rebuilds islands index, called once per batch of completed tiles. Islands touching tiles completed since the last
+	 * rebuild are treated as unknown until then.
+	 */
+	void UpdateIslands();
+
+	/** Returns true only if both cells are free and known to be disconnected. */
+	bool AreInDifferentIslands(FIntPoint const GridCoord1, FIntPoint const GridCoord2) const;
+
+	/**
+	 * Counts occupied cells in grid rect across tile seams, cells of missing tiles are counted as occupied.
+	 * Takes constant time per overlapped tile if tiles are built with occupied cells sums.
+	 */
+	int64 CountOccupiedCells(FIntRect const & GridRect) const;
+
+	/**
+	 * Tests footprint at every position of CandidateRect in one word-parallel pass, position is grid coord of footprint
+	 * min corner. Bit of OutValidPositions is set if all footprint cells are free, bits follow column-major order of
+	 * CandidateRect. Cells of missing tiles are treated as occupied. OutValidPositions is empty for invalid arguments.
+	 */
+	void FindValidFootprintPositions(FIntRect const & CandidateRect, FIntPoint const FootprintSize, TBitArray<> & OutValidPositions) const;
+
+	/** Footprint cells are set bits of FootprintMask, which covers rect of FootprintSize in column-major order. */
+	void FindValidFootprintPositions(FIntRect const & CandidateRect, FIntPoint const FootprintSize, TBitArray<> const & FootprintMask, TBitArray<> & OutValidPositions) const;
+
+	/**
+	 * Finds position nearest to OriginGridCoord where footprint of FootprintSize with min corner at the position covers
+	 * only free cells. If MaxHeightDifference isn't negative, heights of footprint cells must also differ by no more
+	 * than it. Tiles are searched in square rings around tile of OriginGridCoord, tiles without free cells are skipped.
+	 */
+	bool FindNearestFootprintPosition(FIntPoint const OriginGridCoord, FIntPoint const FootprintSize, float const MaxHeightDifference, FIntPoint & OutPosition) const;
+
+	/**
+	 * Stamps gameplay occupancy overlay of tiles under the shape synchronously, without tile regeneration. Queries see
+	 * overlay combined with generated occupancy. Overlay is kept when tiles are regenerated and dropped with removed
+	 * tiles. Islands aren't updated, they stay conservative since overlay only blocks cells of generated components.
+	 * If PlaneIndex isn't INDEX_NONE, the shape is stamped into that blocking plane, which is seen only by queries
+	 * selecting it in filter's blocking planes mask. Invalid plane indices are ignored.
+	 */
+	void SetOverlayCellsState(FIntRect const & GridRect, bool const bIsOccupied, int32 const PlaneIndex = INDEX_NONE);
+	void SetOverlayCellsStateInBox(FBox2d const & Box, bool const bIsOccupied, int32 const PlaneIndex = INDEX_NONE);
+	void SetOverlayCellsStateInCircle(FVector2d const CircleOrigin, double const Radius, bool const bIsOccupied, int32 const PlaneIndex = INDEX_NONE);
+	void SetOverlayCellsStateInConvex(TArray<FVector2d> const & CCWConvex, bool const bIsOccupied, int32 const PlaneIndex = INDEX_NONE);
+
+	/** Returns INDEX_NONE if there is no blocking plane with such name. */
+	int32 FindBlockingPlaneIndex(FName const PlaneName) const;
+
+	/** Returns mask selecting named blocking planes for FCBNavGridQueryFilter, unknown names are ignored. */
+	uint32 GetBlockingPlanesMask(TConstArrayView<FName> const PlaneNames) const;
+	int32 GetBlockingPlanesNum() const;
+
+	/**
+	 * Returns min cell clearance an agent of the radius fits in. Returns FCBNavGridLayer::NoFitClearance if it exceeds
+	 * MaxClearance, logging warning for the first such agent only. Returns 0 if radius isn't positive, clearance of 1 is enough or clearances aren't built.
+	 */
+	uint8 GetRequiredClearance(float const AgentRadius) const;
+
+	/**
+	 * Returns flow field towards goal over GridRect clipped with grid bounds, field is built on the first request and
+	 * cached per goal and rect until any tile it covers changes. Returns nullptr if goal cell isn't free.
+	 */
+	TSharedPtr<FCBNavGridFlowField const> FindOrBuildFlowField(FIntPoint const GoalGridCoord, FIntRect const & GridRect) const;
+
 	FORCEINLINE float GetGridCellSize() const;
 	FORCEINLINE float GetMaxNavigableCellHeightsDifference() const;
 	FORCEINLINE float GetMinZ() const;
 	FORCEINLINE float GetMaxZ() const;
+	FORCEINLINE bool ShouldBuildOccupiedCellsSums() const;
+	FORCEINLINE uint8 GetMaxClearance() const;
 	FORCEINLINE FCBNavGridDebugSettings const & GetDebugSettings() const;
+
+	/** Returns INVALID_GRIDCOORD if node ref is stale, i.e. its tile was changed or removed since the ref was made. */
 	FIntPoint GetGridCoord(NavNodeRef const NodeRef) const;
+
+	/** Returns INVALID_NAVNODEREF if cell's tile doesn't exist. */
 	NavNodeRef GetNodeRef(FIntPoint const GridCoord) const;
 
 	static FIntPoint const INVALID_GRIDCOORD;
 
 protected:
 	static FPathFindingResult FindPath(FNavAgentProperties const & AgentProperties, FPathFindingQuery const & Query);
+	static FPathFindingResult FindHierarchicalPath(FNavAgentProperties const & AgentProperties, FPathFindingQuery const & Query);
+	static FPathFindingResult FindPathForQuery(FPathFindingQuery const & Query, bool const bHierarchical);
 	static bool TestPath(FNavAgentProperties const & AgentProperties, FPathFindingQuery const & Query, int32 * const OutNumVisitedNodes);
+	static bool TestHierarchicalPath(FNavAgentProperties const & AgentProperties, FPathFindingQuery const & Query, int32 * const OutNumVisitedNodes);
+	static bool TestPathForQuery(FPathFindingQuery const & Query, int32 * const OutNumVisitedNodes, bool const bHierarchical);
 	static bool Raycast(ANavigationData const * Self, FVector const & RayStart, FVector const & RayEnd, FVector & OutHitLocation, FNavigationRaycastAdditionalResults * OutAdditionalResults, FSharedConstNavQueryFilter QueryFilter, UObject const * Querier);
 
-	ENavigationQueryResult::Type FindPath(FCBNavGridPath & OutPath, FPathFindingQuery const & Query) const;
+	ENavigationQueryResult::Type FindPath(FCBNavGridPath & OutPath, FPathFindingQuery const & Query, bool const bHierarchical) const;
 	void PostprocessPath(FVector const & StartLocation, FIntPoint const StartGridCoord, FVector const & EndLocation, FIntPoint const EndGridCoord, TConstArrayView<FIntPoint> const GridPath, FCBNavGridPath & OutPath) const;
-	bool TestPath(FPathFindingQuery const & Query, int32 * const OutNumVisitedNodes) const;
+	bool TestPath(FPathFindingQuery const & Query, int32 * const OutNumVisitedNodes, bool const bHierarchical) const;
 
 	/** Relies on StartGridCoords being valid and traversable. */
 	void FindOverlappingEdgesUnsafe(TConstArrayView<FIntPoint> const StartGridCoords, TConstArrayView<FVector> const SearchArea, TArray<FVector> & OutEdges) const;
 
 	/** Invalidates active paths that go through changed tile. */
 	void InvalidateAffectedPaths(FIntPoint const ChangedTileCoord);
+
+	/** Drops cached flow fields covering changed tile. */
+	void InvalidateAffectedFlowFields(FIntPoint const ChangedTileCoord);
 	FIntRect CalculateBoundingGridRect() const;
 	void RequestDrawingUpdate();
 	FORCEINLINE FNavigationQueryFilter const & GetFilterRef(FNavigationQueryFilter const * const Filter) const;
@@ -153,19 +291,121 @@ protected:
 #endif // WITH_EDITOR
 
 private:
+	friend class FCBNavGridReadScope;
+
 	struct FTileData
 	{
-		TSharedPtr<FCBNavGridLayer const> NavigationData;
+		FIntPoint Coord;
+
+		/** Changed in place on game thread under write lock of TilesLock. */
+		TSharedPtr<FCBNavGridLayer> NavigationData;
 		TSharedPtr<FCBHeightfield const> Heightfield;
 	};
 
+	/** Tile data read from archive, layer isn't shared until it is set up for this nav grid. */
+	struct FLoadedTileData
+	{
+		TSharedPtr<FCBNavGridLayer> NavigationData;
+		TSharedPtr<FCBHeightfield> Heightfield;
+	};
+
 	friend FArchive & operator <<(FArchive & Archive, FTileData & TileData);
+	friend FArchive & operator <<(FArchive & Archive, FLoadedTileData & TileData);
+
+	FORCEINLINE int32 FindTileIndex(FIntPoint const TileCoord) const;
+	FORCEINLINE FTileData const * FindTileData(FIntPoint const TileCoord) const;
+
+	/** Doesn't bump tile generation, so changes of returned tile data are expected to keep its node refs valid. */
+	FORCEINLINE FTileData * FindTileData(FIntPoint const TileCoord);
+
+	/** Bumps tile generation, since returned tile data is expected to be modified. Expects write lock of TilesLock. */
+	FTileData & FindOrAddTileData(FIntPoint const TileCoord);
+
+	/** Expects write lock of TilesLock. */
+	bool RemoveTileData(FIntPoint const TileCoord, FTileData & OutTileData);
+	void BumpTileGeneration(int32 const TileIndex);
 
-	/** If tile is in the map, it must always have valid(not nullptr) NavigationData field of FTileData. */
-	TMap<FIntPoint, FTileData> Tiles;
+	/** Decodes node ref if it isn't stale. */
+	bool DecodeNodeRef(NavNodeRef const NodeRef, FTileData const *& OutTileData, uint32 & OutCellIndex) const;
+	void EmptyTiles();
 
-	/** Cached bounding grid rect. */
-	mutable FIntRect BoundingGridRect;
+	/** Grows tile table to contain the tile, with slack in the direction of growth. Expects write lock of TilesLock. */
+	void GrowTileTable(FIntPoint const TileCoord);
+
+	void InvalidateRandomPointIndex();
+
+	/** Expects RandomPointIndexLock to be held. */
+	void UpdateRandomPointIndex() const;
+
+	/** Resizes blocking planes of tiles having other planes number to GetBlockingPlanesNum. */
+	void UpdateTilesBlockingPlanesNum();
+
+	/**
+	 * Applies stamp to layer of every tile overlapping grid rect and updates data depending on tile occupancy within the
+	 * rect, i.e. free cell counts, entrances graph, paths and flow fields. Clearances are updated within MaxClearance
+	 * cells around the rect, in neighbour tiles too.
+	 */
+	template <typename TStamp>
+	void StampOverlay(FIntRect const & GridRect, int32 const PlaneIndex, TStamp && Stamp);
+
+	/** Recomputes clearances of tile cells within grid rects, reading occupancy of neighbouring tiles. */
+	void UpdateTileClearances(FIntPoint const TileCoord, TConstArrayView<FIntRect> const GridRects);
+
+	/**
+	 * Refreshes clearances depending on cells of changed tile, i.e. border bands of the tile and bands of neighbouring
+	 * tiles within MaxClearance cells from it. Inner cells of generated tile are already computed by its generator.
+	 */
+	void UpdateClearancesAround(FIntPoint const TileCoord);
+
+	/** Tile in the array must always have valid(not nullptr) NavigationData field of FTileData. */
+	TSparseArray<FTileData> Tiles;
+
+	/**
+	 * Guards tiles, tile table, bounding rect and tile layers. Game thread takes write lock for changes of them only,
+	 * other threads read them within FCBNavGridReadScope. Taken before any other lock of nav grid.
+	 */
+	mutable FRWLock TilesLock;
+
+	/** Dense table over TileTableRect mapping tile coords to indices in Tiles, INDEX_NONE for missing tiles. */
+	TArray<int32> TileTable;
+	FIntRect TileTableRect;
+
+	/**
+	 * Generation of every index in Tiles, encoded into node refs to detect stale ones. Kept when tiles are emptied,
+	 * so refs made before clean up stay stale. Generation 0 is never used.
+	 */
+	TArray<uint16> TileGenerations;
+
+	/** Grid rect bounding all tiles, updated whenever tiles are added or removed. */
+	FIntRect BoundingGridRect;
+
+	/**
+	 * Cached index of tiles with free cells for uniform random point sampling, invalidated under write lock of TilesLock
+	 * on any change of free cells and rebuilt by the first query after it under the lock. Element I of prefix sums is
+	 * number of free cells in tiles up to RandomPointTiles[I] inclusive.
+	 */
+	mutable TArray<FCBNavGridLayer const *> RandomPointTiles;
+	mutable TArray<int64> RandomPointTilesPrefixSums;
+	mutable bool bIsRandomPointIndexValid = false;
+	mutable FCriticalSection RandomPointIndexLock;
+
+	/** Flow fields cached by FindOrBuildFlowField, least recently used first. */
+	mutable TArray<TSharedPtr<FCBNavGridFlowField const>> FlowFields;
+
+	/** Bumped whenever cached flow fields are dropped, so fields built meanwhile aren't cached. */
+	uint32 FlowFieldsGeneration = 0;
+	mutable FCriticalSection FlowFieldsLock;
+
+	/** Queries for agents too big for MaxClearance may come every frame, so they are reported once. */
+	mutable std::atomic<bool> bHasWarnedAboutTooBigAgent = false;
+
+	FCBNavGridTileChangedDelegate TileChangedDelegate;
+
+	/** Graph of tile entrances used by hierarchical queries, kept in sync with Tiles. */
+	TUniquePtr<FCBNavGridAbstractGraph> AbstractGraph;
+
+	/** Connectivity index used to reject queries between disconnected cells without search. */
+	TUniquePtr<FCBNavGridIslands> Islands;
 
 protected:
 	UPROPERTY(EditAnywhere, Category = Display)
@@ -186,6 +426,24 @@ protected:
 	UPROPERTY(EditAnywhere, Category = Generation, Config)
 	float MaxZ;
 
+	/** Builds summed-area table of occupied cells per tile for constant time rect counting, costs 2 bytes per cell. */
+	UPROPERTY(EditAnywhere, Category = Generation, Config)
+	uint8 bBuildOccupiedCellsSums : 1;
+
+	/**
+	 * Names of occupancy planes stamped by gameplay, e.g. reserved construction sites. Plane blocks only queries which
+	 * filters select it, costs 1 bit per cell. Planes beyond FCBNavGridLayer::MaxBlockingPlanesNum are ignored.
+	 */
+	UPROPERTY(EditAnywhere, Category = Generation, Config)
+	TArray<FName> BlockingPlaneNames;
+
+	/**
+	 * Max distance to obstacles in cells built per tile for agent radius queries, 0 disables clearances, costs 1 byte
+	 * per cell. Larger values also widen border bands recomputed on game thread when tiles change.
+	 */
+	UPROPERTY(EditAnywhere, Category = Generation, Config, meta = (ClampMax = 254))
+	uint8 MaxClearance;
+
 	UPROPERTY(EditAnywhere, Category = Query, Config)
 	uint32 DefaultMaxSearchNodes;
 
@@ -194,6 +452,14 @@ protected:
 
 	UPROPERTY(EditAnywhere, Category = Query, Config, meta = (ClampMin = "0.1", UIMin = "0.1"))
 	FVector2f DefaultAxiswiseHeuristicScale;
+
+	/** If set, default filter searches with fixed point integer costs and radix heap open list. */
+	UPROPERTY(EditAnywhere, Category = Query, Config)
+	uint8 bDefaultUseFixedPointCosts : 1;
+
+	/** If set, default filter uses jump point search. */
+	UPROPERTY(EditAnywhere, Category = Query, Config)
+	uint8 bDefaultUseJumpPointSearch : 1;
 };
 
 FIntPoint ACBNavGrid::GetTileSize() const
@@ -203,14 +469,48 @@ FIntPoint ACBNavGrid::GetTileSize() const
 
 TArray<FIntPoint> ACBNavGrid::GetTileCoords() const
 {
+	FCBNavGridReadScope const ReadScope{ *this };
 	TArray<FIntPoint> TileCoords;
-	Tiles.GenerateKeyArray(TileCoords);
+	TileCoords.Reserve(Tiles.Num());
+	for (FTileData const & TileData : Tiles)
+	{
+		TileCoords.Add(TileData.Coord);
+	}
 	return TileCoords;
 }
 
 bool ACBNavGrid::IsValidTileCoord(FIntPoint const TileCoord) const
 {
-	return Tiles.Contains(TileCoord);
+	FCBNavGridReadScope const ReadScope{ *this };
+	return FindTileIndex(TileCoord) != INDEX_NONE;
+}
+
+FCBNavGridLayer const * ACBNavGrid::FindTileNavigationData(FIntPoint const TileCoord) const
+{
+	FTileData const * const TileData = FindTileData(TileCoord);
+	return TileData ? TileData->NavigationData.Get() : nullptr;
+}
+
+int32 ACBNavGrid::FindTileIndex(FIntPoint const TileCoord) const
+{
+	if (!TileTableRect.Contains(TileCoord))
+	{
+		return INDEX_NONE;
+	}
+	FIntPoint const TableCoord = TileCoord - TileTableRect.Min;
+	return TileTable[TableCoord.X * TileTableRect.Height() + TableCoord.Y];
+}
+
+ACBNavGrid::FTileData const * ACBNavGrid::FindTileData(FIntPoint const TileCoord) const
+{
+	int32 const TileIndex = FindTileIndex(TileCoord);
+	return TileIndex == INDEX_NONE ? nullptr : &Tiles[TileIndex];
+}
+
+ACBNavGrid::FTileData * ACBNavGrid::FindTileData(FIntPoint const TileCoord)
+{
+	int32 const TileIndex = FindTileIndex(TileCoord);
+	return TileIndex == INDEX_NONE ? nullptr : &Tiles[TileIndex];
 }
 
 float ACBNavGrid::GetGridCellSize() const
@@ -233,11 +533,26 @@ float ACBNavGrid::GetMaxZ() const
 	return MaxZ;
 }
 
+bool ACBNavGrid::ShouldBuildOccupiedCellsSums() const
+{
+	return bBuildOccupiedCellsSums;
+}
+
+uint8 ACBNavGrid::GetMaxClearance() const
+{
+	return MaxClearance;
+}
+
 FCBNavGridDebugSettings const & ACBNavGrid::GetDebugSettings() const
 {
 	return DebugSettings;
 }
 
+FCBNavGridTileChangedDelegate & ACBNavGrid::OnTileChanged()
+{
+	return TileChangedDelegate;
+}
+
 FNavigationQueryFilter const & ACBNavGrid::GetFilterRef(FNavigationQueryFilter const * const Filter) const
 {
 	return *(Filter ? Filter : GetDefaultQueryFilter().Get());
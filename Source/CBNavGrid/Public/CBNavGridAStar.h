@@ -1,151 +1,137 @@
-#pragma once 
+#pragma once
 
 #include "CBNavGrid.h"
-#include "CBNavGridLayer.h"
 
-struct FCBNavGridAStarNode;
-
-class CBNAVGRID_API FCBNavGridToGraphAdapter
+enum class ECBNavGridAStarResult : uint8
 {
-public:
-	using FLocation = FIntPoint;
-	using FNodeRef = FLocation;
-	using FAStarSearchNode = FCBNavGridAStarNode;
-
-	FORCEINLINE explicit FCBNavGridToGraphAdapter(ACBNavGrid const & InNavGrid);
-
-	FORCEINLINE bool IsValidRef(FNodeRef const NodeRef) const;
-	int32 GetNeighbourCount(FNodeRef const NodeRef) const;
-	FNodeRef GetNeighbour(FAStarSearchNode const & SearchNode, int32 const NeighbourIndex) const;
-
-private:
-	ACBNavGrid const & NavGrid;
-	mutable FCBNavGridLayer const * NavGridLayer;
-};
-
-struct CBNAVGRID_API FCBNavGridAStarNode
-{
-	using FGraphNodeRef = typename FCBNavGridToGraphAdapter::FNodeRef;
-
-	FORCEINLINE FCBNavGridAStarNode(FGraphNodeRef const & InNodeRef);
-	FORCEINLINE void MarkOpened();
-	FORCEINLINE void MarkNotOpened();
-	FORCEINLINE void MarkClosed();
-	FORCEINLINE void MarkNotClosed();
-	FORCEINLINE bool IsOpened() const;
-	FORCEINLINE bool IsClosed() const;
-
-	FGraphNodeRef const NodeRef;
-	FGraphNodeRef ParentRef;
-	FVector::FReal TraversalCost;
-	FVector::FReal TotalCost;
-	int32 SearchNodeIndex;
-	int32 ParentNodeIndex;
-	uint8 bIsOpened : 1;
-	uint8 bIsClosed : 1;
+	/** Start or end cell is not traversable. */
+	SearchFail,
+	SearchSuccess,
+	GoalUnreachable
 };
 
 class CBNAVGRID_API FCBNavGridAStarFilter
 {
 public:
-	using FGraph = FCBNavGridToGraphAdapter;
-	using FNodeRef = FGraph::FNodeRef;
-	using FAStarSearchNode = FCBNavGridAStarNode;
-
 	FORCEINLINE explicit FCBNavGridAStarFilter(
 		FVector::FReal const InHeuristicScale = 1.,
 		FVector2d const InAxiswiseHeuristicScale = FVector2d{ 1., 1. },
 		FVector::FReal const InCostLimit = TNumericLimits<FVector::FReal>::Max(),
 		uint32 const InMaxSearchNodes = 2048,
-		bool const bInWantsPartialSolution = false);
+		bool const bInWantsPartialSolution = false,
+		bool const bInUseFixedPointCosts = false,
+		bool const bInUseJumpPointSearch = false,
+		bool const bInUseAnyAngleSearch = false,
+		uint32 const InBlockingPlanesMask = 0,
+		TConstArrayView<float> const InAreaCosts = {},
+		TConstArrayView<float> const InAreaEnteringCosts = {},
+		float const InAgentRadius = 0.f);
 	FORCEINLINE FVector2d const & GetAxiswiseHeuristicScale() const;
 	FORCEINLINE FVector::FReal GetHeuristicScale() const;
-	FORCEINLINE FVector::FReal GetHeuristicCost(FAStarSearchNode const & StartNode, FAStarSearchNode const & EndNode) const;
-	FORCEINLINE FVector::FReal GetTraversalCost(FAStarSearchNode const & StartNode, FAStarSearchNode const & EndNode) const;
-	FORCEINLINE bool IsTraversalAllowed(FNodeRef const NodeA, FNodeRef const NodeB) const;
+	FORCEINLINE FVector::FReal GetHeuristicCost(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord) const;
+	FORCEINLINE FVector::FReal GetTraversalCost(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord) const;
+	FORCEINLINE bool IsTraversalAllowed(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord) const;
 	FORCEINLINE bool WantsPartialSolution() const;
-	FORCEINLINE bool ShouldIgnoreClosedNodes() const;
-	FORCEINLINE bool ShouldIncludeStartNodeInPath() const;
+	FORCEINLINE bool UsesFixedPointCosts() const;
+
+	/** Jump point search ignores IsTraversalAllowed and area costs, it relies on GetTraversalCost being uniform. */
+	FORCEINLINE bool UsesJumpPointSearch() const;
+
+	/**
+	 * Any-angle search uses euclidean step costs, ignores IsTraversalAllowed and area costs and takes precedence over
+	 * jump point search.
+	 */
+	FORCEINLINE bool UsesAnyAngleSearch() const;
 	FORCEINLINE uint32 GetMaxSearchNodes() const;
 	FORCEINLINE FVector::FReal GetCostLimit() const;
 
+	/** Blocking planes of nav grid treated as occupied, see FCBNavGridQueryFilter::GetBlockingPlanesMask. */
+	FORCEINLINE uint32 GetBlockingPlanesMask() const;
+
+	/**
+	 * Area cost tables are indexed by cell area id and aren't owned by filter, they must outlive it. Only adjacent
+	 * cells expansion applies them, see FCBNavGridQueryFilter::HasAreaCosts.
+	 */
+	FORCEINLINE bool HasAreaCosts() const;
+	FORCEINLINE bool IsAreaAllowed(uint8 const AreaId) const;
+
+	/** Scales cost of step into cell of EndAreaId and adds entering cost if area changes. */
+	FORCEINLINE FVector::FReal GetAreaTraversalCost(FVector::FReal const TraversalCost, uint8 const StartAreaId, uint8 const EndAreaId) const;
+
+	/** Cells without clearance for agent of the radius are treated as occupied, see ACBNavGrid::GetRequiredClearance. */
+	FORCEINLINE float GetAgentRadius() const;
+
 private:
+	TConstArrayView<float> AreaCosts;
+	TConstArrayView<float> AreaEnteringCosts;
 	FVector::FReal HeuristicScale;
 	FVector2d AxiswiseHeuristicScale;
 	FVector::FReal CostLimit;
 	uint32 MaxSearchNodes;
+	uint32 BlockingPlanesMask;
+	float AgentRadius;
 	uint8 bWantsPartialSolution : 1;
+	uint8 bUseFixedPointCosts : 1;
+	uint8 bUseJumpPointSearch : 1;
+	uint8 bUseAnyAngleSearch : 1;
 };
 
-FCBNavGridToGraphAdapter::FCBNavGridToGraphAdapter(ACBNavGrid const & InNavGrid)
-	: NavGrid(InNavGrid)
-	, NavGridLayer(nullptr)
+/**
+ * A* over navigation grid. Instead of node pool hashed by node refs, search state is kept in flat per tile arrays
+ * indexed by cell index. Arrays are owned by the calling thread and reused between searches, nodes left from previous
+ * searches are told apart by search stamp, so search doesn't hash coords and doesn't allocate once arrays are warmed up.
+ */
+class CBNAVGRID_API FCBNavGridAStar
 {
-}
-
-bool FCBNavGridToGraphAdapter::IsValidRef(FNodeRef const NodeRef) const
-{
-	if (NavGridLayer && NavGridLayer->IsInGrid(NodeRef))
-	{
-		return !NavGridLayer->IsCellOccupied(NodeRef);
-	}
-	NavGridLayer = NavGrid.GetTileNavigationData(NavGrid.GetTileCoord(NodeRef)).Get();
-	return NavGridLayer && !NavGridLayer->IsCellOccupied(NodeRef);
-}
-
-FCBNavGridAStarNode::FCBNavGridAStarNode(FGraphNodeRef const & InNodeRef)
-	: NodeRef(InNodeRef)
-	, ParentRef(TNumericLimits<FIntPoint::IntType>::Min()) // Some value that won't be ever used as ref.
-	, TraversalCost(TNumericLimits<FVector::FReal>::Max())
-	, TotalCost(TNumericLimits<FVector::FReal>::Max())
-	, SearchNodeIndex(INDEX_NONE)
-	, ParentNodeIndex(INDEX_NONE)
-	, bIsOpened(false)
-	, bIsClosed(false)
-{
-}
-
-void FCBNavGridAStarNode::MarkOpened()
-{
-	bIsOpened = true;
-}
+public:
+	FORCEINLINE explicit FCBNavGridAStar(ACBNavGrid const & InNavGrid);
 
-void FCBNavGridAStarNode::MarkNotOpened()
-{
-	bIsOpened = false;
-}
+	/**
+	 * Found path includes start cell. If start and end cells are the same, path is left empty.
+	 * Consecutive cells of any-angle path are not adjacent, but are visible from each other.
+	 */
+	ECBNavGridAStarResult FindPath(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord, FCBNavGridAStarFilter const & Filter, TArray<FIntPoint> & OutPath);
 
-void FCBNavGridAStarNode::MarkClosed()
-{
-	bIsClosed = true;
-}
+	/**
+	 * Finds path to the end cell closest by path cost in one multi-goal search, OutEndIndex is index of reached end
+	 * cell in EndGridCoords. Search always expands adjacent cells, jump point and any-angle settings are ignored.
+	 * Invalid and occupied end cells are skipped.
+	 */
+	ECBNavGridAStarResult FindPathToNearest(FIntPoint const StartGridCoord, TConstArrayView<FIntPoint> const EndGridCoords, FCBNavGridAStarFilter const & Filter, TArray<FIntPoint> & OutPath, int32 & OutEndIndex);
 
-void FCBNavGridAStarNode::MarkNotClosed()
-{
-	bIsClosed = false;
-}
+	/** Number of nodes visited by the last search. */
+	FORCEINLINE int32 GetVisitedNodesNum() const;
 
-bool FCBNavGridAStarNode::IsOpened() const
-{
-	return bIsOpened;
-}
-
-bool FCBNavGridAStarNode::IsClosed() const
-{
-	return bIsClosed;
-}
+private:
+	ACBNavGrid const & NavGrid;
+	int32 VisitedNodesNum;
+};
 
 FCBNavGridAStarFilter::FCBNavGridAStarFilter(
 	FVector::FReal const InHeuristicScale,
 	FVector2d const InAxiswiseHeuristicScale,
 	FVector::FReal const InCostLimit,
 	uint32 const InMaxSearchNodes,
-	bool const bInWantsPartialSolution)
-	: HeuristicScale(InHeuristicScale)
+	bool const bInWantsPartialSolution,
+	bool const bInUseFixedPointCosts,
+	bool const bInUseJumpPointSearch,
+	bool const bInUseAnyAngleSearch,
+	uint32 const InBlockingPlanesMask,
+	TConstArrayView<float> const InAreaCosts,
+	TConstArrayView<float> const InAreaEnteringCosts,
+	float const InAgentRadius)
+	: AreaCosts(InAreaCosts)
+	, AreaEnteringCosts(InAreaEnteringCosts)
+	, HeuristicScale(InHeuristicScale)
 	, AxiswiseHeuristicScale(InAxiswiseHeuristicScale)
 	, CostLimit(InCostLimit)
 	, MaxSearchNodes(InMaxSearchNodes)
+	, BlockingPlanesMask(InBlockingPlanesMask)
+	, AgentRadius(InAgentRadius)
 	, bWantsPartialSolution(bInWantsPartialSolution)
+	, bUseFixedPointCosts(bInUseFixedPointCosts)
+	, bUseJumpPointSearch(bInUseJumpPointSearch)
+	, bUseAnyAngleSearch(bInUseAnyAngleSearch)
 {
 }
 
@@ -159,24 +145,22 @@ FVector::FReal FCBNavGridAStarFilter::GetHeuristicScale() const
 	return HeuristicScale;
 }
 
-FVector::FReal FCBNavGridAStarFilter::GetHeuristicCost(FAStarSearchNode const & StartNode, FAStarSearchNode const & EndNode) const
+FVector::FReal FCBNavGridAStarFilter::GetHeuristicCost(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord) const
 {
-	FNodeRef const StartNodeRef = StartNode.NodeRef;
-	FNodeRef const EndNodeRef = EndNode.NodeRef;
-	FVector::FReal const XAxisPart = static_cast<FVector::FReal>(FMath::Abs(StartNodeRef.X - EndNodeRef.X)) * AxiswiseHeuristicScale.X;
-	FVector::FReal const YAxisPart = static_cast<FVector::FReal>(FMath::Abs(StartNodeRef.Y - EndNodeRef.Y)) * AxiswiseHeuristicScale.Y;
+	FVector::FReal const XAxisPart = static_cast<FVector::FReal>(FMath::Abs(StartGridCoord.X - EndGridCoord.X)) * AxiswiseHeuristicScale.X;
+	FVector::FReal const YAxisPart = static_cast<FVector::FReal>(FMath::Abs(StartGridCoord.Y - EndGridCoord.Y)) * AxiswiseHeuristicScale.Y;
 	return XAxisPart + YAxisPart;
 }
 
-FVector::FReal FCBNavGridAStarFilter::GetTraversalCost(FAStarSearchNode const & StartNode, FAStarSearchNode const & EndNode) const
+FVector::FReal FCBNavGridAStarFilter::GetTraversalCost(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord) const
 {
-	check((EndNode.NodeRef - StartNode.NodeRef).SizeSquared() == 1);
+	check((EndGridCoord - StartGridCoord).SizeSquared() == 1);
 	return 1.;
 }
 
-bool FCBNavGridAStarFilter::IsTraversalAllowed(FNodeRef const NodeA, FNodeRef const NodeB) const
+bool FCBNavGridAStarFilter::IsTraversalAllowed(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord) const
 {
-	check((NodeB - NodeA).SizeSquared() == 1);
+	check((EndGridCoord - StartGridCoord).SizeSquared() == 1);
 	return true;
 }
 
@@ -185,14 +169,19 @@ bool FCBNavGridAStarFilter::WantsPartialSolution() const
 	return bWantsPartialSolution;
 }
 
-bool FCBNavGridAStarFilter::ShouldIgnoreClosedNodes() const
+bool FCBNavGridAStarFilter::UsesFixedPointCosts() const
 {
-	return true;
+	return bUseFixedPointCosts;
 }
 
-bool FCBNavGridAStarFilter::ShouldIncludeStartNodeInPath() const
+bool FCBNavGridAStarFilter::UsesJumpPointSearch() const
 {
-	return true;
+	return bUseJumpPointSearch;
+}
+
+bool FCBNavGridAStarFilter::UsesAnyAngleSearch() const
+{
+	return bUseAnyAngleSearch;
 }
 
 uint32 FCBNavGridAStarFilter::GetMaxSearchNodes() const
@@ -204,3 +193,40 @@ FVector::FReal FCBNavGridAStarFilter::GetCostLimit() const
 {
 	return CostLimit;
 }
+
+uint32 FCBNavGridAStarFilter::GetBlockingPlanesMask() const
+{
+	return BlockingPlanesMask;
+}
+
+bool FCBNavGridAStarFilter::HasAreaCosts() const
+{
+	return !AreaCosts.IsEmpty();
+}
+
+bool FCBNavGridAStarFilter::IsAreaAllowed(uint8 const AreaId) const
+{
+	return AreaCosts[AreaId] < TNumericLimits<float>::Max();
+}
+
+FVector::FReal FCBNavGridAStarFilter::GetAreaTraversalCost(FVector::FReal const TraversalCost, uint8 const StartAreaId, uint8 const EndAreaId) const
+{
+	FVector::FReal const AreaTraversalCost = TraversalCost * AreaCosts[EndAreaId];
+	return StartAreaId == EndAreaId ? AreaTraversalCost : AreaTraversalCost + AreaEnteringCosts[EndAreaId];
+}
+
+float FCBNavGridAStarFilter::GetAgentRadius() const
+{
+	return AgentRadius;
+}
+
+FCBNavGridAStar::FCBNavGridAStar(ACBNavGrid const & InNavGrid)
+	: NavGrid(InNavGrid)
+	, VisitedNodesNum(0)
+{
+}
+
+int32 FCBNavGridAStar::GetVisitedNodesNum() const
+{
+	return VisitedNodesNum;
+}
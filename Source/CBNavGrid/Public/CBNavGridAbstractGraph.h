@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CBNavGridAStar.h"
+#include "CoreMinimal.h"
+
+class FCBNavGridLayer;
+
+/**
+ * Abstract graph of hierarchical pathfinding, tiles of nav grid are used as clusters. Nodes are cells on tile borders
+ * through which paths can cross to adjacent tile. Every node is connected to its counterpart across the border and to
+ * nodes of the same tile reachable without leaving the tile. Paths are searched on the graph first, then found
+ * abstract path is refined to cells segment by segment, so long queries cost about the number of crossed tiles.
+ * Graph is modified on game thread only, queries may run on any thread. Intra edges of changed tiles are rebuilt by
+ * the first query after the change, so a burst of changes costs one rebuild per tile.
+ */
+class CBNAVGRID_API FCBNavGridAbstractGraph
+{
+public:
+	explicit FCBNavGridAbstractGraph(ACBNavGrid const & InNavGrid);
+
+	/** Rebuilds entrances on all borders of the tile, intra edges of the tile and its neighbours are marked dirty. */
+	void OnTileChanged(FIntPoint const TileCoord);
+
+	/**
+	 * Rebuilds entrances only on borders of the tile crossed by changed grid rect, intra edges of the tile and of
+	 * neighbours across rebuilt borders are marked dirty. Meant for overlay stamps, which change a few cells of existing tile.
+	 */
+	void OnTileCellsChanged(FIntPoint const TileCoord, FIntRect const & GridRect);
+
+	/** Rebuilds graph for all tiles of nav grid. */
+	void Rebuild();
+	void Reset();
+
+	/** Found path includes start cell. Start and end cells are expected to be in different tiles. */
+	ECBNavGridAStarResult FindPath(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord, FCBNavGridAStarFilter const & Filter, TArray<FIntPoint> & OutPath, int32 * const OutVisitedNodesNum = nullptr) const;
+
+	/** Searches only for abstract path, without refining it to cells. */
+	ECBNavGridAStarResult TestPath(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord, FCBNavGridAStarFilter const & Filter, int32 * const OutVisitedNodesNum = nullptr) const;
+
+private:
+	static constexpr int32 BordersNum = 4;
+
+	struct FIntraEdge
+	{
+		int32 NodeIndex;
+		int32 Cost;
+	};
+
+	struct FNode
+	{
+		FIntPoint GridCoord;
+		FIntPoint TileCoord;
+		int32 InterEdgeNodeIndex;
+		TArray<FIntraEdge> IntraEdges;
+	};
+
+	/** Border nodes of tile, indexed by ECBGridDirection of the border. */
+	struct FCluster
+	{
+		TArray<int32> BorderNodeIndices[BordersNum];
+	};
+
+	void RemoveBorderNodes(FIntPoint const TileCoord, int32 const BorderIndex);
+	void BuildBorderNodes(FIntPoint const TileCoord, int32 const BorderIndex);
+	void BuildIntraEdges(FIntPoint const TileCoord) const;
+
+	/** Marks intra edges of the tile and of neighbours across given borders dirty. */
+	void MarkIntraEdgesDirty(FIntPoint const TileCoord, uint32 const BordersMask);
+	FIntRect GetTileGridRect(FIntPoint const TileCoord) const;
+
+	/** Finds abstract path as list of cells, consecutive cells of which are either adjacent or in the same tile. */
+	ECBNavGridAStarResult FindAbstractPath(FIntPoint const StartGridCoord, FIntPoint const EndGridCoord, FCBNavGridAStarFilter const & Filter, TArray<FIntPoint> * const OutAbstractPath, int32 & OutVisitedNodesNum) const;
+
+	ACBNavGrid const & NavGrid;
+
+	/** Intra edges are rebuilt by queries under write lock, so nodes are mutable. */
+	mutable TSparseArray<FNode> Nodes;
+	TMap<FIntPoint, FCluster> Clusters;
+
+	/** Tiles which intra edges are stale, they may refer to removed nodes until rebuilt. */
+	mutable TSet<FIntPoint> DirtyClusters;
+	mutable FRWLock Lock;
+};
@@ -10,6 +10,9 @@ struct CBNAVGRID_API FCBNavGridCustomVersion
 	{
 		InitialVersion,
 
+		// Nav grid layers serialize area id of every cell.
+		CellAreas,
+
 		// -----<new versions can be added above this line>-------------------------------------------------
 		VersionPlusOne,
 		LatestVersion = VersionPlusOne - 1
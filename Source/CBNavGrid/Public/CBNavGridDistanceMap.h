@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CBNavGridLayer.h"
+#include "CoreMinimal.h"
+
+class ACBNavGrid;
+
+/**
+ * Walking distances in steps from set of source cells over free cells of bounded grid rect, limited to max distance.
+ * Distances are stored per tile as uint16 in column-major cell order like FCBNavGridLayer, covered cells are also kept
+ * as bit words laid out like FCBNavGridLayer occupancy words. Map is updated incrementally: added source relaxes
+ * distances around itself, removed source and changed tile reset only cells whose shortest paths may go through them
+ * and refill those cells from the rest of the map.
+ */
+class CBNAVGRID_API FCBNavGridDistanceMap
+{
+public:
+	using WordType = FCBNavGridLayer::WordType;
+
+	static constexpr uint16 UnreachedDistance = MAX_uint16;
+
+	/** Max distance is clamped to be less than UnreachedDistance. */
+	FCBNavGridDistanceMap(ACBNavGrid const & InNavGrid, FIntRect const & InGridRect, uint16 const InMaxDistance);
+
+	/** Sources are kept even if their cells are occupied or out of rect, so they come back once the cell is freed. */
+	void AddSource(FIntPoint const GridCoord);
+	void RemoveSource(FIntPoint const GridCoord);
+	TConstArrayView<FIntPoint> GetSources() const;
+
+	/** Updates distances affected by the tile, is expected to be called after the tile is regenerated or removed. */
+	void OnTileChanged(FIntPoint const TileCoord);
+
+	/** Recomputes all distances from scratch. */
+	void Rebuild();
+
+	/** Returns UnreachedDistance for cells farther than max distance from all sources. */
+	uint16 GetDistance(FIntPoint const GridCoord) const;
+	bool IsCellCovered(FIntPoint const GridCoord) const;
+
+	/**
+	 * Returns coverage word of cells column GridCoord.X containing cell GridCoord, bits match bits of
+	 * FCBNavGridLayer::GetOccupancyWord. Bit is set if cell is within max distance from any source.
+	 */
+	WordType GetCoverageWord(FIntPoint const GridCoord) const;
+
+	FIntRect const & GetGridRect() const;
+	uint16 GetMaxDistance() const;
+
+private:
+	struct FTileDistances
+	{
+		TArray<uint16> Distances;
+		TArray<WordType> CoverageWords;
+
+		/** Cell is collected by the running CollectDependentCells if its stamp equals CollectStamp, allocated on demand. */
+		TArray<uint32> CollectStamps;
+	};
+
+	struct FOpenCell
+	{
+		FIntPoint GridCoord;
+		uint16 Distance;
+	};
+
+	bool IsCellFree(FIntPoint const GridCoord) const;
+	void SetDistance(FIntPoint const GridCoord, uint16 const Distance);
+
+	/** Relaxes distances outward from seeds, which must already have their distances set. */
+	void Propagate(TArray<FOpenCell> & Seeds);
+
+	/** Collects reached cells whose shortest paths may go through root cells, roots included, each cell once. */
+	void CollectDependentCells(TConstArrayView<FIntPoint> const RootGridCoords, TArray<FIntPoint> & OutGridCoords);
+
+	/** Returns false if cell isn't reached or is already collected. */
+	bool MarkCollected(FIntPoint const GridCoord);
+
+	/** Resets distances of distinct cells and refills them from the neighbouring reached cells and from sources among them. */
+	void Repair(TConstArrayView<FIntPoint> const ResetGridCoords);
+
+	ACBNavGrid const & NavGrid;
+	TMap<FIntPoint, FTileDistances> Tiles;
+	TArray<FIntPoint> Sources;
+	FIntRect GridRect;
+	FIntPoint TileSize;
+	uint16 MaxDistance;
+	uint32 CollectStamp = 0;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ACBNavGrid;
+
+/**
+ * Integration field (steps to goal) and direction field (next step towards goal) over bounded rect of grid cells.
+ * Fields are built once per goal by breadth-first search over free cells, so many agents heading to the same goal
+ * share one search. Fields are stored per tile in column-major cell order like FCBNavGridLayer, tiles are indexed by
+ * dense table over covered tile rect, so sampling a cell costs two array accesses. Costs take 2 bytes per cell, cells
+ * farther than MaxCost steps from goal are unreachable. Field doesn't track tile changes, ACBNavGrid drops cached
+ * fields covering changed tiles.
+ */
+class CBNAVGRID_API FCBNavGridFlowField
+{
+public:
+	static constexpr uint16 UnreachableCost = MAX_uint16;
+	static constexpr uint16 MaxCost = UnreachableCost - 1;
+
+	/** Builds fields over free cells of GridRect, which must contain goal cell. Steps to adjacent cells cost 1. */
+	FCBNavGridFlowField(ACBNavGrid const & NavGrid, FIntPoint const InGoalGridCoord, FIntRect const & InGridRect);
+
+	FIntPoint GetGoalGridCoord() const;
+	FIntRect const & GetGridRect() const;
+
+	/** Returns UnreachableCost for cells which can't reach goal within grid rect. */
+	uint16 GetCost(FIntPoint const GridCoord) const;
+
+	/** Returns false for goal and for cells which can't reach goal within grid rect. */
+	bool GetNextGridCoord(FIntPoint const GridCoord, FIntPoint & OutNextGridCoord) const;
+
+	/** Returns unit vector of next step towards goal, zero vector if there is no next step. */
+	FVector2d GetFlowDirection(FIntPoint const GridCoord) const;
+
+	bool IsTileCovered(FIntPoint const TileCoord) const;
+
+private:
+	/** Arrays are empty if no cell of the tile is reached. */
+	struct FTileField
+	{
+		TArray<uint16> Costs;
+
+		/** ECBGridDirection of next step of every cell. */
+		TArray<uint8> NextDirections;
+	};
+
+	/** Returns nullptr if cell isn't covered by any tile field. */
+	FTileField const * FindTileField(FIntPoint const GridCoord, int32 & OutCellIndex) const;
+
+	FORCEINLINE int32 GetTileFieldIndex(FIntPoint const TileCoord) const;
+
+	/** Field of every tile of TileRect, column-major. */
+	TArray<FTileField> TileFields;
+	FIntPoint GoalGridCoord;
+	FIntRect GridRect;
+	FIntRect TileRect;
+	FIntPoint TileSize;
+};
+
+int32 FCBNavGridFlowField::GetTileFieldIndex(FIntPoint const TileCoord) const
+{
+	FIntPoint const TableCoord = TileCoord - TileRect.Min;
+	return TableCoord.X * TileRect.Height() + TableCoord.Y;
+}
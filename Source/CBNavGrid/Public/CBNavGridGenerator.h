@@ -17,6 +17,14 @@ struct CBNAVGRID_API FCBNavGridBuildConfig
 	float MaxNavigableCellHeightsDifference;
 	float MinZ;
 	float MaxZ;
+	bool bBuildOccupiedCellsSums;
+
+	/** Clearances are built if greater than 0, see FCBNavGridLayer::UpdateClearances. */
+	uint8 MaxClearance;
+
+	/** Nav data area ids of supported nav area classes, nav area modifiers of other classes are ignored. */
+	TMap<UClass const *, uint8> AreaClassToIdMap;
+	uint8 DefaultAreaId;
 };
 
 /** Contains data about dirty area relevant for FCBNavGridTileGenerator. */
@@ -71,6 +79,9 @@ protected:
 	virtual void ConfigureBuildProperties(FCBNavGridBuildConfig & OutConfig);
 	void RebuildDirtyAreas(TArray<FCBNavigationDirtyArea> const & DirtyAreas);
 
+	/** Caches area ids of nav area classes, since tile generators can't query nav grid for them off game thread. */
+	void UpdateAreaIds(FCBNavGridBuildConfig & OutConfig) const;
+
 	/** Updates cached list of navigation bounds. */
 	void UpdateNavigationBounds();
 
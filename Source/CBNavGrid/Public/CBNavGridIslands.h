@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ACBNavGrid;
+class FCBNavGridLayer;
+
+/**
+ * Global connectivity index of nav grid. Connected components labeled inside tiles are merged across tile borders with
+ * union-find, so telling whether two cells are connected doesn't require search. Index keeps tile layers it was built
+ * from, so lookups stay consistent while tiles are being replaced. Changed tiles are dropped from the index until the
+ * next rebuild, together with islands which may be merged through them, so lookups stay conservative meanwhile.
+ * Index is changed on game thread only, queries may run on any thread.
+ */
+class CBNAVGRID_API FCBNavGridIslands
+{
+public:
+	explicit FCBNavGridIslands(ACBNavGrid const & InNavGrid);
+
+	/** Rebuilds index for all tiles of nav grid, relies on tile layers having up to date component labels. */
+	void Rebuild();
+	void Reset();
+
+	/** Drops tile and invalidates islands of its components and of neighbouring components touching its borders. */
+	void OnTileChanged(FIntPoint const TileCoord);
+
+	/** Returns INDEX_NONE if cell is occupied, its tile isn't indexed or its island is invalidated. */
+	int32 GetIslandId(FIntPoint const GridCoord) const;
+
+	/** Returns true only if both cells are free and known to be disconnected. */
+	bool AreInDifferentIslands(FIntPoint const GridCoord1, FIntPoint const GridCoord2) const;
+
+private:
+	struct FTileIslands
+	{
+		TSharedPtr<FCBNavGridLayer const> NavigationData;
+
+		/** Index of the first tile component in ComponentIslands. */
+		int32 ComponentsOffset;
+	};
+
+	/** Expects Lock to be held. */
+	int32 GetIslandIdUnsafe(FIntPoint const GridCoord) const;
+
+	ACBNavGrid const & NavGrid;
+	TMap<FIntPoint, FTileIslands> Tiles;
+
+	/** Island id of every component of every tile. */
+	TArray<int32> ComponentIslands;
+
+	/** Islands invalidated since the last rebuild, indexed by island id. */
+	TBitArray<> InvalidIslands;
+	mutable FRWLock Lock;
+};
@@ -8,19 +8,44 @@
 class CBNAVGRID_API FCBNavGridLayer : protected FCBBitGridLayer
 {
 public:
+	using FCBBitGridLayer::WordType;
+	using FCBBitGridLayer::BitsPerWordNum;
+	using FCBBitGridLayer::FullWordMask;
+
+	/** Blocking planes are selected by bits of uint32 mask. */
+	static constexpr int32 MaxBlockingPlanesNum = 32;
+
+	/** Min clearance no cell has, requested for agents too big for max clearance, so all cells are occupied for them. */
+	static constexpr uint8 NoFitClearance = MAX_uint8;
+
 	FCBNavGridLayer();
-	explicit FCBNavGridLayer(FIntRect const & InGridRect, float const InGridCellSize, bool const bIsOccupied = false, float const InitHeights = std::numeric_limits<float>::quiet_NaN());
+	explicit FCBNavGridLayer(FIntRect const & InGridRect, float const InGridCellSize, bool const bIsOccupied = false, float const InitHeights = std::numeric_limits<float>::quiet_NaN(), uint8 const InitAreaId = 0);
 
 	void Serialize(FArchive & Archive);
-	bool IsCellOccupied(FIntPoint const Coord) const;
+
+	/**
+	 * Cells set in blocking planes selected by BlockingPlanesMask are also reported as occupied, as well as cells with
+	 * clearance less than MinClearance if clearances are built. All cells are occupied for NoFitClearance.
+	 */
+	bool IsCellOccupied(FIntPoint const Coord, uint32 const BlockingPlanesMask = 0, uint8 const MinClearance = 0) const;
 	FORCEINLINE bool IsCellOccupied(int32 const X, int32 const Y) const;
 	bool SetCellState(FIntPoint const Coord, bool const bIsOccupied);
 	FORCEINLINE bool SetCellState(int32 const X, int32 const Y, bool const bIsOccupied);
+
+	/**
+	 * Returns occupancy word of cells column Coord.X containing cell Coord, bit I of the word is cell with Y equal to
+	 * Origin.Y + BitsPerWordNum * K + I. Cells out of grid are reported as occupied.
+	 */
+	WordType GetOccupancyWord(FIntPoint const Coord, uint32 const BlockingPlanesMask = 0, uint8 const MinClearance = 0) const;
 	float GetCellHeight(FIntPoint const Coord) const;
 	FORCEINLINE float GetCellHeight(int32 const X, int32 const Y) const;
 	void SetCellHeight(FIntPoint const Coord, float const Height);
 	FORCEINLINE void SetCellHeight(int32 const X, int32 const Y, float const Height);
 
+	/** Area id of cell is nav data area id of nav area class covering the cell, cells out of grid have area id 0. */
+	uint8 GetCellArea(FIntPoint const Coord) const;
+	void SetCellArea(FIntPoint const Coord, uint8 const AreaId);
+
 	float GetCellSize() const;
 	FIntPoint GetGridSize() const;
 	FIntRect GetGridRect() const;
@@ -31,6 +56,31 @@ public:
 	/** Checks if specified rectangle is containing occupied cell. */
 	bool HasOccupiedCell(FIntRect const & Rect) const;
 
+	/**
+	 * Take constant time, since bit layers keep summaries of their 16 x 32 cells tiles up to date, so queries may skip
+	 * or accept whole layer. Clearances aren't summarized, so min clearance greater than 1 makes AreAllCellsFree false
+	 * if clearances are built. AreAllCellsOccupied checks generated occupancy and overlay, so it holds for any query.
+	 */
+	bool AreAllCellsFree(uint32 const BlockingPlanesMask = 0, uint8 const MinClearance = 0) const;
+	bool AreAllCellsOccupied() const;
+
+	/**
+	 * Counts occupied cells in specified rectangle clipped with grid. If occupied cells sums are built, generated
+	 * occupancy takes constant time and only overlay tiles with set cells are counted by words, otherwise counts bits
+	 * of occupancy words.
+	 */
+	int32 CountOccupiedCells(FIntRect const & Rect) const;
+
+	/**
+	 * Scans cells of column X from FromY to ToY inclusive, in either direction, testing whole occupancy words at once.
+	 * Both ends are expected to be in grid. Returns true and Y of the first occupied cell met if there is one.
+	 */
+	bool FindOccupiedCellInColumn(int32 const X, int32 const FromY, int32 const ToY, int32 & OutY, uint32 const BlockingPlanesMask = 0, uint8 const MinClearance = 0) const;
+
+	/** Calls Visitor with Y of every free cell of column X in [MinY, MaxY] clipped with grid, words are bit scanned. */
+	template <typename TVisitor>
+	void ForEachFreeCellInColumn(int32 const X, int32 const MinY, int32 const MaxY, TVisitor && Visitor, uint32 const BlockingPlanesMask = 0, uint8 const MinClearance = 0) const;
+
 	/** Sets cells state in specified rectangle. */
 	void SetCellsState(FIntRect const & Rect, bool const bIsOccupied);
 
@@ -38,6 +88,88 @@ public:
 	void SetCellsStateInCircle(FVector2d const CircleOrigin, double const Radius, bool const bIsOccupied);
 	void SetCellsStateInConvex(TArray<FVector2d> const & CCWConvex, bool const bIsOccupied);
 
+	/** Sets area id of cells in specified shapes, cells are covered by shapes the same way as with SetCellsState. */
+	void SetCellsArea(FIntRect const & Rect, uint8 const AreaId);
+	void SetCellsAreaInBox(FBox2d const & Box, uint8 const AreaId);
+	void SetCellsAreaInCircle(FVector2d const CircleOrigin, double const Radius, uint8 const AreaId);
+	void SetCellsAreaInConvex(TArray<FVector2d> const & CCWConvex, uint8 const AreaId);
+
+	/**
+	 * Overlay occupancy is stamped by gameplay on top of generated occupancy, cell is occupied if it is occupied in
+	 * either of them. If PlaneIndex isn't INDEX_NONE, cells are stamped into that blocking plane instead, which blocks
+	 * only queries selecting it in their mask. Stamps change only words they cover. Overlay isn't serialized.
+	 */
+	void SetOverlayCellsState(FIntRect const & Rect, bool const bIsOccupied, int32 const PlaneIndex = INDEX_NONE);
+	void SetOverlayCellsStateInBox(FBox2d const & Box, bool const bIsOccupied, int32 const PlaneIndex = INDEX_NONE);
+	void SetOverlayCellsStateInCircle(FVector2d const CircleOrigin, double const Radius, bool const bIsOccupied, int32 const PlaneIndex = INDEX_NONE);
+	void SetOverlayCellsStateInConvex(TArray<FVector2d> const & CCWConvex, bool const bIsOccupied, int32 const PlaneIndex = INDEX_NONE);
+
+	/** Checks overlay and blocking planes. */
+	bool HasOverlayCells() const;
+
+	/** Clears overlay and blocking planes, planes number is kept. */
+	void ClearOverlay();
+
+	/** Copies overlay and blocking planes of layer with the same grid rect. */
+	void CopyOverlay(FCBNavGridLayer const & Src);
+
+	/** Added planes are empty. */
+	void SetBlockingPlanesNum(int32 const BlockingPlanesNum);
+	int32 GetBlockingPlanesNum() const;
+
+	/**
+	 * Labels connected components of free cells of generated occupancy, overlay is ignored, so labels stay valid for
+	 * connectivity checks when overlay blocks cells. Labels take 2 bytes per cell, free cells of components past the
+	 * label limit are left unlabeled. Labels aren't serialized, they are recalculated on load and must be updated
+	 * explicitly after generated cells state is changed.
+	 */
+	void UpdateComponentLabels();
+
+	/** Returns INDEX_NONE for cells occupied in generated occupancy, unlabeled cells and cells out of grid. */
+	int32 GetComponentLabel(FIntPoint const Coord) const;
+	int32 GetComponentsNum() const;
+
+	/**
+	 * Clearance of free cell is 3-4 chamfer distance in cells from its center to center of the nearest cell occupied in
+	 * generated occupancy or overlay, capped by InMaxClearance. Occupied cells have clearance 0 and free cells at least 1, so agent
+	 * fits cell if its clearance isn't less than agent radius in cells plus half of cell. Cells of NeighbourLayers
+	 * closer than InMaxClearance to the rect are taken into account, cells of missing layers are treated as occupied.
+	 * Only clearances of cells in Rect are updated, unless clearances aren't built for InMaxClearance yet. Blocking
+	 * planes are ignored. Clearances aren't serialized.
+	 */
+	void UpdateClearances(FIntRect const & Rect, TConstArrayView<FCBNavGridLayer const *> const NeighbourLayers, uint8 const InMaxClearance);
+	void EmptyClearances();
+	bool HasClearances() const;
+	uint8 GetMaxClearance() const;
+
+	/** Returns 0 for cells out of grid and if clearances aren't built. */
+	uint8 GetCellClearance(FIntPoint const Coord) const;
+
+	/**
+	 * Counts free cells per occupancy word for uniform free cell sampling. Counts aren't serialized, they are
+	 * recalculated on load and must be updated explicitly after cells state is changed. Rect overload recounts only
+	 * words overlapping the rect, e.g. after overlay stamp, and takes logarithmic time per changed word.
+	 */
+	void UpdateFreeCellCounts();
+	void UpdateFreeCellCounts(FIntRect const & Rect);
+	int32 GetFreeCellsNum() const;
+
+	/**
+	 * Returns coord of free cell with specified index in column-major order, index must be less than GetFreeCellsNum.
+	 * Takes logarithmic time.
+	 */
+	FIntPoint GetFreeCell(int32 const FreeCellIndex) const;
+
+	/**
+	 * Builds optional summed-area table of cells occupied in generated occupancy used by CountOccupiedCells, costs 2
+	 * bytes per cell. Sums are kept modulo 2^16, which is exact for rects of up to 65535 cells, larger rects are counted
+	 * by words. Overlay isn't summed, so stamps keep the table valid. Table isn't serialized, it must be updated or
+	 * emptied explicitly after generated cells state is changed.
+	 */
+	void UpdateOccupiedCellsSums();
+	void EmptyOccupiedCellsSums();
+	bool HasOccupiedCellsSums() const;
+
 	static void Copy(FCBNavGridLayer & Dst, FCBNavGridLayer const & Src, FIntRect const & Rect);
 	static void Copy(FCBNavGridLayer & Dst, FCBNavGridLayer const & Src);
 
@@ -48,9 +180,41 @@ protected:
 	FUintPoint GetUnsignedCoordUnsafe(FIntPoint const SignedCoord) const;
 	FUintRect GetUnsignedRectUnsafe(FIntRect const & SignedRect) const;
 
+	/**
+	 * Returns generated occupancy word combined with overlay word, words of selected blocking planes and bits of cells
+	 * with clearance less than MinClearance. Returns full word for NoFitClearance.
+	 */
+	WordType GetCombinedWord(FUintPoint const Coord, uint32 const BlockingPlanesMask = 0, uint8 const MinClearance = 0) const;
+	FCBBitGridLayer & GetOverlayTarget(int32 const PlaneIndex);
+
+	/** Stamps shapes into either generated occupancy or overlay. */
+	void StampRect(FCBBitGridLayer & Target, FIntRect const & Rect, bool const bIsOccupied);
+	void StampCircle(FCBBitGridLayer & Target, FVector2d const CircleOrigin, double const Radius, bool const bIsOccupied);
+	void StampConvex(FCBBitGridLayer & Target, TArray<FVector2d> const & CCWConvex, bool const bIsOccupied);
+
+	/** Gameplay occupancy of the same size as generated occupancy. */
+	FCBBitGridLayer Overlay;
+	TArray<FCBBitGridLayer> BlockingPlanes;
 	TArray<float> CellHeights;
+
+	/** Area id per cell in the same order as CellHeights. */
+	TArray<uint8> CellAreas;
+	TArray<uint8> CellClearances;
+	TArray<uint16> ComponentLabels;
+
+	/** Number of free cells per occupancy word in column-major order. */
+	TArray<uint8> WordFreeCellsNums;
+
+	/** Fenwick tree over WordFreeCellsNums, element I is number of free cells in words I + 1 - LowBit(I + 1) to I. */
+	TArray<int32> FreeCellsTree;
+	int32 FreeCellsNum;
+
+	/** Summed-area table of (XSize + 1) x (YSize + 1) elements, element (X, Y) is number of cells occupied in generated occupancy with local coords less than (X, Y). */
+	TArray<uint16> OccupiedCellsSums;
 	FIntPoint Origin;
 	float CellSize;
+	int32 ComponentsNum;
+	uint8 MaxClearance;
 };
 
 FORCEINLINE FArchive & operator <<(FArchive & Archive, FCBNavGridLayer & NavGridLayer)
@@ -83,3 +247,37 @@ bool FCBNavGridLayer::IsInGrid(int32 const X, int32 const Y) const
 {
 	return IsInGrid(FIntPoint{ X, Y });
 }
+
+template <typename TVisitor>
+void FCBNavGridLayer::ForEachFreeCellInColumn(int32 const X, int32 const MinY, int32 const MaxY, TVisitor && Visitor, uint32 const BlockingPlanesMask, uint8 const MinClearance) const
+{
+	constexpr int32 SignedBitsPerWordNum = static_cast<int32>(BitsPerWordNum);
+	FIntRect const GridRect = GetGridRect();
+	int32 const LocalMinY = FMath::Max(MinY, GridRect.Min.Y) - Origin.Y;
+	int32 const LocalMaxY = FMath::Min(MaxY, GridRect.Max.Y - 1) - Origin.Y;
+	if (X < GridRect.Min.X || X >= GridRect.Max.X || LocalMinY > LocalMaxY || AreAllCellsOccupied())
+	{
+		return;
+	}
+
+	uint32 const LocalX = static_cast<uint32>(X - Origin.X);
+	for (int32 WordMinY = LocalMinY & ~(SignedBitsPerWordNum - 1); WordMinY <= LocalMaxY; WordMinY += SignedBitsPerWordNum)
+	{
+		WordType FreeCells = ~GetCombinedWord(FUintPoint{ LocalX, static_cast<uint32>(WordMinY) }, BlockingPlanesMask, MinClearance);
+		if (LocalMinY > WordMinY)
+		{
+			FreeCells &= FullWordMask << (LocalMinY - WordMinY);
+		}
+		if (LocalMaxY < WordMinY + SignedBitsPerWordNum - 1)
+		{
+			FreeCells &= FullWordMask >> (WordMinY + SignedBitsPerWordNum - 1 - LocalMaxY);
+		}
+
+		while (FreeCells != 0)
+		{
+			int32 const Bit = static_cast<int32>(FMath::CountTrailingZeros(FreeCells));
+			FreeCells &= FreeCells - 1;
+			Visitor(Origin.Y + WordMinY + Bit);
+		}
+	}
+}
@@ -13,6 +13,8 @@ public:
 
 	FORCEINLINE void SetWantsStringPulling(bool const bNewWantsStringPulling);
 	FORCEINLINE bool WantsStringPulling() const;
+	FORCEINLINE void SetWantsAnyAngle(bool const bNewWantsAnyAngle);
+	FORCEINLINE bool WantsAnyAngle() const;
 	FORCEINLINE FIntRect const & GetGridBoundingBox() const;
 	FORCEINLINE FIntRect & GetGridBoundingBox();
 	void ApplyFlags(int32 const NavDataFlags);
@@ -29,6 +31,9 @@ protected:
 
 	/** If set to true path instance will contain a string pulled version. Defaults to true. */
 	uint8 bWantsStringPulling : 1;
+
+	/** If set to true path is searched by any-angle search and is not string pulled. Defaults to false. */
+	uint8 bWantsAnyAngle : 1;
 };
 
 void FCBNavGridPath::SetWantsStringPulling(bool const bNewWantsStringPulling)
@@ -41,6 +46,16 @@ bool FCBNavGridPath::WantsStringPulling() const
 	return bWantsStringPulling;
 }
 
+void FCBNavGridPath::SetWantsAnyAngle(bool const bNewWantsAnyAngle)
+{
+	bWantsAnyAngle = bNewWantsAnyAngle;
+}
+
+bool FCBNavGridPath::WantsAnyAngle() const
+{
+	return bWantsAnyAngle;
+}
+
 FIntRect const & FCBNavGridPath::GetGridBoundingBox() const
 {
 	return GridBoundingBox;
@@ -1,16 +1,57 @@
 #pragma once 
 
 #include "AI/Navigation/NavQueryFilter.h"
+#include "Containers/StaticArray.h"
 #include "CoreMinimal.h"
 
 class CBNAVGRID_API FCBNavGridQueryFilter : public INavigationQueryFilterInterface
 {
 public:
-	explicit FCBNavGridQueryFilter(float const InHeuristicScale = 1.f, FVector2f const InAxiswiseHeuristicScale = FVector2f{ 1.f, 1.f });
+	/** Cell area ids are uint8, so area cost tables cover every possible id. */
+	static constexpr int32 AreasNum = 256;
+
+	explicit FCBNavGridQueryFilter(float const InHeuristicScale = 1.f, FVector2f const InAxiswiseHeuristicScale = FVector2f{ 1.f, 1.f }, bool const bInUseFixedPointCosts = false, bool const bInUseJumpPointSearch = false, uint32 const InBlockingPlanesMask = 0, float const InAgentRadius = 0.f);
 	FORCEINLINE void SetHeuristicScale(float const InHeuristicScale);
 	FORCEINLINE FVector2f GetAxiswiseHeuristicScale() const;
 	FORCEINLINE void SetAxiswiseHeuristicScale(FVector2f const InAxiswiseHeuristicScale);
 
+	/**
+	 * Fixed point costs let search use radix heap open list with O(1) amortized push and pop. Costs are rounded
+	 * to 1/65536, so ties between very close costs may be broken differently than with floating point costs.
+	 */
+	FORCEINLINE bool UsesFixedPointCosts() const;
+	FORCEINLINE void SetUseFixedPointCosts(bool const bInUseFixedPointCosts);
+
+	/** Jump point search adds to open list only cells where path may turn, instead of every cell it passes. */
+	FORCEINLINE bool UsesJumpPointSearch() const;
+	FORCEINLINE void SetUseJumpPointSearch(bool const bInUseJumpPointSearch);
+
+	/**
+	 * Bit I makes cells of nav grid blocking plane I occupied for search, raycast and projection queries using the
+	 * filter, see ACBNavGrid::GetBlockingPlanesMask.
+	 */
+	FORCEINLINE uint32 GetBlockingPlanesMask() const;
+	FORCEINLINE void SetBlockingPlanesMask(uint32 const InBlockingPlanesMask);
+
+	/**
+	 * Queries using the filter treat cells without clearance for agent of the radius as occupied, if nav grid builds
+	 * clearances. Filters with agent radius skip hierarchical search.
+	 */
+	FORCEINLINE float GetAgentRadius() const;
+	FORCEINLINE void SetAgentRadius(float const InAgentRadius);
+
+	/**
+	 * Step into cell costs area cost of the cell plus its area entering cost if area of the cell differs from area of
+	 * previous cell. Excluded areas have max float cost. Filters with all area costs of 1 and no entering costs don't
+	 * have area costs and keep jump point, any-angle and hierarchical searches.
+	 */
+	FORCEINLINE bool HasAreaCosts() const;
+	FORCEINLINE TConstArrayView<float> GetAreaCosts() const;
+	FORCEINLINE TConstArrayView<float> GetAreaEnteringCosts() const;
+
+	/** Min cost of not excluded areas, scales heuristic so that it stays admissible. */
+	FORCEINLINE float GetMinAreaCost() const;
+
 	virtual void Reset() override;
 	virtual void SetAreaCost(uint8 const AreaType, float const Cost) override;
 	virtual void SetFixedAreaEnteringCost(uint8 const AreaType, float const Cost) override;
@@ -29,8 +70,18 @@ public:
 	virtual INavigationQueryFilterInterface * CreateCopy() const override;
 
 private:
+	void UpdateAreaCostsState();
+
+	TStaticArray<float, AreasNum> AreaCosts;
+	TStaticArray<float, AreasNum> AreaEnteringCosts;
+	float MinAreaCost;
 	float HeuristicScale;
 	FVector2f AxiswiseHeuristicScale;
+	uint32 BlockingPlanesMask;
+	float AgentRadius;
+	uint8 bUseFixedPointCosts : 1;
+	uint8 bUseJumpPointSearch : 1;
+	uint8 bHasAreaCosts : 1;
 };
 
 void FCBNavGridQueryFilter::SetHeuristicScale(float const InHeuristicScale)
@@ -47,3 +98,63 @@ void FCBNavGridQueryFilter::SetAxiswiseHeuristicScale(FVector2f const InAxiswise
 {
 	AxiswiseHeuristicScale = InAxiswiseHeuristicScale;
 }
+
+bool FCBNavGridQueryFilter::UsesFixedPointCosts() const
+{
+	return bUseFixedPointCosts;
+}
+
+void FCBNavGridQueryFilter::SetUseFixedPointCosts(bool const bInUseFixedPointCosts)
+{
+	bUseFixedPointCosts = bInUseFixedPointCosts;
+}
+
+bool FCBNavGridQueryFilter::UsesJumpPointSearch() const
+{
+	return bUseJumpPointSearch;
+}
+
+void FCBNavGridQueryFilter::SetUseJumpPointSearch(bool const bInUseJumpPointSearch)
+{
+	bUseJumpPointSearch = bInUseJumpPointSearch;
+}
+
+uint32 FCBNavGridQueryFilter::GetBlockingPlanesMask() const
+{
+	return BlockingPlanesMask;
+}
+
+void FCBNavGridQueryFilter::SetBlockingPlanesMask(uint32 const InBlockingPlanesMask)
+{
+	BlockingPlanesMask = InBlockingPlanesMask;
+}
+
+float FCBNavGridQueryFilter::GetAgentRadius() const
+{
+	return AgentRadius;
+}
+
+void FCBNavGridQueryFilter::SetAgentRadius(float const InAgentRadius)
+{
+	AgentRadius = InAgentRadius;
+}
+
+bool FCBNavGridQueryFilter::HasAreaCosts() const
+{
+	return bHasAreaCosts;
+}
+
+TConstArrayView<float> FCBNavGridQueryFilter::GetAreaCosts() const
+{
+	return MakeArrayView(AreaCosts.GetData(), AreasNum);
+}
+
+TConstArrayView<float> FCBNavGridQueryFilter::GetAreaEnteringCosts() const
+{
+	return MakeArrayView(AreaEnteringCosts.GetData(), AreasNum);
+}
+
+float FCBNavGridQueryFilter::GetMinAreaCost() const
+{
+	return MinAreaCost;
+}
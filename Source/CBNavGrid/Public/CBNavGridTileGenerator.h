@@ -74,6 +74,9 @@ private:
 	TUniquePtr<FCBHeightfield> GeneratedHeightfield;
 	TSharedPtr<FCBHeightfield const> PreviousHeightfield;
 
+	/** Snapshot of tiles within max clearance from the tile, their occupancy affects clearances of tile cells. */
+	TArray<TSharedPtr<FCBNavGridLayer const>> NeighbourNavigationData;
+
 	FCBNavGridGenerator const & ParentGenerator;
 	FIntPoint const TileCoord;
 	TArray<FCBPreparedNavigationRelevantData> PreparedNavigationRelevantData;